@@ -1,6 +1,6 @@
 QT += core widgets network
 
-CONFIG += c++11
+CONFIG += c++17
 win32:CONFIG += console
 
 TARGET = TelemetryReceiver
@@ -12,14 +12,51 @@ SOURCES += \
     main.cpp \
     mainwindow.cpp \
     radarwidget.cpp \
+    trackstore.cpp \
+    spatialgrid.cpp \
+    phosphorlayer.cpp \
+    scanconverter.cpp \
+    cfardetector.cpp \
+    plotextractor.cpp \
+    geodesy.cpp \
+    radarrenderer.cpp \
+    framemetrics.cpp \
+    labelplacer.cpp \
+    qualitygovernor.cpp \
+    radarrenderworker.cpp \
     telemetryreceiversocket.cpp \
-    reliableudp.cpp
+    reliableudp.cpp \
+    networkstatistics.cpp \
+    asynclogger.cpp \
+    jitterbuffer.cpp
 
 HEADERS += \
     mainwindow.h \
     radarwidget.h \
+    trackstore.h \
+    spatialgrid.h \
+    phosphorlayer.h \
+    scanconverter.h \
+    cfardetector.h \
+    plotextractor.h \
+    radarplot.h \
+    cpufeatures.h \
+    radarmath.h \
+    geodesy.h \
+    radarscene.h \
+    framemetrics.h \
+    labelplacer.h \
+    qualitygovernor.h \
+    radarrenderer.h \
+    radarrenderworker.h \
     telemetryreceiversocket.h \
-    reliableudp.h
+    telemetrydata.h \
+    reliableudp.h \
+    networkstatistics.h \
+    asynclogger.h \
+    mpscqueue.h \
+    telemetrypacket.h \
+    jitterbuffer.h
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,216 @@
+#include "asynclogger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace {
+// Retires the thread's ring when the thread exits, so the drain thread can
+// free it once everything written to it is out
+struct RingOwner {
+    LogRing *ring = nullptr;
+    ~RingOwner()
+    {
+        if (ring) {
+            ring->retire();
+        }
+    }
+};
+}
+
+std::atomic<int> AsyncLogger::s_level(int(LogLevel::Info));
+
+AsyncLogger &AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : m_nextThreadIndex(0)
+    , m_dropped(0)
+    , m_reportedDrops(0)
+    , m_running(true)
+    , m_output(stdout)
+    , m_startNs(nowNs())
+{
+    // TELEMETRY_LOG_LEVEL=trace|debug|info|warning|error|off
+    setLevel(levelFromName(std::getenv("TELEMETRY_LOG_LEVEL"), level()));
+
+    m_drainThread = std::thread(&AsyncLogger::drainLoop, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    shutdown();
+}
+
+LogLevel AsyncLogger::levelFromName(const char *name, LogLevel fallback)
+{
+    if (!name || !*name) {
+        return fallback;
+    }
+
+    static const struct { const char *name; LogLevel level; } levels[] = {
+        {"trace", LogLevel::Trace},
+        {"debug", LogLevel::Debug},
+        {"info", LogLevel::Info},
+        {"warning", LogLevel::Warning},
+        {"error", LogLevel::Error},
+        {"off", LogLevel::Off},
+    };
+
+    for (const auto &entry : levels) {
+        if (std::strcmp(name, entry.name) == 0) {
+            return entry.level;
+        }
+    }
+    return fallback;
+}
+
+void AsyncLogger::setOutput(FILE *output)
+{
+    // Takes effect from the next drain pass
+    m_output.store(output ? output : stdout, std::memory_order_release);
+}
+
+void AsyncLogger::shutdown()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(m_wakeLock);
+        m_wake.notify_all();
+    }
+    if (m_drainThread.joinable()) {
+        m_drainThread.join();
+    }
+
+    // Pick up anything logged while the drain thread was exiting
+    drainOnce();
+}
+
+LogRing &AsyncLogger::threadRing()
+{
+    thread_local RingOwner owner;
+    if (!owner.ring) {
+        std::lock_guard<std::mutex> locker(m_ringsLock);
+        m_rings.push_back(std::make_unique<LogRing>(m_nextThreadIndex++));
+        owner.ring = m_rings.back().get();
+    }
+    return *owner.ring;
+}
+
+int AsyncLogger::ringCount() const
+{
+    std::lock_guard<std::mutex> locker(m_ringsLock);
+    return int(m_rings.size());
+}
+
+void AsyncLogger::drainLoop()
+{
+    while (m_running.load(std::memory_order_acquire)) {
+        if (!drainOnce()) {
+            // Producers never signal, so poll at a rate that keeps latency low
+            std::unique_lock<std::mutex> locker(m_wakeLock);
+            m_wake.wait_for(locker, std::chrono::milliseconds(5));
+        }
+    }
+}
+
+bool AsyncLogger::drainOnce()
+{
+    std::vector<LogRing *> rings;
+    {
+        std::lock_guard<std::mutex> locker(m_ringsLock);
+
+        // A retired ring gets no more records, so once empty it can go. The
+        // flag is read before the ring, which makes the last write visible;
+        // one still holding records is drained below and freed next pass.
+        m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                     [](const std::unique_ptr<LogRing> &ring) {
+                                         return ring->isRetired() && !ring->peek();
+                                     }),
+                      m_rings.end());
+
+        rings.reserve(m_rings.size());
+        for (const auto &ring : m_rings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    FILE *output = m_output.load(std::memory_order_acquire);
+    bool wroteAny = false;
+    for (LogRing *ring : rings) {
+        while (const LogRecord *record = ring->peek()) {
+            writeRecord(output, *record, ring->threadIndex());
+            ring->release();
+            wroteAny = true;
+        }
+    }
+
+    quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDrops) {
+        std::fprintf(output, "AsyncLogger: %llu records dropped (ring full)\n",
+                     static_cast<unsigned long long>(dropped - m_reportedDrops));
+        m_reportedDrops = dropped;
+        wroteAny = true;
+    }
+
+    if (wroteAny) {
+        std::fflush(output);
+    }
+    return wroteAny;
+}
+
+void AsyncLogger::writeRecord(FILE *output, const LogRecord &record, int threadIndex)
+{
+    static const char levelTags[] = {'T', 'D', 'I', 'W', 'E', '-'};
+
+    std::string line;
+    line.reserve(160);
+
+    char prefix[64];
+    double seconds = (record.timestampNs - m_startNs) / 1e9;
+    std::snprintf(prefix, sizeof(prefix), "[%12.6f] %c t%d %s: ", seconds,
+                  levelTags[int(record.site->level)], threadIndex, record.site->category);
+    line += prefix;
+
+    int argIndex = 0;
+    for (const char *p = record.format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && argIndex < record.argumentCount) {
+            const LogRecord::Argument &arg = record.arguments[argIndex++];
+            char value[32];
+            switch (arg.type) {
+            case LogRecord::Argument::Signed:
+                std::snprintf(value, sizeof(value), "%lld", static_cast<long long>(arg.i));
+                line += value;
+                break;
+            case LogRecord::Argument::Unsigned:
+                std::snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(arg.u));
+                line += value;
+                break;
+            case LogRecord::Argument::Double:
+                std::snprintf(value, sizeof(value), "%.6f", arg.d);
+                line += value;
+                break;
+            case LogRecord::Argument::Text:
+                line.append(record.text + arg.textOffset, arg.textLength);
+                break;
+            }
+            ++p;
+        } else {
+            line += *p;
+        }
+    }
+
+    if (record.suppressed > 0) {
+        char suffix[48];
+        std::snprintf(suffix, sizeof(suffix), " (%u similar suppressed)", record.suppressed);
+        line += suffix;
+    }
+    line += '\n';
+
+    std::fwrite(line.data(), 1, line.size(), output);
+}
\ No newline at end of file
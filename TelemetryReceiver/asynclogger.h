@@ -0,0 +1,274 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : int {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// Static description of one logging statement, shared by every call through it
+struct LogSite {
+    const char *category;
+    LogLevel level;
+    qint64 minIntervalNs;                  // 0 = no rate limiting
+    std::atomic<qint64> nextAllowedNs;
+    std::atomic<quint32> suppressed;
+
+    LogSite(const char *cat, LogLevel lvl, int minIntervalMs)
+        : category(cat), level(lvl), minIntervalNs(qint64(minIntervalMs) * 1000000)
+        , nextAllowedNs(0), suppressed(0) {}
+
+    // Returns false when the site is inside its rate-limit window
+    bool admit(qint64 nowNs, quint32 &suppressedOut)
+    {
+        if (minIntervalNs > 0) {
+            qint64 next = nextAllowedNs.load(std::memory_order_relaxed);
+            if (nowNs < next ||
+                !nextAllowedNs.compare_exchange_strong(next, nowNs + minIntervalNs, std::memory_order_relaxed)) {
+                suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        suppressedOut = suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// Fixed-size binary record; formatting happens on the drain thread
+struct LogRecord {
+    static constexpr int MaxArguments = 6;
+    static constexpr int TextCapacity = 64;
+
+    struct Argument {
+        enum Type : quint8 { Signed, Unsigned, Double, Text };
+        Type type;
+        quint8 textOffset;
+        quint8 textLength;
+        union {
+            qint64 i;
+            quint64 u;
+            double d;
+        };
+    };
+
+    qint64 timestampNs;
+    const LogSite *site;
+    const char *format;                    // String literal with {} placeholders
+    quint32 suppressed;                    // Calls dropped by the rate limiter before this one
+    quint8 argumentCount;
+    quint8 textUsed;
+    Argument arguments[MaxArguments];
+    char text[TextCapacity];               // Inline storage for string arguments
+};
+
+// Single-producer / single-consumer ring owned by one logging thread
+class LogRing
+{
+public:
+    static constexpr quint32 Capacity = 1024; // Power of two
+
+    explicit LogRing(int threadIndex) : m_threadIndex(threadIndex), m_retired(false), m_head(0), m_tail(0) {}
+
+    LogRecord *beginWrite()
+    {
+        quint32 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= Capacity) {
+            return nullptr;
+        }
+        return &m_records[head & (Capacity - 1)];
+    }
+
+    void commitWrite()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    const LogRecord *peek() const
+    {
+        quint32 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_records[tail & (Capacity - 1)];
+    }
+
+    void release()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    int threadIndex() const { return m_threadIndex; }
+
+    // Set by the owning thread as it exits; nothing is written after it
+    void retire() { m_retired.store(true, std::memory_order_release); }
+    bool isRetired() const { return m_retired.load(std::memory_order_acquire); }
+
+private:
+    int m_threadIndex;
+    std::atomic<bool> m_retired;
+    alignas(64) std::atomic<quint32> m_head;   // Written by the producer
+    alignas(64) std::atomic<quint32> m_tail;   // Written by the drain thread
+    std::array<LogRecord, Capacity> m_records;
+};
+
+// Leveled, lock-free logger. Call sites write binary records into a
+// per-thread ring; a background thread formats and writes them out.
+class AsyncLogger
+{
+public:
+    static AsyncLogger &instance();
+
+    static bool isEnabled(LogLevel level)
+    {
+        return int(level) >= s_level.load(std::memory_order_relaxed);
+    }
+
+    static void setLevel(LogLevel level) { s_level.store(int(level), std::memory_order_relaxed); }
+    static LogLevel level() { return LogLevel(s_level.load(std::memory_order_relaxed)); }
+    static LogLevel levelFromName(const char *name, LogLevel fallback);
+
+    void setOutput(FILE *output);
+    void shutdown();
+
+    quint64 droppedRecords() const { return m_dropped.load(std::memory_order_relaxed); }
+    int ringCount() const;                         // Threads with a ring not yet reclaimed
+
+    template<typename... Args>
+    void log(LogSite &site, const char *format, const Args &...args)
+    {
+        static_assert(sizeof...(Args) <= LogRecord::MaxArguments, "Too many log arguments");
+
+        qint64 now = nowNs();
+        quint32 suppressed = 0;
+        if (!site.admit(now, suppressed)) {
+            return;
+        }
+
+        LogRing &ring = threadRing();
+        LogRecord *record = ring.beginWrite();
+        if (!record) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        record->timestampNs = now;
+        record->site = &site;
+        record->format = format;
+        record->suppressed = suppressed;
+        record->argumentCount = 0;
+        record->textUsed = 0;
+        (encode(*record, args), ...);
+        ring.commitWrite();
+    }
+
+    static qint64 nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    AsyncLogger();
+    ~AsyncLogger();
+    AsyncLogger(const AsyncLogger &) = delete;
+    AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+    LogRing &threadRing();
+    void drainLoop();
+    bool drainOnce();
+    void writeRecord(FILE *output, const LogRecord &record, int threadIndex);
+
+    // Argument encoders
+    template<typename T>
+    static void encode(LogRecord &record, const T &value)
+    {
+        LogRecord::Argument &arg = record.arguments[record.argumentCount++];
+        if constexpr (std::is_same_v<T, bool>) {
+            encodeText(record, arg, value ? "true" : "false", value ? 4 : 5);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.type = LogRecord::Argument::Double;
+            arg.d = double(value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            arg.type = LogRecord::Argument::Signed;
+            arg.i = qint64(value);
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            arg.type = LogRecord::Argument::Unsigned;
+            arg.u = quint64(value);
+        } else if constexpr (std::is_same_v<T, QString>) {
+            QByteArray utf8 = value.toUtf8();
+            encodeText(record, arg, utf8.constData(), utf8.size());
+        } else if constexpr (std::is_same_v<T, QByteArray>) {
+            encodeText(record, arg, value.constData(), value.size());
+        } else {
+            const char *text = value;
+            encodeText(record, arg, text, text ? int(std::strlen(text)) : 0);
+        }
+    }
+
+    static void encodeText(LogRecord &record, LogRecord::Argument &arg, const char *text, int length)
+    {
+        int available = LogRecord::TextCapacity - record.textUsed;
+        int copied = qMax(0, qMin(length, available));
+        arg.type = LogRecord::Argument::Text;
+        arg.textOffset = record.textUsed;
+        arg.textLength = quint8(copied);
+        if (copied > 0) {
+            std::memcpy(record.text + record.textUsed, text, size_t(copied));
+        }
+        record.textUsed = quint8(record.textUsed + copied);
+    }
+
+    static std::atomic<int> s_level;
+
+    mutable std::mutex m_ringsLock;                // Guards registration and reclamation
+    std::vector<std::unique_ptr<LogRing>> m_rings;
+    int m_nextThreadIndex;
+    std::atomic<quint64> m_dropped;
+    quint64 m_reportedDrops;                       // Drain side only
+
+    std::mutex m_wakeLock;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running;
+    std::thread m_drainThread;
+
+    std::atomic<FILE *> m_output;                  // Read once per drain pass
+    qint64 m_startNs;
+};
+
+#define TLOG_AT(level, category, intervalMs, ...) \
+    do { \
+        if (AsyncLogger::isEnabled(level)) { \
+            static LogSite tlogSite_(category, level, intervalMs); \
+            AsyncLogger::instance().log(tlogSite_, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define TLOG_TRACE(category, ...) TLOG_AT(LogLevel::Trace, category, 0, __VA_ARGS__)
+#define TLOG_DEBUG(category, ...) TLOG_AT(LogLevel::Debug, category, 0, __VA_ARGS__)
+#define TLOG_INFO(category, ...) TLOG_AT(LogLevel::Info, category, 0, __VA_ARGS__)
+#define TLOG_WARN(category, ...) TLOG_AT(LogLevel::Warning, category, 0, __VA_ARGS__)
+#define TLOG_ERROR(category, ...) TLOG_AT(LogLevel::Error, category, 0, __VA_ARGS__)
+
+// Rate-limited variants: at most one record per intervalMs per call site
+#define TLOG_DEBUG_EVERY(category, intervalMs, ...) TLOG_AT(LogLevel::Debug, category, intervalMs, __VA_ARGS__)
+#define TLOG_WARN_EVERY(category, intervalMs, ...) TLOG_AT(LogLevel::Warning, category, intervalMs, __VA_ARGS__)
+
+#endif // ASYNCLOGGER_H
\ No newline at end of file
@@ -0,0 +1,358 @@
+#include "cfardetector.h"
+#include "cpufeatures.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Bin i of the spoke is cell i + window of the padded arrays. For CA,
+// prefix[j] is the sum of the first j padded cells, so each side's
+// training sum is one subtraction.
+struct CfarPass {
+    const quint8 *padded;
+    const qint32 *prefix;                // CA only
+    const quint8 *scaledCells;           // OS only
+    int count;
+    int guard;
+    int window;
+    float averageScale;                  // CA
+    int limit;                           // OS: most training cells x may fail to exceed
+    int minimum;
+    quint8 *hits;
+};
+
+void cellAveragingScalar(const CfarPass &pass, int begin)
+{
+    for (int i = begin; i < pass.count; ++i) {
+        int c = i + pass.window;
+        qint32 lead = pass.prefix[c - pass.guard] - pass.prefix[c - pass.window];
+        qint32 lag = pass.prefix[c + pass.window + 1] - pass.prefix[c + pass.guard + 1];
+        int x = pass.padded[c];
+        bool hit = x > pass.minimum && float(x) > float(lead + lag) * pass.averageScale;
+        pass.hits[i] = hit ? 0xFF : 0;
+    }
+}
+
+// x > floor(scale * cell) exactly when x > scale * cell, for integer x, so
+// comparing against the pre-scaled cells counts the cells x beats. x is over
+// the k-th smallest scaled cell when it beats at least k of them.
+void orderedStatisticScalar(const CfarPass &pass, int begin)
+{
+    for (int i = begin; i < pass.count; ++i) {
+        int c = i + pass.window;
+        int x = pass.padded[c];
+        int failed = 0;
+        for (int offset = pass.guard + 1; offset <= pass.window; ++offset) {
+            failed += x <= pass.scaledCells[c - offset];
+            failed += x <= pass.scaledCells[c + offset];
+        }
+        bool hit = x > pass.minimum && failed <= pass.limit;
+        pass.hits[i] = hit ? 0xFF : 0;
+    }
+}
+
+#if defined(TELEMETRY_HAVE_SSE2)
+inline __m128i loadPrefix4(const qint32 *p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+// Eight bins per step in two halves of four 32-bit lanes
+void cellAveragingSse2(const CfarPass &pass)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(pass.averageScale);
+    const __m128i minimum = _mm_set1_epi32(pass.minimum);
+
+    int i = 0;
+    for (; i + 8 <= pass.count; i += 8) {
+        int c = i + pass.window;
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pass.padded + c));
+        __m128i words = _mm_unpacklo_epi8(bytes, zero);
+        __m128i masks[2];
+        for (int half = 0; half < 2; ++half) {
+            int h = c + half * 4;
+            __m128i lead = _mm_sub_epi32(loadPrefix4(pass.prefix + h - pass.guard),
+                                         loadPrefix4(pass.prefix + h - pass.window));
+            __m128i lag = _mm_sub_epi32(loadPrefix4(pass.prefix + h + pass.window + 1),
+                                        loadPrefix4(pass.prefix + h + pass.guard + 1));
+            __m128 threshold = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(lead, lag)), scale);
+            __m128i x = half == 0 ? _mm_unpacklo_epi16(words, zero) : _mm_unpackhi_epi16(words, zero);
+            masks[half] = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(x), threshold)),
+                                        _mm_cmpgt_epi32(x, minimum));
+        }
+        __m128i packed = _mm_packs_epi16(_mm_packs_epi32(masks[0], masks[1]), zero);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(pass.hits + i), packed);
+    }
+    cellAveragingScalar(pass, i);
+}
+
+// Sixteen bins per step; counts stay below 128, so bytes hold them
+void orderedStatisticSse2(const CfarPass &pass)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8(-1);
+    const __m128i limit = _mm_set1_epi8(char(pass.limit));
+    const __m128i minimum = _mm_set1_epi8(char(pass.minimum));
+
+    int i = 0;
+    for (; i + 16 <= pass.count; i += 16) {
+        const quint8 *center = pass.scaledCells + i + pass.window;
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pass.padded + i + pass.window));
+        __m128i failed = zero;
+        for (int offset = pass.guard + 1; offset <= pass.window; ++offset) {
+            __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center - offset));
+            __m128i after = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + offset));
+            // x <= cell exactly when x saturating-minus cell is zero; the mask is -1
+            failed = _mm_sub_epi8(failed, _mm_cmpeq_epi8(_mm_subs_epu8(x, before), zero));
+            failed = _mm_sub_epi8(failed, _mm_cmpeq_epi8(_mm_subs_epu8(x, after), zero));
+        }
+        __m128i miss = _mm_or_si128(_mm_cmpgt_epi8(failed, limit),
+                                    _mm_cmpeq_epi8(_mm_subs_epu8(x, minimum), zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pass.hits + i), _mm_xor_si128(miss, ones));
+    }
+    orderedStatisticScalar(pass, i);
+}
+#endif
+
+#if defined(TELEMETRY_X86)
+// Same as SSE2 with eight lanes; the mask is narrowed per 128-bit half so
+// the packs keep bin order. No FMA: the threshold must round like scalar.
+TELEMETRY_TARGET_AVX2_NOFMA void cellAveragingAvx2(const CfarPass &pass)
+{
+    const __m256 scale = _mm256_set1_ps(pass.averageScale);
+    const __m256i minimum = _mm256_set1_epi32(pass.minimum);
+
+    int i = 0;
+    for (; i + 8 <= pass.count; i += 8) {
+        int c = i + pass.window;
+        __m256i lead = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pass.prefix + c - pass.guard)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pass.prefix + c - pass.window)));
+        __m256i lag = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pass.prefix + c + pass.window + 1)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pass.prefix + c + pass.guard + 1)));
+        __m256 threshold = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(lead, lag)), scale);
+        __m256i x = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pass.padded + c)));
+        __m256i mask = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(_mm256_cvtepi32_ps(x), threshold, _CMP_GT_OQ)),
+                                        _mm256_cmpgt_epi32(x, minimum));
+        __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(mask), _mm256_extracti128_si256(mask, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(pass.hits + i), _mm_packs_epi16(words, words));
+    }
+    cellAveragingScalar(pass, i);
+}
+
+TELEMETRY_TARGET_AVX2 void orderedStatisticAvx2(const CfarPass &pass)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8(-1);
+    const __m256i limit = _mm256_set1_epi8(char(pass.limit));
+    const __m256i minimum = _mm256_set1_epi8(char(pass.minimum));
+
+    int i = 0;
+    for (; i + 32 <= pass.count; i += 32) {
+        const quint8 *center = pass.scaledCells + i + pass.window;
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pass.padded + i + pass.window));
+        __m256i failed = zero;
+        for (int offset = pass.guard + 1; offset <= pass.window; ++offset) {
+            __m256i before = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(center - offset));
+            __m256i after = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(center + offset));
+            failed = _mm256_sub_epi8(failed, _mm256_cmpeq_epi8(_mm256_subs_epu8(x, before), zero));
+            failed = _mm256_sub_epi8(failed, _mm256_cmpeq_epi8(_mm256_subs_epu8(x, after), zero));
+        }
+        __m256i miss = _mm256_or_si256(_mm256_cmpgt_epi8(failed, limit),
+                                       _mm256_cmpeq_epi8(_mm256_subs_epu8(x, minimum), zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(pass.hits + i), _mm256_xor_si256(miss, ones));
+    }
+    orderedStatisticScalar(pass, i);
+}
+#endif
+
+void cellAveragingReference(const CfarPass &pass)
+{
+    cellAveragingScalar(pass, 0);
+}
+
+void orderedStatisticReference(const CfarPass &pass)
+{
+    orderedStatisticScalar(pass, 0);
+}
+
+struct CfarKernel {
+    void (*cellAveraging)(const CfarPass &);
+    void (*orderedStatistic)(const CfarPass &);
+    const char *name;
+};
+
+const CfarKernel &cfarKernel()
+{
+    static const CfarKernel kernel = []() -> CfarKernel {
+#if defined(TELEMETRY_X86)
+        if (CpuFeatures::hasAvx2()) {
+            return {cellAveragingAvx2, orderedStatisticAvx2, "avx2"};
+        }
+#endif
+#if defined(TELEMETRY_HAVE_SSE2)
+        return {cellAveragingSse2, orderedStatisticSse2, "sse2"};
+#else
+        return {cellAveragingReference, orderedStatisticReference, "scalar"};
+#endif
+    }();
+    return kernel;
+}
+
+} // namespace
+
+CfarDetector::CfarDetector()
+    : m_rank(0)
+    , m_averageScale(0.0f)
+{
+    setSettings(Settings());
+}
+
+void CfarDetector::setSettings(const Settings &settings)
+{
+    m_settings = settings;
+    m_settings.guardCells = qBound(0, settings.guardCells, 64);
+    m_settings.trainingCells = qBound(1, settings.trainingCells, MAX_TRAINING_CELLS);
+    m_settings.scale = qMax(0.0, settings.scale);
+    m_settings.minimumLevel = qBound(0, settings.minimumLevel, 255);
+
+    int cells = 2 * m_settings.trainingCells;
+    m_rank = settings.rank > 0 ? qMin(settings.rank, cells) : qMax(1, cells * 3 / 4);
+    m_averageScale = float(m_settings.scale / cells);
+    for (int level = 0; level < 256; ++level) {
+        m_scaled[level] = quint8(qMin(255.0, std::floor(m_settings.scale * level)));
+    }
+}
+
+const char *CfarDetector::kernelName()
+{
+    return cfarKernel().name;
+}
+
+double CfarDetector::falseAlarmProbability(const LevelDistribution &cell, const QVector<LevelDistribution> &training) const
+{
+    double probability = 0.0;
+
+    if (m_settings.mode == CellAveraging) {
+        double mean = 0.0;
+        double variance = 0.0;
+        for (const LevelDistribution &levels : training) {
+            double first = 0.0, second = 0.0;
+            for (int level = 0; level < 256; ++level) {
+                first += level * levels[level];
+                second += double(level) * level * levels[level];
+            }
+            mean += first;
+            variance += second - first * first;
+        }
+        double deviation = std::sqrt(qMax(0.0, variance));
+
+        for (int x = m_settings.minimumLevel + 1; x < 256; ++x) {
+            if (cell[x] <= 0.0) continue;
+            // x is a hit while the integer training sum is below x / averageScale
+            double below = m_averageScale > 0.0f ? std::ceil(x / double(m_averageScale)) - 0.5 : 1e9;
+            double hit = deviation > 0.0 ? 0.5 * std::erfc((mean - below) / (deviation * std::sqrt(2.0)))
+                                         : (below > mean ? 1.0 : 0.0);
+            probability += cell[x] * hit;
+        }
+        return probability;
+    }
+
+    // OS: P(x <= scaled cell) for each x from each cell's distribution
+    // of scaled levels, then the chance that at most limit cells fail x
+    QVector<LevelDistribution> failing(training.size());
+    for (int c = 0; c < training.size(); ++c) {
+        LevelDistribution scaled = {};
+        for (int level = 0; level < 256; ++level) {
+            scaled[m_scaled[level]] += training[c][level];
+        }
+        double tail = 0.0;
+        for (int x = 255; x >= 0; --x) {
+            tail += scaled[x];
+            failing[c][x] = tail;
+        }
+    }
+
+    int limit = 2 * m_settings.trainingCells - m_rank;
+    QVector<double> failed(limit + 2);      // The last slot collects every count over limit
+    for (int x = m_settings.minimumLevel + 1; x < 256; ++x) {
+        if (cell[x] <= 0.0) continue;
+        failed.fill(0.0);
+        failed[0] = 1.0;
+        for (const LevelDistribution &fails : failing) {
+            double f = fails[x];
+            failed[limit + 1] += failed[limit] * f;
+            for (int k = limit; k >= 1; --k) {
+                failed[k] = failed[k] * (1.0 - f) + failed[k - 1] * f;
+            }
+            failed[0] *= 1.0 - f;
+        }
+        double hit = 0.0;
+        for (int k = 0; k <= limit; ++k) {
+            hit += failed[k];
+        }
+        probability += cell[x] * hit;
+    }
+    return probability;
+}
+
+void CfarDetector::pad(const quint8 *bins, int count)
+{
+    // Mirror the spoke at both ends without repeating the edge bin, so an
+    // echo there is not counted again in its neighbours' training cells.
+    // Spokes shorter than the window clamp at the far end.
+    int w = window();
+    m_padded.resize(count + 2 * w);
+    quint8 *padded = m_padded.data();
+    std::memcpy(padded + w, bins, count);
+    for (int j = 0; j < w; ++j) {
+        padded[w - 1 - j] = bins[qMin(j + 1, count - 1)];
+        padded[w + count + j] = bins[qMax(count - 2 - j, 0)];
+    }
+
+    if (m_settings.mode == CellAveraging) {
+        m_prefix.resize(m_padded.size() + 1);
+        qint32 *prefix = m_prefix.data();
+        prefix[0] = 0;
+        for (int j = 0; j < m_padded.size(); ++j) {
+            prefix[j + 1] = prefix[j] + padded[j];
+        }
+    } else {
+        m_scaledCells.resize(m_padded.size());
+        quint8 *scaled = m_scaledCells.data();
+        for (int j = 0; j < m_padded.size(); ++j) {
+            scaled[j] = m_scaled[padded[j]];
+        }
+    }
+}
+
+void CfarDetector::detect(const quint8 *bins, int count, quint8 *hits)
+{
+    if (count <= 0) return;
+    pad(bins, count);
+
+    CfarPass pass = {m_padded.constData(), m_prefix.constData(), m_scaledCells.constData(), count,
+                     m_settings.guardCells, window(), m_averageScale,
+                     2 * m_settings.trainingCells - m_rank, m_settings.minimumLevel, hits};
+    if (m_settings.mode == CellAveraging) {
+        cfarKernel().cellAveraging(pass);
+    } else {
+        cfarKernel().orderedStatistic(pass);
+    }
+}
+
+void CfarDetector::detectScalar(const quint8 *bins, int count, quint8 *hits)
+{
+    if (count <= 0) return;
+    pad(bins, count);
+
+    CfarPass pass = {m_padded.constData(), m_prefix.constData(), m_scaledCells.constData(), count,
+                     m_settings.guardCells, window(), m_averageScale,
+                     2 * m_settings.trainingCells - m_rank, m_settings.minimumLevel, hits};
+    if (m_settings.mode == CellAveraging) {
+        cellAveragingReference(pass);
+    } else {
+        orderedStatisticReference(pass);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef CFARDETECTOR_H
+#define CFARDETECTOR_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+
+// Constant false alarm rate detection along one spoke. Each range bin is
+// compared against the noise estimated from training cells on both sides
+// of it, with guard cells in between so a target does not raise its own
+// threshold. The spoke is mirrored at both ends, so every bin has a full
+// window and the kernels need no edge cases.
+//
+// Cell averaging (CA) takes the mean of the training cells: cheapest, and
+// best in uniform noise. Ordered statistic (OS) takes the k-th smallest,
+// which keeps a second target or a clutter edge in the window from
+// masking the first. Both run the widest instruction set available at
+// run time, bit-identical to the scalar reference.
+class CfarDetector
+{
+public:
+    enum Mode {
+        CellAveraging,
+        OrderedStatistic
+    };
+
+    static constexpr int MAX_TRAINING_CELLS = 48;  // Per side; keeps OS counts in a byte
+
+    using LevelDistribution = std::array<double, 256>;  // Probability of each level
+
+    struct Settings {
+        Mode mode = CellAveraging;
+        int guardCells = 2;              // Per side
+        int trainingCells = 16;          // Per side
+        double scale = 3.0;              // Threshold over the noise estimate
+        int rank = 0;                    // OS: k of 2 * trainingCells, 0 for three quarters
+        int minimumLevel = 24;           // Bins at or below this never detect
+    };
+
+    CfarDetector();
+
+    void setSettings(const Settings &settings);
+    const Settings &settings() const { return m_settings; }
+
+    // hits[i] = 0xFF where bins[i] is over its threshold, else 0
+    void detect(const quint8 *bins, int count, quint8 *hits);
+    void detectScalar(const quint8 *bins, int count, quint8 *hits);
+
+    static const char *kernelName();
+
+    // Probability that a bin with no target is a hit, given its level
+    // distribution and those of its 2 * trainingCells training cells, all
+    // independent. Exact for OS; CA takes the training sum as normal.
+    double falseAlarmProbability(const LevelDistribution &cell, const QVector<LevelDistribution> &training) const;
+
+private:
+    void pad(const quint8 *bins, int count);
+    int window() const { return m_settings.guardCells + m_settings.trainingCells; }
+
+    Settings m_settings;
+    int m_rank;                          // Resolved OS rank
+    float m_averageScale;                // CA: scale / (2 * trainingCells)
+    std::array<quint8, 256> m_scaled;    // OS: floor(scale * level), saturated
+
+    // Scratch, reused across spokes
+    QVector<quint8> m_padded;            // Spoke with window() mirrored bins each side
+    QVector<qint32> m_prefix;            // CA: running sum of m_padded
+    QVector<quint8> m_scaledCells;       // OS: m_scaled applied to m_padded
+};
+
+#endif // CFARDETECTOR_H
\ No newline at end of file
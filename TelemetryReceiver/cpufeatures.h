@@ -0,0 +1,78 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+// Runtime CPU feature detection for the SIMD kernels. Kernels wider than
+// the build baseline are compiled with TELEMETRY_TARGET_AVX2 and selected
+// once at run time, so one binary runs everywhere.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TELEMETRY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TELEMETRY_TARGET_AVX2
+#define TELEMETRY_TARGET_AVX2_NOFMA
+#else
+#define TELEMETRY_TARGET_AVX2 __attribute__((target("avx2,fma")))
+// For floating-point kernels that must round exactly like their scalar
+// counterparts: without FMA the compiler cannot contract a * b + c
+#define TELEMETRY_TARGET_AVX2_NOFMA __attribute__((target("avx2")))
+#endif
+#endif
+
+// Inline every call, recursively, into a dispatch entry point so generic
+// lane code picks up the entry point's target instruction set
+#if defined(__GNUC__)
+#define TELEMETRY_FLATTEN __attribute__((flatten))
+#else
+#define TELEMETRY_FLATTEN
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TELEMETRY_HAVE_SSE2 1
+#endif
+
+namespace CpuFeatures {
+
+// AVX2 and FMA, with the OS saving YMM state
+inline bool hasAvx2()
+{
+#if defined(TELEMETRY_X86)
+    static const bool supported = []() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool fma = (info[2] & (1 << 12)) != 0;
+        if (!osxsave || !fma || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+inline bool hasSse2()
+{
+#if defined(TELEMETRY_HAVE_SSE2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace CpuFeatures
+
+#endif // CPUFEATURES_H
\ No newline at end of file
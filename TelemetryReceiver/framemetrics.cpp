@@ -0,0 +1,124 @@
+#include "framemetrics.h"
+#include <QMutexLocker>
+
+const char *FrameStats::stageName(int stage)
+{
+    static const char *const names[StageCount] = {
+        "Blit", "Background", "Rings", "Bearings", "Compass",
+        "Video", "Afterglow", "Wave", "Trails", "Contacts", "Info"
+    };
+    return stage >= 0 && stage < StageCount ? names[stage] : "";
+}
+
+FrameMetrics::FrameMetrics()
+    : m_samples(WINDOW)
+    , m_next(0)
+    , m_count(0)
+    , m_histogram(BIN_COUNT, 0)
+    , m_totalSumNs(0)
+{
+    m_stageSumNs.fill(0);
+    m_clock.start();
+}
+
+int FrameMetrics::binOf(qint64 ns)
+{
+    return int(qMin<qint64>(ns / (BIN_US * 1000), BIN_COUNT - 1));
+}
+
+void FrameMetrics::record(const FrameSample &sample)
+{
+    QMutexLocker locker(&m_lock);
+
+    // Evict the oldest frame once the window is full
+    FrameSample &slot = m_samples[m_next];
+    if (m_count == WINDOW) {
+        --m_histogram[binOf(slot.totalNs)];
+        m_totalSumNs -= slot.totalNs;
+        for (int stage = 0; stage < FrameStats::StageCount; ++stage) {
+            m_stageSumNs[stage] -= slot.stageNs[stage];
+        }
+    } else {
+        ++m_count;
+    }
+
+    slot = sample;
+    ++m_histogram[binOf(sample.totalNs)];
+    m_totalSumNs += sample.totalNs;
+    for (int stage = 0; stage < FrameStats::StageCount; ++stage) {
+        m_stageSumNs[stage] += sample.stageNs[stage];
+    }
+    m_next = (m_next + 1) % WINDOW;
+}
+
+FrameStats FrameMetrics::snapshot() const
+{
+    QMutexLocker locker(&m_lock);
+    FrameStats stats;
+    stats.frames = m_count;
+    if (m_count == 0) {
+        return stats;
+    }
+
+    stats.meanMs = m_totalSumNs / 1e6 / m_count;
+    for (int stage = 0; stage < FrameStats::StageCount; ++stage) {
+        stats.stageMeanMs[stage] = m_stageSumNs[stage] / 1e6 / m_count;
+    }
+
+    // Oldest and newest frame in the ring give the rate
+    int newest = (m_next + WINDOW - 1) % WINDOW;
+    int oldest = m_count == WINDOW ? m_next : 0;
+    qint64 spanNs = m_samples[newest].startNs - m_samples[oldest].startNs;
+    if (spanNs > 0) {
+        stats.fps = (m_count - 1) * 1e9 / spanNs;
+    }
+
+    // Percentiles from the histogram, reported at the bin's upper edge
+    int p50Rank = (m_count + 1) / 2;
+    int p99Rank = qMax(1, (m_count * 99 + 99) / 100);
+    int seen = 0;
+    for (int bin = 0; bin < BIN_COUNT; ++bin) {
+        if (m_histogram[bin] == 0) {
+            continue;
+        }
+        int before = seen;
+        seen += m_histogram[bin];
+        double upperMs = (bin + 1) * BIN_US / 1000.0;
+        if (before < p50Rank && seen >= p50Rank) {
+            stats.p50Ms = upperMs;
+        }
+        if (before < p99Rank && seen >= p99Rank) {
+            stats.p99Ms = upperMs;
+        }
+    }
+    for (int i = 0; i < m_count; ++i) {
+        stats.maxMs = qMax(stats.maxMs, m_samples[i].totalNs / 1e6);
+    }
+    return stats;
+}
+
+double FrameMetrics::meanSinceMs(qint64 sinceNs, int &frames) const
+{
+    QMutexLocker locker(&m_lock);
+    qint64 sumNs = 0;
+    frames = 0;
+    for (int i = 0; i < m_count; ++i) {
+        const FrameSample &sample = m_samples[(m_next + WINDOW - 1 - i) % WINDOW];
+        if (sample.startNs < sinceNs) {
+            break; // Newest first, so every earlier frame is older still
+        }
+        sumNs += sample.totalNs;
+        ++frames;
+    }
+    return frames > 0 ? sumNs / 1e6 / frames : 0.0;
+}
+
+void FrameMetrics::reset()
+{
+    QMutexLocker locker(&m_lock);
+    m_next = 0;
+    m_count = 0;
+    m_histogram.fill(0);
+    m_stageSumNs.fill(0);
+    m_totalSumNs = 0;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef FRAMEMETRICS_H
+#define FRAMEMETRICS_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QVector>
+#include <array>
+
+// Point-in-time view of the rolling frame statistics
+struct FrameStats {
+    enum Stage {
+        BlitStage,                       // Restoring the cached static layers
+        BackgroundStage,                 // The four static layers, only when the cache is rebuilt
+        RingsStage,
+        BearingsStage,
+        CompassStage,
+        VideoStage,
+        AfterglowStage,
+        WaveStage,
+        TrailsStage,
+        ContactsStage,
+        InfoStage,
+        StageCount
+    };
+
+    int frames = 0;                      // Frames in the window
+    double fps = 0.0;                    // Frames drawn per second over the window
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    std::array<double, StageCount> stageMeanMs{};
+
+    static const char *stageName(int stage);
+};
+
+// Timings of one frame, filled in by the renderer
+struct FrameSample {
+    qint64 startNs = 0;                  // Monotonic, for the frame rate
+    qint64 totalNs = 0;
+    std::array<qint64, FrameStats::StageCount> stageNs{};
+};
+
+// Rolling frame-time histogram over the last WINDOW frames. The renderer
+// records from whichever thread draws; snapshots may be taken from any
+// other. Each frame takes the lock once, uncontended in practice.
+class FrameMetrics
+{
+public:
+    static constexpr int WINDOW = 256;         // Frames kept
+    static constexpr int BIN_US = 50;          // Histogram resolution
+    static constexpr int BIN_COUNT = 2000;     // Up to 100 ms; slower frames share the last bin
+
+    FrameMetrics();
+
+    void record(const FrameSample &sample);
+    FrameStats snapshot() const;
+    void reset();
+
+    // Mean frame time of the frames started at or after sinceNs, still in
+    // the window; frames is set to how many there were
+    double meanSinceMs(qint64 sinceNs, int &frames) const;
+
+    // Monotonic clock shared by every recorder, for FrameSample::startNs
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+private:
+    static int binOf(qint64 ns);
+
+    mutable QMutex m_lock;
+    QElapsedTimer m_clock;
+    QVector<FrameSample> m_samples;            // Ring of the last WINDOW frames
+    int m_next;                                // Slot the next sample goes to
+    int m_count;
+    QVector<int> m_histogram;                  // Frames in the window per BIN_US bin
+    std::array<qint64, FrameStats::StageCount> m_stageSumNs;
+    qint64 m_totalSumNs;
+};
+
+// Times consecutive stages of one frame. Does nothing, not even read the
+// clock, when constructed without metrics, so disabled instrumentation
+// costs one branch per stage.
+class FrameStageTimer
+{
+public:
+    explicit FrameStageTimer(FrameMetrics *metrics)
+        : m_metrics(metrics)
+    {
+        if (m_metrics) {
+            m_sample.startNs = m_metrics->nowNs();
+            m_lastNs = m_sample.startNs;
+        }
+    }
+
+    // Charge the time since the previous mark to stage
+    void mark(FrameStats::Stage stage)
+    {
+        if (m_metrics) {
+            qint64 now = m_metrics->nowNs();
+            m_sample.stageNs[stage] += now - m_lastNs;
+            m_lastNs = now;
+        }
+    }
+
+    // Time since the previous mark belongs to no stage
+    void skip()
+    {
+        if (m_metrics) {
+            m_lastNs = m_metrics->nowNs();
+        }
+    }
+
+    void finish()
+    {
+        if (m_metrics) {
+            m_sample.totalNs = m_metrics->nowNs() - m_sample.startNs;
+            m_metrics->record(m_sample);
+            m_metrics = nullptr;
+        }
+    }
+
+    bool isActive() const { return m_metrics != nullptr; }
+
+private:
+    FrameMetrics *m_metrics;
+    FrameSample m_sample;
+    qint64 m_lastNs = 0;
+};
+
+#endif // FRAMEMETRICS_H
\ No newline at end of file
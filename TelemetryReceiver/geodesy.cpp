@@ -0,0 +1,554 @@
+#include "geodesy.h"
+#include "cpufeatures.h"
+#include <algorithm>
+#include <cmath>
+
+// The SIMD and scalar kernels must round identically, so keep the compiler
+// from fusing multiply-adds in one and not the other. Scoped to this file
+// so the build needs no special flags and the rest of the code is unaffected.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+namespace Geodesy {
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG_TO_RAD = PI / 180.0;
+constexpr double RAD_TO_DEG = 180.0 / PI;
+
+// Adding and subtracting 1.5 * 2^52 rounds to the nearest integer in the
+// default rounding mode, with plain arithmetic every lane type has
+constexpr double ROUND_MAGIC = 6755399441055744.0;
+
+// pi/2 in two parts (fdlibm); the high part has trailing zero bits so
+// quadrant * PIO2_HI is exact for the quadrants seen here
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double PIO2_HI = 1.57079632673412561417e+00;
+constexpr double PIO2_LO = 6.07710050650619224932e-11;
+
+// atan on [0, 0.66] (Cephes)
+constexpr double ATAN_P0 = -8.750608600031904122785e-01;
+constexpr double ATAN_P1 = -1.615753718733365076637e+01;
+constexpr double ATAN_P2 = -7.500855792314704667340e+01;
+constexpr double ATAN_P3 = -1.228866684490136173410e+02;
+constexpr double ATAN_P4 = -6.485021904942025371773e+01;
+constexpr double ATAN_Q0 = 2.485846490142306297962e+01;
+constexpr double ATAN_Q1 = 1.650270098316988542046e+02;
+constexpr double ATAN_Q2 = 4.328810604912902668951e+02;
+constexpr double ATAN_Q3 = 4.853903996359136964868e+02;
+constexpr double ATAN_Q4 = 1.945506571482613964425e+02;
+constexpr double ATAN_MOREBITS = 6.123233995736765886130e-17;
+
+// Bearings sampled around each circle when calibrating a tangent plane,
+// and golden-section steps that pin down each peak found between them
+constexpr int CALIBRATION_BEARINGS = 72;
+constexpr int CALIBRATION_REFINE_STEPS = 40;
+constexpr double GOLDEN_RATIO_CONJUGATE = 0.61803398874989484820;
+
+// Lane types. Each provides the same operations with the same IEEE
+// rounding; comparisons return a mask used only by select().
+
+struct Scalar {
+    static constexpr int Lanes = 1;
+    double v;
+
+    static Scalar set(double x) { return {x}; }
+    static Scalar load(const double *p) { return {*p}; }
+    void store(double *p) const { *p = v; }
+};
+
+struct ScalarMask {
+    bool m;
+};
+
+inline Scalar operator+(const Scalar &a, const Scalar &b) { return {a.v + b.v}; }
+inline Scalar operator-(const Scalar &a, const Scalar &b) { return {a.v - b.v}; }
+inline Scalar operator*(const Scalar &a, const Scalar &b) { return {a.v * b.v}; }
+inline Scalar operator/(const Scalar &a, const Scalar &b) { return {a.v / b.v}; }
+inline Scalar sqrt(const Scalar &a) { return {std::sqrt(a.v)}; }
+inline Scalar abs(const Scalar &a) { return {std::fabs(a.v)}; }
+inline Scalar negate(const Scalar &a) { return {-a.v}; }
+inline Scalar min(const Scalar &a, const Scalar &b) { return {a.v < b.v ? a.v : b.v}; }
+inline Scalar max(const Scalar &a, const Scalar &b) { return {a.v > b.v ? a.v : b.v}; }
+inline ScalarMask lessThan(const Scalar &a, const Scalar &b) { return {a.v < b.v}; }
+inline ScalarMask greaterThan(const Scalar &a, const Scalar &b) { return {a.v > b.v}; }
+inline ScalarMask greaterEqual(const Scalar &a, const Scalar &b) { return {a.v >= b.v}; }
+inline ScalarMask equal(const Scalar &a, const Scalar &b) { return {a.v == b.v}; }
+inline ScalarMask operator|(const ScalarMask &a, const ScalarMask &b) { return {a.m || b.m}; }
+inline Scalar select(const ScalarMask &m, const Scalar &a, const Scalar &b) { return m.m ? a : b; }
+
+#if defined(TELEMETRY_HAVE_SSE2)
+struct Sse2 {
+    static constexpr int Lanes = 2;
+    __m128d v;
+
+    static Sse2 set(double x) { return {_mm_set1_pd(x)}; }
+    static Sse2 load(const double *p) { return {_mm_loadu_pd(p)}; }
+    void store(double *p) const { _mm_storeu_pd(p, v); }
+};
+
+struct Sse2Mask {
+    __m128d m;
+};
+
+inline Sse2 operator+(const Sse2 &a, const Sse2 &b) { return {_mm_add_pd(a.v, b.v)}; }
+inline Sse2 operator-(const Sse2 &a, const Sse2 &b) { return {_mm_sub_pd(a.v, b.v)}; }
+inline Sse2 operator*(const Sse2 &a, const Sse2 &b) { return {_mm_mul_pd(a.v, b.v)}; }
+inline Sse2 operator/(const Sse2 &a, const Sse2 &b) { return {_mm_div_pd(a.v, b.v)}; }
+inline Sse2 sqrt(const Sse2 &a) { return {_mm_sqrt_pd(a.v)}; }
+inline Sse2 abs(const Sse2 &a) { return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+inline Sse2 negate(const Sse2 &a) { return {_mm_xor_pd(a.v, _mm_set1_pd(-0.0))}; }
+inline Sse2 min(const Sse2 &a, const Sse2 &b) { return {_mm_min_pd(a.v, b.v)}; }
+inline Sse2 max(const Sse2 &a, const Sse2 &b) { return {_mm_max_pd(a.v, b.v)}; }
+inline Sse2Mask lessThan(const Sse2 &a, const Sse2 &b) { return {_mm_cmplt_pd(a.v, b.v)}; }
+inline Sse2Mask greaterThan(const Sse2 &a, const Sse2 &b) { return {_mm_cmpgt_pd(a.v, b.v)}; }
+inline Sse2Mask greaterEqual(const Sse2 &a, const Sse2 &b) { return {_mm_cmpge_pd(a.v, b.v)}; }
+inline Sse2Mask equal(const Sse2 &a, const Sse2 &b) { return {_mm_cmpeq_pd(a.v, b.v)}; }
+inline Sse2Mask operator|(const Sse2Mask &a, const Sse2Mask &b) { return {_mm_or_pd(a.m, b.m)}; }
+inline Sse2 select(const Sse2Mask &m, const Sse2 &a, const Sse2 &b)
+{
+    return {_mm_or_pd(_mm_and_pd(m.m, a.v), _mm_andnot_pd(m.m, b.v))};
+}
+#endif
+
+#if defined(TELEMETRY_X86)
+struct Avx2 {
+    static constexpr int Lanes = 4;
+    __m256d v;
+
+    TELEMETRY_TARGET_AVX2_NOFMA static Avx2 set(double x) { return {_mm256_set1_pd(x)}; }
+    TELEMETRY_TARGET_AVX2_NOFMA static Avx2 load(const double *p) { return {_mm256_loadu_pd(p)}; }
+    TELEMETRY_TARGET_AVX2_NOFMA void store(double *p) const { _mm256_storeu_pd(p, v); }
+};
+
+struct Avx2Mask {
+    __m256d m;
+};
+
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 operator+(const Avx2 &a, const Avx2 &b) { return {_mm256_add_pd(a.v, b.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 operator-(const Avx2 &a, const Avx2 &b) { return {_mm256_sub_pd(a.v, b.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 operator*(const Avx2 &a, const Avx2 &b) { return {_mm256_mul_pd(a.v, b.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 operator/(const Avx2 &a, const Avx2 &b) { return {_mm256_div_pd(a.v, b.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 sqrt(const Avx2 &a) { return {_mm256_sqrt_pd(a.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 abs(const Avx2 &a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 negate(const Avx2 &a) { return {_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 min(const Avx2 &a, const Avx2 &b) { return {_mm256_min_pd(a.v, b.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 max(const Avx2 &a, const Avx2 &b) { return {_mm256_max_pd(a.v, b.v)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2Mask lessThan(const Avx2 &a, const Avx2 &b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2Mask greaterThan(const Avx2 &a, const Avx2 &b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2Mask greaterEqual(const Avx2 &a, const Avx2 &b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2Mask equal(const Avx2 &a, const Avx2 &b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2Mask operator|(const Avx2Mask &a, const Avx2Mask &b) { return {_mm256_or_pd(a.m, b.m)}; }
+TELEMETRY_TARGET_AVX2_NOFMA inline Avx2 select(const Avx2Mask &m, const Avx2 &a, const Avx2 &b)
+{
+    return {_mm256_blendv_pd(b.v, a.v, m.m)};
+}
+#endif
+
+// Generic math over any lane type
+
+template<typename V>
+inline V roundNearest(const V &x)
+{
+    const V magic = V::set(ROUND_MAGIC);
+    return (x + magic) - magic;
+}
+
+// sin and cos of x radians, |x| up to a few turns
+template<typename V>
+inline void sinCos(const V &x, V &sine, V &cosine)
+{
+    // x = quadrant * pi/2 + r, |r| <= pi/4
+    V quadrant = roundNearest(x * V::set(TWO_OVER_PI));
+    V r = (x - quadrant * V::set(PIO2_HI)) - quadrant * V::set(PIO2_LO);
+    V r2 = r * r;
+
+    // Taylor series; the first omitted terms are below 1e-16
+    V s = V::set(-1.0 / 1307674368000.0);
+    s = s * r2 + V::set(1.0 / 6227020800.0);
+    s = s * r2 + V::set(-1.0 / 39916800.0);
+    s = s * r2 + V::set(1.0 / 362880.0);
+    s = s * r2 + V::set(-1.0 / 5040.0);
+    s = s * r2 + V::set(1.0 / 120.0);
+    s = s * r2 + V::set(-1.0 / 6.0);
+    s = r + r * r2 * s;
+
+    V c = V::set(1.0 / 20922789888000.0);
+    c = c * r2 + V::set(-1.0 / 87178291200.0);
+    c = c * r2 + V::set(1.0 / 479001600.0);
+    c = c * r2 + V::set(-1.0 / 3628800.0);
+    c = c * r2 + V::set(1.0 / 40320.0);
+    c = c * r2 + V::set(-1.0 / 720.0);
+    c = c * r2 + V::set(1.0 / 24.0);
+    c = c * r2 + V::set(-0.5);
+    c = V::set(1.0) + r2 * c;
+
+    // Quadrant mod 4 as the exact fraction 0, 1/4, 1/2 or 3/4
+    V quarter = quadrant * V::set(0.25);
+    V whole = roundNearest(quarter);
+    whole = select(greaterThan(whole, quarter), whole - V::set(1.0), whole);
+    V phase = quarter - whole;
+
+    auto one = equal(phase, V::set(0.25));
+    auto two = equal(phase, V::set(0.5));
+    auto three = equal(phase, V::set(0.75));
+    auto swap = one | three;
+    V sinBase = select(swap, c, s);
+    V cosBase = select(swap, s, c);
+    sine = select(two | three, negate(sinBase), sinBase);
+    cosine = select(one | two, negate(cosBase), cosBase);
+}
+
+// atan2(y, x) in radians, (-pi, pi]
+template<typename V>
+inline V atan2(const V &y, const V &x)
+{
+    V ax = abs(x);
+    V ay = abs(y);
+    V hi = max(ax, ay);
+    V lo = min(ax, ay);
+    V t = lo / select(equal(hi, V::set(0.0)), V::set(1.0), hi);
+
+    // atan(t) for t in [0, 1]; above 0.66 through atan(t) = pi/4 + atan((t-1)/(t+1))
+    auto reduce = greaterThan(t, V::set(0.66));
+    V base = select(reduce, V::set(PI / 4), V::set(0.0));
+    V extra = select(reduce, V::set(0.5 * ATAN_MOREBITS), V::set(0.0));
+    t = select(reduce, (t - V::set(1.0)) / (t + V::set(1.0)), t);
+
+    V z = t * t;
+    V p = V::set(ATAN_P0);
+    p = p * z + V::set(ATAN_P1);
+    p = p * z + V::set(ATAN_P2);
+    p = p * z + V::set(ATAN_P3);
+    p = p * z + V::set(ATAN_P4);
+    V q = z + V::set(ATAN_Q0);
+    q = q * z + V::set(ATAN_Q1);
+    q = q * z + V::set(ATAN_Q2);
+    q = q * z + V::set(ATAN_Q3);
+    q = q * z + V::set(ATAN_Q4);
+    V angle = base + ((t * (z * p / q) + t) + extra);
+
+    // Back to the full circle
+    angle = select(greaterThan(ay, ax), V::set(PI / 2) - angle, angle);
+    angle = select(lessThan(x, V::set(0.0)), V::set(PI) - angle, angle);
+    return select(lessThan(y, V::set(0.0)), negate(angle), angle);
+}
+
+template<typename V>
+inline void projectLanes(const Origin &origin, int i, const double *latitude, const double *longitude,
+                         const Projection &out)
+{
+    V lat = V::load(latitude + i);
+    V lon = V::load(longitude + i);
+    V degToRad = V::set(DEG_TO_RAD);
+    V half = V::set(0.5);
+    V two = V::set(2.0);
+    V one = V::set(1.0);
+    V zero = V::set(0.0);
+
+    V sinLat, cosLat;
+    sinCos(lat * degToRad, sinLat, cosLat);
+
+    // Half-angle forms keep short distances accurate
+    V sinHalfLon, cosHalfLon, sinHalfLat, cosHalfLat;
+    sinCos((lon - V::set(origin.longitude)) * degToRad * half, sinHalfLon, cosHalfLon);
+    sinCos((lat - V::set(origin.latitude)) * degToRad * half, sinHalfLat, cosHalfLat);
+    V sinDLon = two * sinHalfLon * cosHalfLon;
+    V cosDLon = one - two * sinHalfLon * sinHalfLon;
+
+    // Initial bearing
+    V y = sinDLon * cosLat;
+    V x = V::set(origin.cosLatitude) * sinLat - V::set(origin.sinLatitude) * cosLat * cosDLon;
+    if (out.bearing) {
+        V bearing = atan2(y, x) * V::set(RAD_TO_DEG);
+        bearing = select(lessThan(bearing, zero), bearing + V::set(360.0), bearing);
+        bearing = select(greaterEqual(bearing, V::set(360.0)), bearing - V::set(360.0), bearing);
+        bearing.store(out.bearing + i);
+    }
+
+    // Haversine distance
+    V a = sinHalfLat * sinHalfLat + V::set(origin.cosLatitude) * cosLat * sinHalfLon * sinHalfLon;
+    a = min(max(a, zero), one);
+    V range = V::set(2.0 * EARTH_RADIUS_NM) * atan2(sqrt(a), sqrt(one - a));
+    if (out.range) {
+        range.store(out.range + i);
+    }
+
+    // East/north at that range along the bearing: sin and cos of the
+    // bearing are y and x normalised, no second atan2 or sincos needed
+    if (out.east || out.north) {
+        V length = sqrt(x * x + y * y);
+        auto atOrigin = equal(length, zero);
+        V scale = range / select(atOrigin, one, length);
+        if (out.east) {
+            select(atOrigin, zero, y * scale).store(out.east + i);
+        }
+        if (out.north) {
+            select(atOrigin, zero, x * scale).store(out.north + i);
+        }
+    }
+}
+
+void projectScalarFrom(const Origin &origin, int begin, const double *latitude, const double *longitude,
+                       int count, const Projection &out)
+{
+    for (int i = begin; i < count; ++i) {
+        projectLanes<Scalar>(origin, i, latitude, longitude, out);
+    }
+}
+
+// Whole vectors with V, the tail one point at a time
+template<typename V>
+inline void projectBatch(const Origin &origin, const double *latitude, const double *longitude,
+                         int count, const Projection &out)
+{
+    int i = 0;
+    for (; i + V::Lanes <= count; i += V::Lanes) {
+        projectLanes<V>(origin, i, latitude, longitude, out);
+    }
+    projectScalarFrom(origin, i, latitude, longitude, count, out);
+}
+
+#if defined(TELEMETRY_HAVE_SSE2)
+TELEMETRY_FLATTEN void projectSse2(const Origin &origin, const double *latitude, const double *longitude,
+                                   int count, const Projection &out)
+{
+    projectBatch<Sse2>(origin, latitude, longitude, count, out);
+}
+#endif
+
+#if defined(TELEMETRY_X86)
+TELEMETRY_TARGET_AVX2_NOFMA TELEMETRY_FLATTEN
+void projectAvx2(const Origin &origin, const double *latitude, const double *longitude,
+                 int count, const Projection &out)
+{
+    projectBatch<Avx2>(origin, latitude, longitude, count, out);
+}
+#endif
+
+struct ProjectKernel {
+    void (*function)(const Origin &, const double *, const double *, int, const Projection &);
+    const char *name;
+};
+
+const ProjectKernel &projectKernel()
+{
+    static const ProjectKernel kernel = []() -> ProjectKernel {
+#if defined(TELEMETRY_X86)
+        if (CpuFeatures::hasAvx2()) {
+            return {projectAvx2, "avx2"};
+        }
+#endif
+#if defined(TELEMETRY_HAVE_SSE2)
+        return {projectSse2, "sse2"};
+#else
+        return {projectScalar, "scalar"};
+#endif
+    }();
+    return kernel;
+}
+
+} // namespace
+
+Origin makeOrigin(double latitude, double longitude)
+{
+    Origin origin;
+    origin.latitude = latitude;
+    origin.longitude = longitude;
+
+    // Same sine and cosine as the kernels, so every path sees identical inputs
+    Scalar sine, cosine;
+    sinCos(Scalar::set(latitude * DEG_TO_RAD), sine, cosine);
+    origin.sinLatitude = sine.v;
+    origin.cosLatitude = cosine.v;
+    return origin;
+}
+
+void bearingRange(const Origin &origin, double latitude, double longitude,
+                  double &bearing, double &range)
+{
+    Projection out;
+    out.bearing = &bearing;
+    out.range = &range;
+    projectLanes<Scalar>(origin, 0, &latitude, &longitude, out);
+}
+
+void destination(const Origin &origin, double bearing, double range,
+                 double &latitude, double &longitude)
+{
+    double angle = range / EARTH_RADIUS_NM;
+    double theta = bearing * DEG_TO_RAD;
+    double sinAngle = std::sin(angle);
+    double cosAngle = std::cos(angle);
+    double sinLatitude = origin.sinLatitude * cosAngle + origin.cosLatitude * sinAngle * std::cos(theta);
+    sinLatitude = std::max(-1.0, std::min(1.0, sinLatitude));
+    double deltaLongitude = std::atan2(std::sin(theta) * sinAngle * origin.cosLatitude,
+                                       cosAngle - origin.sinLatitude * sinLatitude);
+
+    latitude = std::asin(sinLatitude) * RAD_TO_DEG;
+    longitude = std::remainder(origin.longitude + deltaLongitude * RAD_TO_DEG, 360.0);
+}
+
+void project(const Origin &origin, const double *latitude, const double *longitude,
+             int count, const Projection &out)
+{
+    projectKernel().function(origin, latitude, longitude, count, out);
+}
+
+void projectScalar(const Origin &origin, const double *latitude, const double *longitude,
+                   int count, const Projection &out)
+{
+    projectScalarFrom(origin, 0, latitude, longitude, count, out);
+}
+
+const char *kernelName()
+{
+    return projectKernel().name;
+}
+
+TangentPlane::TangentPlane(const Origin &origin, double errorBudgetNM)
+    : m_origin(origin)
+    , m_errorBudgetNM(errorBudgetNM > 0.0 ? errorBudgetNM : DEFAULT_ERROR_BUDGET_NM)
+    , m_planarLimitNM(0.0)
+    , m_maxPlanarErrorNM(0.0)
+    , m_eastScale(EARTH_RADIUS_NM * origin.cosLatitude)
+    , m_eastShear(EARTH_RADIUS_NM * origin.sinLatitude)
+    , m_northBend(0.5 * EARTH_RADIUS_NM * origin.sinLatitude * origin.cosLatitude)
+    , m_maxLatitudeDelta(0.0)
+{
+    // The error grows with range, so bisect for where it meets the budget.
+    // project() accepts a point by its planar range, which can fall short of
+    // the true range by up to the error, so the budget is met a budget's
+    // width past the limit. Some ten thousand scalar projections, once per
+    // origin.
+    double low = 0.0;
+    double high = PI / 2 * EARTH_RADIUS_NM;
+    for (int i = 0; i < 40; ++i) {
+        double mid = 0.5 * (low + high);
+        if (planarErrorAt(mid + m_errorBudgetNM) <= m_errorBudgetNM) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    m_planarLimitNM = low;
+
+    // Latitude cannot change by more than the distance travelled, so this
+    // rejects most far points before the expansion is evaluated
+    m_maxLatitudeDelta = m_planarLimitNM / EARTH_RADIUS_NM;
+
+    for (int step = 1; step <= 8; ++step) {
+        m_maxPlanarErrorNM = std::max(m_maxPlanarErrorNM, planarErrorAt(m_planarLimitNM * step / 8));
+    }
+}
+
+void TangentPlane::expand(double latitude, double longitude, double &east, double &north) const
+{
+    double dLat = (latitude - m_origin.latitude) * DEG_TO_RAD;
+    double dLon = longitude - m_origin.longitude;
+    if (dLon > 180.0) {
+        dLon -= 360.0;
+    } else if (dLon < -180.0) {
+        dLon += 360.0;
+    }
+    dLon *= DEG_TO_RAD;
+    east = dLon * (m_eastScale - m_eastShear * dLat);
+    north = dLat * EARTH_RADIUS_NM + dLon * dLon * m_northBend;
+}
+
+// Worst planar error on a circle of the given range, against the exact
+// azimuthal equidistant position of points placed on it with libm. The
+// worst bearing generally falls between the coarse samples, so each
+// sampled peak is refined by golden-section search over its neighbours'
+// span; the error is smooth in bearing and has one maximum there.
+double TangentPlane::planarErrorAt(double rangeNM) const
+{
+    double distance = rangeNM / EARTH_RADIUS_NM;
+    double sinDistance = std::sin(distance);
+    double cosDistance = std::cos(distance);
+    auto errorAt = [&](double bearing) {
+        double sinLatitude = m_origin.sinLatitude * cosDistance
+                           + m_origin.cosLatitude * sinDistance * std::cos(bearing);
+        double latitude = std::asin(std::max(-1.0, std::min(1.0, sinLatitude)));
+        double dLon = std::atan2(std::sin(bearing) * sinDistance * m_origin.cosLatitude,
+                                 cosDistance - m_origin.sinLatitude * sinLatitude);
+
+        double east, north;
+        expand(latitude * RAD_TO_DEG, m_origin.longitude + dLon * RAD_TO_DEG, east, north);
+        return std::hypot(east - rangeNM * std::sin(bearing), north - rangeNM * std::cos(bearing));
+    };
+
+    const double step = 2.0 * PI / CALIBRATION_BEARINGS;
+    double sampled[CALIBRATION_BEARINGS];
+    for (int i = 0; i < CALIBRATION_BEARINGS; ++i) {
+        sampled[i] = errorAt(i * step);
+    }
+
+    double worst = 0.0;
+    for (int i = 0; i < CALIBRATION_BEARINGS; ++i) {
+        worst = std::max(worst, sampled[i]);
+        if (sampled[i] < sampled[(i + CALIBRATION_BEARINGS - 1) % CALIBRATION_BEARINGS]
+            || sampled[i] < sampled[(i + 1) % CALIBRATION_BEARINGS]) {
+            continue;
+        }
+
+        double a = (i - 1) * step;
+        double b = (i + 1) * step;
+        double c = b - GOLDEN_RATIO_CONJUGATE * (b - a);
+        double d = a + GOLDEN_RATIO_CONJUGATE * (b - a);
+        double errorC = errorAt(c);
+        double errorD = errorAt(d);
+        for (int k = 0; k < CALIBRATION_REFINE_STEPS; ++k) {
+            if (errorC >= errorD) {
+                b = d;
+                d = c;
+                errorD = errorC;
+                c = b - GOLDEN_RATIO_CONJUGATE * (b - a);
+                errorC = errorAt(c);
+            } else {
+                a = c;
+                c = d;
+                errorC = errorD;
+                d = a + GOLDEN_RATIO_CONJUGATE * (b - a);
+                errorD = errorAt(d);
+            }
+        }
+        worst = std::max(worst, std::max(errorC, errorD));
+    }
+    return worst;
+}
+
+bool TangentPlane::project(double latitude, double longitude, Fix &fix) const
+{
+    if (std::fabs(latitude - m_origin.latitude) * DEG_TO_RAD <= m_maxLatitudeDelta) {
+        double east, north;
+        expand(latitude, longitude, east, north);
+        double range = std::sqrt(east * east + north * north);
+        if (range <= m_planarLimitNM) {
+            double bearing = atan2(Scalar::set(east), Scalar::set(north)).v * RAD_TO_DEG;
+            if (bearing < 0.0) {
+                bearing += 360.0;
+            }
+            fix.bearing = bearing < 360.0 ? bearing : bearing - 360.0;
+            fix.range = range;
+            fix.east = east;
+            fix.north = north;
+            return true;
+        }
+    }
+
+    Projection out;
+    out.bearing = &fix.bearing;
+    out.range = &fix.range;
+    out.east = &fix.east;
+    out.north = &fix.north;
+    projectLanes<Scalar>(m_origin, 0, &latitude, &longitude, out);
+    return false;
+}
+
+} // namespace Geodesy
\ No newline at end of file
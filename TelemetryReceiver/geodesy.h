@@ -0,0 +1,102 @@
+#ifndef GEODESY_H
+#define GEODESY_H
+
+// Great-circle projection of latitude/longitude around the radar origin:
+// bearing and range for the polar display, east/north for the plane.
+//
+// The math is written once against a small lane type and compiled for
+// scalar code, SSE2 and AVX2. Sine, cosine and atan2 are evaluated with
+// the same polynomials on every path and no path fuses multiply-adds, so
+// the batch results are bit-for-bit those of the scalar reference. Both
+// agree with libm to about 1e-11 degrees of bearing and 1e-12 of range.
+namespace Geodesy {
+
+constexpr double EARTH_RADIUS_NM = 3440.065;
+
+struct Origin {
+    double latitude = 0.0;               // Degrees
+    double longitude = 0.0;
+    double sinLatitude = 0.0;
+    double cosLatitude = 1.0;
+};
+
+Origin makeOrigin(double latitude, double longitude);
+
+// Output columns for the batch API; null columns are not written
+struct Projection {
+    double *bearing = nullptr;           // Degrees from true north, [0, 360)
+    double *range = nullptr;             // Nautical miles along the great circle
+    double *east = nullptr;              // Azimuthal equidistant plane, NM
+    double *north = nullptr;
+};
+
+// One point, scalar reference
+void bearingRange(const Origin &origin, double latitude, double longitude,
+                  double &bearing, double &range);
+
+// The inverse: the point at a bearing and great-circle range from the
+// origin. Plain libm, for positions the radar measures itself.
+void destination(const Origin &origin, double bearing, double range,
+                 double &latitude, double &longitude);
+
+// Many points from structure-of-arrays input, using the widest
+// instruction set available at run time
+void project(const Origin &origin, const double *latitude, const double *longitude,
+             int count, const Projection &out);
+
+// The same, one point at a time; the reference the batch is checked against
+void projectScalar(const Origin &origin, const double *latitude, const double *longitude,
+                   int count, const Projection &out);
+
+const char *kernelName();
+
+// A projected point: polar for the display, east/north for the plane
+struct Fix {
+    double bearing = 0.0;
+    double range = 0.0;
+    double east = 0.0;
+    double north = 0.0;
+};
+
+// Local tangent plane at the radar. Near the origin east/north come from a
+// second-order expansion of the azimuthal equidistant projection, a few
+// multiply-adds on constants cached here; its error grows with the cube of
+// range. The constructor finds the range at which that error reaches the
+// budget on the worst bearing, and points beyond it take the great-circle
+// path instead.
+class TangentPlane
+{
+public:
+    static constexpr double DEFAULT_ERROR_BUDGET_NM = 0.01;
+
+    explicit TangentPlane(const Origin &origin = Origin(),
+                          double errorBudgetNM = DEFAULT_ERROR_BUDGET_NM);
+
+    const Origin &origin() const { return m_origin; }
+    double errorBudgetNM() const { return m_errorBudgetNM; }
+    double planarLimitNM() const { return m_planarLimitNM; }     // Planar inside this range
+    double maxPlanarErrorNM() const { return m_maxPlanarErrorNM; } // Worst error measured inside it
+
+    // Returns true if the planar expansion was used
+    bool project(double latitude, double longitude, Fix &fix) const;
+
+private:
+    void expand(double latitude, double longitude, double &east, double &north) const;
+    double planarErrorAt(double rangeNM) const;
+
+    Origin m_origin;
+    double m_errorBudgetNM;
+    double m_planarLimitNM;
+    double m_maxPlanarErrorNM;
+
+    // east = dLon * (m_eastScale - m_eastShear * dLat)
+    // north = dLat * EARTH_RADIUS_NM + dLon^2 * m_northBend, angles in radians
+    double m_eastScale;
+    double m_eastShear;
+    double m_northBend;
+    double m_maxLatitudeDelta;           // Radians; cheap reject before the planar range test
+};
+
+} // namespace Geodesy
+
+#endif // GEODESY_H
\ No newline at end of file
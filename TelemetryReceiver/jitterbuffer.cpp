@@ -0,0 +1,124 @@
+#include "jitterbuffer.h"
+#include <cmath>
+
+namespace {
+// Target delay = this many jitter deviations, within [min, max]
+constexpr double JITTER_DELAY_FACTOR = 4.0;
+}
+
+JitterBuffer::JitterBuffer()
+    : m_minDelayMs(200)
+    , m_maxDelayMs(2000)
+    , m_adaptive(true)
+    , m_maxDepth(256)
+    , m_hasBaseline(false)
+    , m_baseTransitMs(0)
+    , m_lastTransitMs(0)
+    , m_jitterMs(0.0)
+    , m_hasReleased(false)
+    , m_lastReleasedSequence(0)
+    , m_latePackets(0)
+    , m_lastArrivalMs(-1)
+{
+}
+
+void JitterBuffer::setPlayoutDelayMs(int delayMs)
+{
+    m_minDelayMs = qMax(0, delayMs);
+    m_maxDelayMs = qMax(m_maxDelayMs, m_minDelayMs);
+}
+
+int JitterBuffer::targetDelayMs() const
+{
+    if (!m_adaptive) {
+        return m_minDelayMs;
+    }
+    int adaptiveDelay = static_cast<int>(std::ceil(JITTER_DELAY_FACTOR * m_jitterMs));
+    return qBound(m_minDelayMs, adaptiveDelay, m_maxDelayMs);
+}
+
+void JitterBuffer::push(const TelemetryPacket &packet, qint64 arrivalMs)
+{
+    m_lastArrivalMs = arrivalMs;
+    
+    // Anything at or behind the playout point has already missed its slot
+    if (m_hasReleased && packet.sequenceNumber <= m_lastReleasedSequence) {
+        m_latePackets++;
+        return;
+    }
+    if (m_pending.contains(packet.sequenceNumber)) {
+        return; // Duplicate (e.g. retransmission of an ACK we lost)
+    }
+
+    // Map the sender clock onto ours. The smallest transit time seen is the
+    // best estimate of the fixed offset; anything above it is queuing delay.
+    qint64 sendMs = packet.timestamp.isValid() ? packet.timestamp.toMSecsSinceEpoch() : arrivalMs;
+    qint64 transitMs = arrivalMs - sendMs;
+
+    if (!m_hasBaseline) {
+        m_hasBaseline = true;
+        m_baseTransitMs = transitMs;
+    } else {
+        // RFC 3550 interarrival jitter: J += (|D| - J) / 16
+        double deviation = std::abs(double(transitMs - m_lastTransitMs));
+        m_jitterMs += (deviation - m_jitterMs) / 16.0;
+        m_baseTransitMs = qMin(m_baseTransitMs, transitMs);
+    }
+    m_lastTransitMs = transitMs;
+
+    Entry entry;
+    entry.packet = packet;
+    entry.playoutMs = sendMs + m_baseTransitMs + targetDelayMs();
+    m_pending.insert(packet.sequenceNumber, entry);
+}
+
+void JitterBuffer::release(QMap<quint32, Entry>::iterator it, QVector<TelemetryPacket> &out)
+{
+    m_hasReleased = true;
+    m_lastReleasedSequence = it.key();
+    out.append(it.value().packet);
+    m_pending.erase(it);
+}
+
+int JitterBuffer::popDue(qint64 nowMs, QVector<TelemetryPacket> &out)
+{
+    int released = 0;
+
+    // Overfull: give up on holding the oldest samples back
+    while (m_pending.size() > m_maxDepth) {
+        release(m_pending.begin(), out);
+        ++released;
+    }
+
+    // Release in sequence order. A later sample never overtakes an earlier
+    // one, so the display only ever moves forward along the track.
+    while (!m_pending.isEmpty() && m_pending.begin().value().playoutMs <= nowMs) {
+        release(m_pending.begin(), out);
+        ++released;
+    }
+    return released;
+}
+
+void JitterBuffer::flush(QVector<TelemetryPacket> &out)
+{
+    while (!m_pending.isEmpty()) {
+        release(m_pending.begin(), out);
+    }
+}
+
+void JitterBuffer::clear()
+{
+    m_pending.clear();
+    m_hasBaseline = false;
+    m_jitterMs = 0.0;
+    m_hasReleased = false;
+    m_lastArrivalMs = -1;
+}
+
+qint64 JitterBuffer::nextDueMs() const
+{
+    if (m_pending.isEmpty()) {
+        return -1;
+    }
+    return m_pending.begin().value().playoutMs;
+}
\ No newline at end of file
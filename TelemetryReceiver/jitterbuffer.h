@@ -0,0 +1,65 @@
+#ifndef JITTERBUFFER_H
+#define JITTERBUFFER_H
+
+#include <QMap>
+#include <QVector>
+#include "telemetrypacket.h"
+
+// Per-track playout buffer. Samples are held for a playout delay measured
+// from their send time, then released in sequence order. In adaptive mode
+// the delay follows the measured interarrival jitter (RFC 3550 estimator).
+class JitterBuffer
+{
+public:
+    JitterBuffer();
+
+    // Configuration
+    void setPlayoutDelayMs(int delayMs);          // Fixed delay, or the floor when adaptive
+    void setMaxPlayoutDelayMs(int delayMs) { m_maxDelayMs = qMax(m_minDelayMs, delayMs); }
+    void setAdaptive(bool adaptive) { m_adaptive = adaptive; }
+    void setMaxDepth(int packets) { m_maxDepth = qMax(1, packets); }
+
+    // Buffering
+    void push(const TelemetryPacket &packet, qint64 arrivalMs);
+    int popDue(qint64 nowMs, QVector<TelemetryPacket> &out);
+    void flush(QVector<TelemetryPacket> &out);
+    void clear();
+
+    // State
+    qint64 nextDueMs() const;                     // -1 when empty
+    int targetDelayMs() const;
+    double jitterMs() const { return m_jitterMs; }
+    int size() const { return m_pending.size(); }
+    qint64 lastArrivalMs() const { return m_lastArrivalMs; }    // -1 before the first sample
+    quint64 latePackets() const { return m_latePackets; }
+
+private:
+    struct Entry {
+        TelemetryPacket packet;
+        qint64 playoutMs;
+    };
+
+    void release(QMap<quint32, Entry>::iterator it, QVector<TelemetryPacket> &out);
+
+    QMap<quint32, Entry> m_pending;               // Ordered by sequence number
+
+    // Playout timing
+    int m_minDelayMs;
+    int m_maxDelayMs;
+    bool m_adaptive;
+    int m_maxDepth;
+
+    // Clock mapping and jitter estimate
+    bool m_hasBaseline;
+    qint64 m_baseTransitMs;                       // Smallest observed arrival - send time
+    qint64 m_lastTransitMs;
+    double m_jitterMs;
+
+    // Ordering
+    bool m_hasReleased;
+    quint32 m_lastReleasedSequence;
+    quint64 m_latePackets;
+    qint64 m_lastArrivalMs;
+};
+
+#endif // JITTERBUFFER_H
\ No newline at end of file
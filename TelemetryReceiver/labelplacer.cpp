@@ -0,0 +1,176 @@
+#include "labelplacer.h"
+#include <cmath>
+
+namespace {
+constexpr double SYMBOL_HALF_SIZE = 8.0;         // Symbol radius plus half its pen
+constexpr double LABEL_GAP = 1.0;                // Kept clear around every obstacle
+}
+
+QPointF LabelPlacer::labelOffset(const QFontMetrics &metrics, int anchor, qreal width)
+{
+    // Clear of the symbol on the anchor's side, as the original label was
+    switch (anchor) {
+    case TrackStore::LabelSouthEast:
+        return QPointF(LABEL_SPACING, SYMBOL_HALF_SIZE);
+    case TrackStore::LabelNorthWest:
+        return QPointF(-LABEL_SPACING - width, -10 - metrics.ascent());
+    case TrackStore::LabelSouthWest:
+        return QPointF(-LABEL_SPACING - width, SYMBOL_HALF_SIZE);
+    default:
+        return QPointF(LABEL_SPACING, -10 - metrics.ascent());
+    }
+}
+
+void LabelPlacer::place(TrackStore &tracks, const QFontMetrics &metrics, double maxRange,
+                        int clusterThreshold, int first, QVector<Change> &changed)
+{
+    // Empty the cells but keep their storage for the next pass
+    for (auto it = m_cells.begin(); it != m_cells.end(); ++it) {
+        it.value().resize(0);
+    }
+    m_population.clear();
+    m_clusterCells.clear();
+    m_order.clear();
+
+    const double *ranges = tracks.ranges().constData();
+    const float *screenX = tracks.screenX().constData();
+    const float *screenY = tracks.screenY().constData();
+    int count = tracks.size();
+
+    // Cells the renderer will draw as one glyph
+    bool clustering = clusterThreshold > 0;
+    if (clustering) {
+        for (int i = 0; i < count; ++i) {
+            if (ranges[i] <= maxRange) {
+                ++m_population[tracks.clusterKey(QPointF(screenX[i], screenY[i]))];
+            }
+        }
+    }
+
+    // Everything drawn besides the labels is an obstacle; labels of
+    // clustered tracks are not drawn at all
+    bool firstDrawn = false;
+    for (int i = 0; i < count; ++i) {
+        if (ranges[i] > maxRange) {
+            continue;
+        }
+        QPointF pos(screenX[i], screenY[i]);
+        if (clustering) {
+            quint64 key = tracks.clusterKey(pos);
+            if (m_population.value(key) > clusterThreshold) {
+                if (!m_clusterCells.contains(key)) {
+                    m_clusterCells.insert(key);
+                    occupy(tracks.clusterCell(pos));
+                }
+                continue;
+            }
+        }
+        occupy(QRectF(pos.x() - SYMBOL_HALF_SIZE, pos.y() - SYMBOL_HALF_SIZE,
+                      SYMBOL_HALF_SIZE * 2, SYMBOL_HALF_SIZE * 2));
+        if (i == first) {
+            firstDrawn = true;
+        } else {
+            m_order.append(i);
+        }
+    }
+
+    if (firstDrawn) {
+        placeLabel(tracks, first, metrics, true, changed);
+    }
+    for (int i : m_order) {
+        placeLabel(tracks, i, metrics, false, changed);
+    }
+
+    // Widths of tracks that are gone; cheap to measure again if they return
+    if (m_widths.size() > 2 * count + 64) {
+        m_widths.clear();
+    }
+}
+
+void LabelPlacer::placeLabel(TrackStore &tracks, int index, const QFontMetrics &metrics,
+                             bool force, QVector<Change> &changed)
+{
+    qint8 previous = tracks.labelAnchors()[index];
+    QPointF pos = tracks.screenPosition(index);
+    qreal width = labelWidth(metrics, tracks.trackIds()[index]);
+    QSizeF size(width, metrics.height());
+
+    // The current corner first, so labels only move when they have to
+    qint8 chosen = TrackStore::LabelHidden;
+    QRectF rect;
+    for (int attempt = -1; attempt < TrackStore::LabelAnchorCount; ++attempt) {
+        int anchor = attempt < 0 ? previous : attempt;
+        if (anchor < 0 || (attempt >= 0 && anchor == previous)) {
+            continue;
+        }
+        rect = QRectF(pos + labelOffset(metrics, anchor, width), size);
+        if (isFree(rect)) {
+            chosen = qint8(anchor);
+            break;
+        }
+    }
+    if (chosen == TrackStore::LabelHidden && force) {
+        chosen = previous >= 0 ? previous : qint8(TrackStore::LabelNorthEast);
+        rect = QRectF(pos + labelOffset(metrics, chosen, width), size);
+    }
+
+    if (chosen != TrackStore::LabelHidden) {
+        occupy(rect);
+    }
+    if (chosen != previous) {
+        tracks.setLabelAnchor(index, chosen);
+        changed.append({index, previous});
+    }
+}
+
+qreal LabelPlacer::labelWidth(const QFontMetrics &metrics, const QString &trackId) const
+{
+    auto it = m_widths.constFind(trackId);
+    if (it == m_widths.constEnd()) {
+        it = m_widths.insert(trackId, metrics.horizontalAdvance(trackId));
+        m_widestLabel = qMax(m_widestLabel, it.value());
+    }
+    return it.value();
+}
+
+bool LabelPlacer::isFree(const QRectF &rect) const
+{
+    int left = int(std::floor(rect.left() / CELL_SIZE));
+    int right = int(std::floor(rect.right() / CELL_SIZE));
+    int top = int(std::floor(rect.top() / CELL_SIZE));
+    int bottom = int(std::floor(rect.bottom() / CELL_SIZE));
+    for (int cy = top; cy <= bottom; ++cy) {
+        for (int cx = left; cx <= right; ++cx) {
+            auto cell = m_cells.constFind(cellKey(cx, cy));
+            if (cell == m_cells.constEnd()) {
+                continue;
+            }
+            if (cell.value().size() >= CELL_LIMIT) {
+                return false; // Too crowded for a readable label anyway
+            }
+            for (const QRectF &obstacle : cell.value()) {
+                if (obstacle.intersects(rect)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void LabelPlacer::occupy(const QRectF &rect)
+{
+    QRectF padded = rect.adjusted(-LABEL_GAP, -LABEL_GAP, LABEL_GAP, LABEL_GAP);
+    int left = int(std::floor(padded.left() / CELL_SIZE));
+    int right = int(std::floor(padded.right() / CELL_SIZE));
+    int top = int(std::floor(padded.top() / CELL_SIZE));
+    int bottom = int(std::floor(padded.bottom() / CELL_SIZE));
+    for (int cy = top; cy <= bottom; ++cy) {
+        for (int cx = left; cx <= right; ++cx) {
+            QVector<QRectF> &cell = m_cells[cellKey(cx, cy)];
+            if (cell.size() < CELL_LIMIT) {
+                cell.append(padded); // A full cell blocks everything, no need to grow it
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef LABELPLACER_H
+#define LABELPLACER_H
+
+#include <QFontMetrics>
+#include <QHash>
+#include <QRectF>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include "trackstore.h"
+
+// Greedy label placement. Every drawn symbol and cluster glyph goes into a
+// screen-space hash first; then each label, in turn, takes the first of
+// its candidate corners that overlaps nothing already placed, or is hidden.
+// Cells that fill up count as blocked, so a candidate costs a bounded
+// number of checks and a pass is linear in the number of contacts.
+class LabelPlacer
+{
+public:
+    static constexpr float CELL_SIZE = 32.0f;    // Hash cell, logical pixels
+    static constexpr int CELL_LIMIT = 12;        // Obstacles in a cell before it counts as full
+
+    struct Change {
+        int index;
+        qint8 previous;                           // Anchor before this pass
+    };
+
+    // Top left of a label of the given width at an anchor, relative to its
+    // contact. North east is where labels were always drawn.
+    static QPointF labelOffset(const QFontMetrics &metrics, int anchor, qreal width);
+
+    // Choose anchors for every track within maxRange that is drawn on its
+    // own, i.e. not inside a cluster. `first` (a slot, or -1) is placed
+    // before all others and is never hidden. Appends the slots whose
+    // anchor changed to changed.
+    void place(TrackStore &tracks, const QFontMetrics &metrics, double maxRange,
+               int clusterThreshold, int first, QVector<Change> &changed);
+
+    // Label widths are cached per track ID; call when the font changes
+    qreal labelWidth(const QFontMetrics &metrics, const QString &trackId) const;
+    void clearWidths() { m_widths.clear(); m_widestLabel = 0.0; }
+
+    // Widest label measured since the font last changed. A label reaches at
+    // most this plus LABEL_SPACING to either side of its contact.
+    qreal widestLabel() const { return m_widestLabel; }
+    static constexpr qreal LABEL_SPACING = 10.0; // Contact to the near edge of its label
+
+private:
+    void placeLabel(TrackStore &tracks, int index, const QFontMetrics &metrics,
+                    bool force, QVector<Change> &changed);
+    bool isFree(const QRectF &rect) const;
+    void occupy(const QRectF &rect);
+    quint64 cellKey(int cx, int cy) const { return (quint64(quint32(cx)) << 32) | quint32(cy); }
+
+    // Reused between passes
+    QHash<quint64, QVector<QRectF>> m_cells;     // Obstacles overlapping each cell
+    QHash<quint64, int> m_population;            // Cluster cell -> tracks in range
+    QSet<quint64> m_clusterCells;                // Cluster glyphs already added
+    QVector<int> m_order;                        // Slots to label, in placement order
+    mutable QHash<QString, qreal> m_widths;      // Track ID -> label width
+    mutable qreal m_widestLabel = 0.0;           // Kept when m_widths is trimmed
+};
+
+#endif // LABELPLACER_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <QApplication>
 #include "mainwindow.h"
+#include "asynclogger.h"
 
 int main(int argc, char *argv[])
 {
@@ -8,5 +9,9 @@ int main(int argc, char *argv[])
     MainWindow window;
     window.show();
 
-    return app.exec();
+    int result = app.exec();
+    
+    // Flush buffered log records before static teardown
+    AsyncLogger::instance().shutdown();
+    return result;
 }
\ No newline at end of file
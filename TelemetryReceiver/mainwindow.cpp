@@ -3,22 +3,28 @@
 #include <QMessageBox>
 #include <QSplitter>
 #include <QGridLayout>
-#include <cmath>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include "asynclogger.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_centralWidget(nullptr)
     , m_radarWidget(nullptr)
     , m_receiver(new TelemetryReceiverSocket(this))
-    , m_reliableReceiver(new ReliableUdpReceiver(this))
+    , m_reliableReceiver(new ReliableUdpReceiver())
+    , m_networkThread(new QThread(this))
+    , m_plotExtractor(new PlotExtractor())
+    , m_detectionThread(new QThread(this))
     , m_packetCount(0)
+    , m_lossSeverity(-1)
+    , m_lastDisplayedSequence(0)
 {
     qRegisterMetaType<TelemetryData>("TelemetryData");
     qRegisterMetaType<TelemetryPacket>("TelemetryPacket");
+    qRegisterMetaType<NetworkStatisticsSnapshot>("NetworkStatisticsSnapshot");
+    qRegisterMetaType<SequenceRange>("SequenceRange");
+    qRegisterMetaType<QVector<TrajectorySample>>("QVector<TrajectorySample>");
+    qRegisterMetaType<QVector<SpokeMessage>>("QVector<SpokeMessage>");
+    qRegisterMetaType<QVector<RadarPlot>>("QVector<RadarPlot>");
     
     setupUI();
     setupStatusBar();
@@ -36,13 +42,39 @@ MainWindow::MainWindow(QWidget *parent)
     // Connect reliable receiver signals
     connect(m_reliableReceiver, &ReliableUdpReceiver::telemetryDataReceived,
             this, &MainWindow::onReliableTelemetryReceived);
+    connect(m_reliableReceiver, &ReliableUdpReceiver::gapDetected,
+            this, &MainWindow::onGapDetected);
     connect(m_reliableReceiver, &ReliableUdpReceiver::connectionStatusChanged,
             this, &MainWindow::onConnectionStatusChanged);
     connect(m_reliableReceiver, &ReliableUdpReceiver::statisticsUpdated,
             this, &MainWindow::onNetworkStatisticsUpdated);
+    connect(m_reliableReceiver, &ReliableUdpReceiver::spokesReceived,
+            m_radarWidget, &RadarWidget::addSpokes);
+    connect(m_reliableReceiver, &ReliableUdpReceiver::spokesReceived,
+            m_plotExtractor, &PlotExtractor::processSpokes);
+    connect(m_plotExtractor, &PlotExtractor::plotsExtracted,
+            m_radarWidget, &RadarWidget::addPlots);
+    
+    // The reliable receiver runs as an actor on its own thread; signals
+    // reach the GUI through queued connections.
+    m_networkThread->setObjectName("ReliableUdpReceiver");
+    m_reliableReceiver->moveToThread(m_networkThread);
+    connect(m_networkThread, &QThread::finished, m_reliableReceiver, &QObject::deleteLater);
+    m_networkThread->start();
+    
+    // Detection gets a thread of its own so a dense picture cannot hold up
+    // the receiver's acknowledgements
+    m_detectionThread->setObjectName("PlotExtractor");
+    m_plotExtractor->moveToThread(m_detectionThread);
+    connect(m_detectionThread, &QThread::finished, m_plotExtractor, &QObject::deleteLater);
+    m_detectionThread->start();
     
     // Start listening with reliable receiver
-    if (m_reliableReceiver->startListening(12345)) {
+    bool listening = false;
+    ReliableUdpReceiver *receiver = m_reliableReceiver;
+    QMetaObject::invokeMethod(receiver, [receiver]() { return receiver->startListening(12345); },
+                              Qt::BlockingQueuedConnection, &listening);
+    if (listening) {
         m_connectionStatusLabel->setText("Status: Reliable UDP listening on port 12345");
         m_connectionStatusLabel->setStyleSheet("color: green; font-weight: bold;");
     } else {
@@ -51,7 +83,17 @@ MainWindow::MainWindow(QWidget *parent)
     }
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow()
+{
+    // Stop on the owning thread, then let the thread delete the receiver
+    ReliableUdpReceiver *receiver = m_reliableReceiver;
+    QMetaObject::invokeMethod(receiver, [receiver]() { receiver->stopListening(); },
+                              Qt::BlockingQueuedConnection);
+    m_networkThread->quit();
+    m_networkThread->wait();
+    m_detectionThread->quit();
+    m_detectionThread->wait();
+}
 
 void MainWindow::setupUI()
 {
@@ -75,6 +117,8 @@ void MainWindow::setupUI()
     // Connect radar signals
     connect(m_radarWidget, &RadarWidget::rangeChanged,
             this, &MainWindow::onRadarRangeChanged);
+    connect(m_radarWidget, &RadarWidget::contactSelected,
+            this, &MainWindow::onContactSelected);
     
     // Right panel - Controls and data display
     auto *rightPanel = new QWidget(this);
@@ -87,12 +131,12 @@ void MainWindow::setupUI()
     
     radarLayout->addWidget(new QLabel("Range (NM):", this), 0, 0);
     m_rangeSpinBox = new QDoubleSpinBox(this);
-    m_rangeSpinBox->setRange(50.0, 1000.0);
-    m_rangeSpinBox->setValue(500.0);
+    m_rangeSpinBox->setRange(0.5, 1000.0);
+    m_rangeSpinBox->setValue(m_radarWidget->getRange());
     m_rangeSpinBox->setSingleStep(0.5);
     m_rangeSpinBox->setSuffix(" NM");
     connect(m_rangeSpinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
-            this, &MainWindow::onRadarRangeChanged);
+            m_radarWidget, &RadarWidget::setRange);
     radarLayout->addWidget(m_rangeSpinBox, 0, 1);
     
     radarLayout->addWidget(new QLabel("Sweep Speed:", this), 1, 0);
@@ -109,8 +153,153 @@ void MainWindow::setupUI()
             this, &MainWindow::onSweepToggled);
     radarLayout->addWidget(m_sweepEnabledCheckBox, 2, 0, 1, 2);
     
+    m_trailsCheckBox = new QCheckBox("Show Trails", this);
+    m_trailsCheckBox->setChecked(true);
+    connect(m_trailsCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setTrailsEnabled);
+    radarLayout->addWidget(m_trailsCheckBox, 3, 0, 1, 2);
+    
+    m_afterglowCheckBox = new QCheckBox("Phosphor Afterglow", this);
+    m_afterglowCheckBox->setChecked(true);
+    connect(m_afterglowCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setAfterglowEnabled);
+    radarLayout->addWidget(m_afterglowCheckBox, 4, 0, 1, 2);
+    
+    radarLayout->addWidget(new QLabel("Frame Rate:", this), 5, 0);
+    m_frameRateSpinBox = new QSpinBox(this);
+    m_frameRateSpinBox->setRange(5, 120);
+    m_frameRateSpinBox->setValue(m_radarWidget->targetFrameRate());
+    m_frameRateSpinBox->setSuffix(" FPS");
+    connect(m_frameRateSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            m_radarWidget, &RadarWidget::setTargetFrameRate);
+    radarLayout->addWidget(m_frameRateSpinBox, 5, 1);
+    
+    // Keeps the GUI thread free for input and ingest however many contacts
+    m_threadedRenderingCheckBox = new QCheckBox("Render on Background Thread", this);
+    m_threadedRenderingCheckBox->setChecked(true);
+    m_radarWidget->setThreadedRendering(true);
+    connect(m_threadedRenderingCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setThreadedRendering);
+    radarLayout->addWidget(m_threadedRenderingCheckBox, 6, 0, 1, 2);
+    
+    // Radar position and how far out contacts may use the planar shortcut
+    radarLayout->addWidget(new QLabel("Radar Latitude:", this), 7, 0);
+    m_originLatitudeSpinBox = new QDoubleSpinBox(this);
+    m_originLatitudeSpinBox->setRange(-90.0, 90.0);
+    m_originLatitudeSpinBox->setDecimals(4);
+    m_originLatitudeSpinBox->setValue(m_radarWidget->origin().latitude);
+    m_originLatitudeSpinBox->setSuffix("°");
+    radarLayout->addWidget(m_originLatitudeSpinBox, 7, 1);
+    
+    radarLayout->addWidget(new QLabel("Radar Longitude:", this), 8, 0);
+    m_originLongitudeSpinBox = new QDoubleSpinBox(this);
+    m_originLongitudeSpinBox->setRange(-180.0, 180.0);
+    m_originLongitudeSpinBox->setDecimals(4);
+    m_originLongitudeSpinBox->setValue(m_radarWidget->origin().longitude);
+    m_originLongitudeSpinBox->setSuffix("°");
+    radarLayout->addWidget(m_originLongitudeSpinBox, 8, 1);
+    
+    radarLayout->addWidget(new QLabel("Planar Error Budget:", this), 9, 0);
+    m_planarBudgetSpinBox = new QDoubleSpinBox(this);
+    m_planarBudgetSpinBox->setRange(0.001, 1.0);
+    m_planarBudgetSpinBox->setDecimals(3);
+    m_planarBudgetSpinBox->setSingleStep(0.005);
+    m_planarBudgetSpinBox->setValue(m_radarWidget->planarErrorBudget());
+    m_planarBudgetSpinBox->setSuffix(" NM");
+    radarLayout->addWidget(m_planarBudgetSpinBox, 9, 1);
+    
+    m_projectionLabel = new QLabel(this);
+    radarLayout->addWidget(m_projectionLabel, 10, 0, 1, 2);
+    
+    for (QDoubleSpinBox *spinBox : {m_originLatitudeSpinBox, m_originLongitudeSpinBox, m_planarBudgetSpinBox}) {
+        connect(spinBox, static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+                this, &MainWindow::onProjectionSettingsChanged);
+    }
+    onProjectionSettingsChanged();
+    
+    // Crowded cells collapse into one counted glyph when zoomed out
+    radarLayout->addWidget(new QLabel("Cluster Above:", this), 11, 0);
+    m_clusterThresholdSpinBox = new QSpinBox(this);
+    m_clusterThresholdSpinBox->setRange(0, 50);
+    m_clusterThresholdSpinBox->setSpecialValueText("Off");
+    m_clusterThresholdSpinBox->setValue(m_radarWidget->clusterThreshold());
+    m_clusterThresholdSpinBox->setSuffix(" contacts");
+    connect(m_clusterThresholdSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            m_radarWidget, &RadarWidget::setClusterThreshold);
+    radarLayout->addWidget(m_clusterThresholdSpinBox, 11, 1);
+    
+    m_metricsOverlayCheckBox = new QCheckBox("Show Frame Metrics", this);
+    m_metricsOverlayCheckBox->setChecked(false);
+    connect(m_metricsOverlayCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setMetricsOverlayVisible);
+    radarLayout->addWidget(m_metricsOverlayCheckBox, 12, 0, 1, 2);
+    
+    // Trade overlay detail for frame rate when frames run over budget
+    m_adaptiveQualityCheckBox = new QCheckBox("Adaptive Render Quality", this);
+    m_adaptiveQualityCheckBox->setChecked(m_radarWidget->adaptiveQuality());
+    connect(m_adaptiveQualityCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setAdaptiveQuality);
+    radarLayout->addWidget(m_adaptiveQualityCheckBox, 13, 0, 1, 2);
+    
+    // Raw video from spoke streams, under the contacts
+    m_radarVideoCheckBox = new QCheckBox("Radar Video", this);
+    m_radarVideoCheckBox->setChecked(m_radarWidget->radarVideoEnabled());
+    connect(m_radarVideoCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setRadarVideoEnabled);
+    radarLayout->addWidget(m_radarVideoCheckBox, 14, 0);
+    
+    m_scanAveragingCheckBox = new QCheckBox("Scan Averaging", this);
+    m_scanAveragingCheckBox->setChecked(true);
+    connect(m_scanAveragingCheckBox, &QCheckBox::toggled,
+            m_radarWidget, &RadarWidget::setScanAveraging);
+    radarLayout->addWidget(m_scanAveragingCheckBox, 14, 1);
+    
+    // Targets found in the video become "R" contacts
+    m_plotExtractionCheckBox = new QCheckBox("Plot Extraction", this);
+    m_plotExtractionCheckBox->setChecked(m_plotExtractor->isEnabled());
+    connect(m_plotExtractionCheckBox, &QCheckBox::toggled,
+            m_plotExtractor, &PlotExtractor::setEnabled);
+    radarLayout->addWidget(m_plotExtractionCheckBox, 15, 0);
+    
+    m_cfarModeComboBox = new QComboBox(this);
+    m_cfarModeComboBox->addItem("CA-CFAR");  // Index is the CfarDetector::Mode
+    m_cfarModeComboBox->addItem("OS-CFAR");
+    connect(m_cfarModeComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            m_plotExtractor, &PlotExtractor::setCfarMode);
+    radarLayout->addWidget(m_cfarModeComboBox, 15, 1);
+    
     rightLayout->addWidget(radarGroup);
     
+    // Playout smoothing group
+    auto *playoutGroup = new QGroupBox("Playout Smoothing", this);
+    auto *playoutLayout = new QGridLayout(playoutGroup);
+    
+    m_jitterBufferCheckBox = new QCheckBox("Jitter Buffer", this);
+    m_jitterBufferCheckBox->setChecked(false);
+    connect(m_jitterBufferCheckBox, &QCheckBox::toggled,
+            this, &MainWindow::onJitterBufferToggled);
+    playoutLayout->addWidget(m_jitterBufferCheckBox, 0, 0);
+    
+    m_adaptivePlayoutCheckBox = new QCheckBox("Adaptive", this);
+    m_adaptivePlayoutCheckBox->setChecked(true);
+    m_adaptivePlayoutCheckBox->setEnabled(false);
+    connect(m_adaptivePlayoutCheckBox, &QCheckBox::toggled,
+            this, &MainWindow::onAdaptivePlayoutToggled);
+    playoutLayout->addWidget(m_adaptivePlayoutCheckBox, 0, 1);
+    
+    playoutLayout->addWidget(new QLabel("Playout Delay:", this), 1, 0);
+    m_playoutDelaySpinBox = new QSpinBox(this);
+    m_playoutDelaySpinBox->setRange(0, 2000);
+    m_playoutDelaySpinBox->setValue(200);
+    m_playoutDelaySpinBox->setSingleStep(50);
+    m_playoutDelaySpinBox->setSuffix(" ms");
+    m_playoutDelaySpinBox->setEnabled(false);
+    connect(m_playoutDelaySpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onPlayoutDelayChanged);
+    playoutLayout->addWidget(m_playoutDelaySpinBox, 1, 1);
+    
+    rightLayout->addWidget(playoutGroup);
+    
     // Telemetry data group
     auto *dataGroup = new QGroupBox("Current Contact Data", this);
     auto *dataLayout = new QGridLayout(dataGroup);
@@ -284,7 +473,7 @@ void MainWindow::clearRecording()
 {
     m_receiver->clearRecording();
     m_playbackButton->setEnabled(false);
-    m_radarWidget->clearContact();
+    m_radarWidget->clearContacts();
 }
 
 void MainWindow::onRadarRangeChanged(double range)
@@ -294,6 +483,30 @@ void MainWindow::onRadarRangeChanged(double range)
     m_rangeSpinBox->blockSignals(false);
 }
 
+void MainWindow::onContactSelected(const RadarContact &contact)
+{
+    statusBar()->showMessage(QString("Selected %1: bearing %2°, range %3 NM")
+                             .arg(contact.trackId)
+                             .arg(contact.bearing, 0, 'f', 1)
+                             .arg(contact.range, 0, 'f', 1), 5000);
+}
+
+void MainWindow::onProjectionSettingsChanged()
+{
+    const Geodesy::Origin &origin = m_radarWidget->origin();
+    if (origin.latitude != m_originLatitudeSpinBox->value()
+        || origin.longitude != m_originLongitudeSpinBox->value()) {
+        m_radarWidget->setOrigin(m_originLatitudeSpinBox->value(), m_originLongitudeSpinBox->value());
+    }
+    if (m_radarWidget->planarErrorBudget() != m_planarBudgetSpinBox->value()) {
+        m_radarWidget->setPlanarErrorBudget(m_planarBudgetSpinBox->value());
+    }
+    
+    m_projectionLabel->setText(QString("Planar within %1 NM, max error %2 NM")
+                               .arg(m_radarWidget->planarLimitNM(), 0, 'f', 1)
+                               .arg(m_radarWidget->maxPlanarErrorNM(), 0, 'f', 4));
+}
+
 void MainWindow::onSweepSpeedChanged(int rpm)
 {
     m_radarWidget->setSweepSpeed(rpm);
@@ -304,10 +517,32 @@ void MainWindow::onSweepToggled(bool enabled)
     m_radarWidget->toggleSweep(enabled);
 }
 
+void MainWindow::onJitterBufferToggled(bool enabled)
+{
+    m_playoutDelaySpinBox->setEnabled(enabled);
+    m_adaptivePlayoutCheckBox->setEnabled(enabled);
+    
+    // Push the current settings first so the first buffered sample uses them
+    m_reliableReceiver->setPlayoutDelayMs(m_playoutDelaySpinBox->value());
+    m_reliableReceiver->setAdaptivePlayoutEnabled(m_adaptivePlayoutCheckBox->isChecked());
+    m_reliableReceiver->setTrackTimeoutMs(m_radarWidget->getContactTimeoutMs());
+    m_reliableReceiver->setJitterBufferEnabled(enabled);
+}
+
+void MainWindow::onPlayoutDelayChanged(int delayMs)
+{
+    m_reliableReceiver->setPlayoutDelayMs(delayMs);
+}
+
+void MainWindow::onAdaptivePlayoutToggled(bool enabled)
+{
+    m_reliableReceiver->setAdaptivePlayoutEnabled(enabled);
+}
+
 void MainWindow::onReliableTelemetryReceived(const TelemetryPacket &packet)
 {
     try {
-        qDebug() << "Received telemetry packet:" << packet.sequenceNumber;
+        TLOG_TRACE("Receiver", "Received telemetry packet {}", packet.sequenceNumber);
         
         // Convert TelemetryPacket to TelemetryData for compatibility
         TelemetryData data;
@@ -315,31 +550,59 @@ void MainWindow::onReliableTelemetryReceived(const TelemetryPacket &packet)
         data.longitude = packet.longitude;
         data.speed = packet.speed;
         data.status = packet.status;
+        data.trackId = packet.trackId;
         
         m_lastData = data;
+        m_lastDisplayedSequence = qMax(m_lastDisplayedSequence, packet.sequenceNumber);
         m_packetCount++;
         
-        qDebug() << "Updating telemetry display...";
         updateTelemetryDisplay(data);
         
-        qDebug() << "Adding telemetry contact to radar...";
         if (m_radarWidget) {
             m_radarWidget->addTelemetryContact(data);
         }
         
-        qDebug() << "Updating packet count label...";
         if (m_packetCountLabel) {
             m_packetCountLabel->setText(QString("Packets: %1").arg(m_packetCount));
         }
-        
-        qDebug() << "Telemetry packet processing completed successfully";
     } catch (const std::exception& e) {
-        qDebug() << "Exception in onReliableTelemetryReceived:" << e.what();
+        TLOG_ERROR("Receiver", "Exception in onReliableTelemetryReceived: {}", e.what());
     } catch (...) {
-        qDebug() << "Unknown exception in onReliableTelemetryReceived";
+        TLOG_ERROR("Receiver", "Unknown exception in onReliableTelemetryReceived");
     }
 }
 
+void MainWindow::onGapDetected(const QString &trackId, const SequenceRange &range,
+                               const QVector<TrajectorySample> &trajectory)
+{
+    TLOG_DEBUG("Receiver", "Gap on {}: {}-{} ({} samples)",
+               trackId, range.first, range.last, trajectory.size());
+    
+    m_packetCount += range.count();
+    m_packetCountLabel->setText(QString("Packets: %1").arg(m_packetCount));
+    
+    if (trajectory.isEmpty()) {
+        return;
+    }
+    
+    // A gap is only resolved after newer packets have arrived, so normally
+    // the display has already moved past it and the segment only fills in
+    // the trail behind the contact. A segment still ahead of what is shown
+    // also moves the contact to where it ends.
+    if (range.last > m_lastDisplayedSequence) {
+        const TrajectorySample &latest = trajectory.last();
+        TelemetryData data(latest.latitude, latest.longitude, latest.speed,
+                           latest.interpolated ? "INTERPOLATED" : "LAST_KNOWN", trackId);
+        m_lastData = data;
+        m_lastDisplayedSequence = range.last;
+        updateTelemetryDisplay(data);
+        m_radarWidget->addTelemetryContact(data);
+        m_radarWidget->addTrajectory(trackId, trajectory.mid(0, trajectory.size() - 1));
+        return;
+    }
+    m_radarWidget->addTrajectory(trackId, trajectory);
+}
+
 void MainWindow::onConnectionStatusChanged(bool connected)
 {
     if (connected) {
@@ -351,21 +614,33 @@ void MainWindow::onConnectionStatusChanged(bool connected)
     }
 }
 
-void MainWindow::onNetworkStatisticsUpdated()
+void MainWindow::onNetworkStatisticsUpdated(const NetworkStatisticsSnapshot &snapshot)
 {
-    int received = m_reliableReceiver->getPacketsReceived();
-    int lost = m_reliableReceiver->getPacketsLost();
-    int interpolated = m_reliableReceiver->getPacketsInterpolated();
-    double lossRate = m_reliableReceiver->getPacketLossRate();
-    
-    m_networkStatsLabel->setText(QString("Rx: %1").arg(received));
-    m_packetLossLabel->setText(QString("Loss: %1%").arg(lossRate, 0, 'f', 1));
-    m_interpolationLabel->setText(QString("Interp: %1").arg(interpolated));
+    double lossRate = snapshot.lossRate;
+    
+    m_networkStatsLabel->setText(QString("Rx: %1 (%2 pkt/s, %3 kB/s)")
+                                 .arg(snapshot.packetsReceived)
+                                 .arg(snapshot.packetsPerSecond, 0, 'f', 1)
+                                 .arg(snapshot.bytesPerSecond / 1024.0, 0, 'f', 1)
+                                 + (snapshot.spokesReceived > 0
+                                    ? QString(" | Video: %1 spokes, %2 lost")
+                                      .arg(snapshot.spokesReceived).arg(snapshot.spokesLost)
+                                    : QString()));
+    m_packetLossLabel->setText(QString("Loss: %1% (%2/s)")
+                               .arg(lossRate, 0, 'f', 1)
+                               .arg(snapshot.lossPerSecond, 0, 'f', 1));
+    m_interpolationLabel->setText(QString("Interp: %1").arg(snapshot.packetsInterpolated));
+    
+    // Update colors based on loss rate, restyling only when the band changes
+    int severity = (lossRate < 1.0) ? 0 : (lossRate < 5.0) ? 1 : 2;
+    if (severity == m_lossSeverity) {
+        return;
+    }
+    m_lossSeverity = severity;
     
-    // Update colors based on loss rate
-    if (lossRate < 1.0) {
+    if (severity == 0) {
         m_packetLossLabel->setStyleSheet("color: green; font-weight: bold;");
-    } else if (lossRate < 5.0) {
+    } else if (severity == 1) {
         m_packetLossLabel->setStyleSheet("color: orange; font-weight: bold;");
     } else {
         m_packetLossLabel->setStyleSheet("color: red; font-weight: bold;");
@@ -379,23 +654,9 @@ void MainWindow::updateTelemetryDisplay(const TelemetryData &data)
                                .arg(data.latitude, 0, 'f', 6)
                                .arg(data.longitude, 0, 'f', 6));
     
-    // Calculate bearing and range from radar center (center of telemetry area)
-    double radarLat = 39.0;  // Center of 36-42 latitude range
-    double radarLon = 35.5;  // Center of 26-45 longitude range
-    
-    double dLon = (data.longitude - radarLon) * M_PI / 180.0;
-    double lat1Rad = radarLat * M_PI / 180.0;
-    double lat2Rad = data.latitude * M_PI / 180.0;
-    
-    double y = sin(dLon) * cos(lat2Rad);
-    double x = cos(lat1Rad) * sin(lat2Rad) - sin(lat1Rad) * cos(lat2Rad) * cos(dLon);
-    double bearing = atan2(y, x) * 180.0 / M_PI;
-    bearing = fmod(bearing + 360.0, 360.0);
-    
-    double dLat = (data.latitude - radarLat) * M_PI / 180.0;
-    double a = sin(dLat/2) * sin(dLat/2) + cos(lat1Rad) * cos(lat2Rad) * sin(dLon/2) * sin(dLon/2);
-    double c = 2 * atan2(sqrt(a), sqrt(1-a));
-    double rangeNM = 3440.065 * c; // Earth radius in nautical miles
+    // Bearing and range from the radar's own origin, so both views agree
+    double bearing, rangeNM;
+    Geodesy::bearingRange(m_radarWidget->origin(), data.latitude, data.longitude, bearing, rangeNM);
     
     m_bearingLabel->setText(QString("%1°").arg(bearing, 0, 'f', 1));
     m_rangeLabel->setText(QString("%1 NM").arg(rangeNM, 0, 'f', 2));
@@ -9,14 +9,17 @@
 #include <QSlider>
 #include <QDoubleSpinBox>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QStatusBar>
 #include <QTimer>
+#include <QThread>
 #include "telemetryreceiversocket.h"
 #include "radarwidget.h"
 #include "reliableudp.h"
+#include "plotextractor.h"
 
 QT_BEGIN_NAMESPACE
 class QLabel;
@@ -42,11 +45,18 @@ private slots:
     void stopPlayback();
     void clearRecording();
     void onRadarRangeChanged(double range);
+    void onContactSelected(const RadarContact &contact);
     void onSweepSpeedChanged(int rpm);
     void onSweepToggled(bool enabled);
+    void onProjectionSettingsChanged();
     void onReliableTelemetryReceived(const TelemetryPacket &packet);
+    void onGapDetected(const QString &trackId, const SequenceRange &range,
+                       const QVector<TrajectorySample> &trajectory);
     void onConnectionStatusChanged(bool connected);
-    void onNetworkStatisticsUpdated();
+    void onNetworkStatisticsUpdated(const NetworkStatisticsSnapshot &snapshot);
+    void onJitterBufferToggled(bool enabled);
+    void onPlayoutDelayChanged(int delayMs);
+    void onAdaptivePlayoutToggled(bool enabled);
 
 private:
     void setupUI();
@@ -68,6 +78,26 @@ private:
     QDoubleSpinBox *m_rangeSpinBox;
     QSlider *m_sweepSpeedSlider;
     QCheckBox *m_sweepEnabledCheckBox;
+    QCheckBox *m_trailsCheckBox;
+    QCheckBox *m_afterglowCheckBox;
+    QSpinBox *m_clusterThresholdSpinBox;
+    QCheckBox *m_metricsOverlayCheckBox;
+    QCheckBox *m_adaptiveQualityCheckBox;
+    QCheckBox *m_radarVideoCheckBox;
+    QCheckBox *m_scanAveragingCheckBox;
+    QCheckBox *m_plotExtractionCheckBox;
+    QComboBox *m_cfarModeComboBox;
+    QSpinBox *m_frameRateSpinBox;
+    QCheckBox *m_threadedRenderingCheckBox;
+    QDoubleSpinBox *m_originLatitudeSpinBox;
+    QDoubleSpinBox *m_originLongitudeSpinBox;
+    QDoubleSpinBox *m_planarBudgetSpinBox;
+    QLabel *m_projectionLabel;
+    
+    // Playout smoothing controls
+    QCheckBox *m_jitterBufferCheckBox;
+    QSpinBox *m_playoutDelaySpinBox;
+    QCheckBox *m_adaptivePlayoutCheckBox;
     
     // Control buttons
     QPushButton *m_recordButton;
@@ -84,6 +114,9 @@ private:
     // Telemetry receivers
     TelemetryReceiverSocket *m_receiver;        // Legacy receiver
     ReliableUdpReceiver *m_reliableReceiver;    // New reliable receiver
+    QThread *m_networkThread;                   // Owns the reliable receiver
+    PlotExtractor *m_plotExtractor;             // CFAR and clustering on spokes
+    QThread *m_detectionThread;                 // Owns the plot extractor
     
     // Network statistics labels
     QLabel *m_networkStatsLabel;
@@ -92,6 +125,8 @@ private:
     
     // Statistics
     int m_packetCount;
+    int m_lossSeverity;     // Last colour band applied to the loss label
+    quint32 m_lastDisplayedSequence;
     
     // Last received data
     TelemetryData m_lastData;
@@ -0,0 +1,93 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free multi-producer / single-consumer queue.
+// Any thread may push; only the owning thread may pop.
+template<typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity = 4096)
+        : m_enqueuePos(0)
+        , m_dequeuePos(0)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false when the queue is full
+    bool push(T value)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only
+    bool pop(T &value)
+    {
+        Cell *cell = &m_cells[m_dequeuePos & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (std::ptrdiff_t(sequence) - std::ptrdiff_t(m_dequeuePos + 1) < 0) {
+            return false;
+        }
+
+        value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    // Consumer side only: whether pop() would fail right now
+    bool isEmpty() const
+    {
+        size_t sequence = m_cells[m_dequeuePos & m_mask].sequence.load(std::memory_order_acquire);
+        return std::ptrdiff_t(sequence) - std::ptrdiff_t(m_dequeuePos + 1) < 0;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+    alignas(64) size_t m_dequeuePos;
+};
+
+#endif // MPSCQUEUE_H
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "networkstatistics.h"
+
+NetworkStatistics::NetworkStatistics(QObject *parent)
+    : QObject(parent)
+    , m_publishTimer(new QTimer(this))
+    , m_windowMs(2000)
+    , m_hasPublished(false)
+    , m_packetsPerSecond(0.0)
+    , m_bytesPerSecond(0.0)
+    , m_lossPerSecond(0.0)
+    , m_publishedWindowMs(0)
+{
+    for (auto &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    m_publishTimer->setInterval(250); // 4 Hz
+    connect(m_publishTimer, &QTimer::timeout, this, &NetworkStatistics::publish);
+
+    m_clock.start();
+}
+
+void NetworkStatistics::setPublishIntervalMs(int intervalMs)
+{
+    m_publishTimer->setInterval(qMax(10, intervalMs));
+}
+
+void NetworkStatistics::start()
+{
+    if (!m_publishTimer->isActive()) {
+        m_publishTimer->start();
+    }
+}
+
+void NetworkStatistics::stop()
+{
+    m_publishTimer->stop();
+
+    // Flush whatever accumulated since the last tick
+    publish();
+}
+
+NetworkStatisticsSnapshot NetworkStatistics::totals() const
+{
+    NetworkStatisticsSnapshot snapshot;
+    snapshot.packetsReceived = value(PacketsReceived);
+    snapshot.packetsSent = value(PacketsSent);
+    snapshot.packetsLost = value(PacketsLost);
+    snapshot.packetsInterpolated = value(PacketsInterpolated);
+    snapshot.acksSent = value(AcksSent);
+    snapshot.acksReceived = value(AcksReceived);
+    snapshot.retransmissions = value(Retransmissions);
+    snapshot.bytesReceived = value(BytesReceived);
+    snapshot.bytesSent = value(BytesSent);
+    snapshot.spokesReceived = value(SpokesReceived);
+    snapshot.spokesLost = value(SpokesLost);
+    snapshot.spokesSent = value(SpokesSent);
+
+    // Receivers count arrivals plus gaps, senders count what they put on the wire
+    quint64 total = qMax(snapshot.packetsReceived + snapshot.packetsLost, snapshot.packetsSent);
+    snapshot.lossRate = total > 0 ? (double(snapshot.packetsLost) / total) * 100.0 : 0.0;
+    return snapshot;
+}
+
+NetworkStatisticsSnapshot NetworkStatistics::snapshot() const
+{
+    NetworkStatisticsSnapshot snapshot = totals();
+    snapshot.packetsPerSecond = m_packetsPerSecond.load(std::memory_order_relaxed);
+    snapshot.bytesPerSecond = m_bytesPerSecond.load(std::memory_order_relaxed);
+    snapshot.lossPerSecond = m_lossPerSecond.load(std::memory_order_relaxed);
+    snapshot.windowMs = m_publishedWindowMs.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void NetworkStatistics::publish()
+{
+    NetworkStatisticsSnapshot snapshot = totals();
+
+    WindowSample sample;
+    sample.elapsedMs = m_clock.elapsed();
+    sample.packets = snapshot.packetsReceived + snapshot.packetsSent;
+    sample.bytes = snapshot.bytesReceived + snapshot.bytesSent;
+    sample.lost = snapshot.packetsLost;
+    m_window.append(sample);
+
+    // Drop samples that fell out of the window, keeping one as the baseline
+    int expired = 0;
+    while (expired + 1 < m_window.size() &&
+           sample.elapsedMs - m_window[expired + 1].elapsedMs >= m_windowMs) {
+        ++expired;
+    }
+    if (expired > 0) {
+        m_window.remove(0, expired);
+    }
+
+    const WindowSample &oldest = m_window.first();
+    qint64 spanMs = sample.elapsedMs - oldest.elapsedMs;
+    if (spanMs > 0) {
+        double seconds = spanMs / 1000.0;
+        snapshot.packetsPerSecond = (sample.packets - oldest.packets) / seconds;
+        snapshot.bytesPerSecond = (sample.bytes - oldest.bytes) / seconds;
+        snapshot.lossPerSecond = (sample.lost - oldest.lost) / seconds;
+    }
+    snapshot.windowMs = spanMs;
+
+    // Nothing moved and the rates have already settled - skip the UI work
+    bool unchanged = m_hasPublished &&
+                     snapshot.packetsReceived == m_lastPublished.packetsReceived &&
+                     snapshot.packetsSent == m_lastPublished.packetsSent &&
+                     snapshot.packetsLost == m_lastPublished.packetsLost &&
+                     snapshot.packetsInterpolated == m_lastPublished.packetsInterpolated &&
+                     snapshot.acksSent == m_lastPublished.acksSent &&
+                     snapshot.acksReceived == m_lastPublished.acksReceived &&
+                     snapshot.retransmissions == m_lastPublished.retransmissions &&
+                     snapshot.spokesReceived == m_lastPublished.spokesReceived &&
+                     snapshot.spokesLost == m_lastPublished.spokesLost &&
+                     snapshot.spokesSent == m_lastPublished.spokesSent &&
+                     snapshot.packetsPerSecond == m_lastPublished.packetsPerSecond &&
+                     snapshot.bytesPerSecond == m_lastPublished.bytesPerSecond &&
+                     snapshot.lossPerSecond == m_lastPublished.lossPerSecond;
+
+    m_lastPublished = snapshot;
+    m_hasPublished = true;
+    m_packetsPerSecond.store(snapshot.packetsPerSecond, std::memory_order_relaxed);
+    m_bytesPerSecond.store(snapshot.bytesPerSecond, std::memory_order_relaxed);
+    m_lossPerSecond.store(snapshot.lossPerSecond, std::memory_order_relaxed);
+    m_publishedWindowMs.store(snapshot.windowMs, std::memory_order_relaxed);
+
+    if (!unchanged) {
+        emit snapshotPublished(snapshot);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef NETWORKSTATISTICS_H
+#define NETWORKSTATISTICS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QMetaType>
+#include <array>
+#include <atomic>
+
+// Point-in-time view of the link counters, published at a fixed rate
+struct NetworkStatisticsSnapshot {
+    // Totals since the counters were created
+    quint64 packetsReceived;
+    quint64 packetsSent;
+    quint64 packetsLost;
+    quint64 packetsInterpolated;
+    quint64 acksSent;
+    quint64 acksReceived;
+    quint64 retransmissions;
+    quint64 bytesReceived;
+    quint64 bytesSent;
+    quint64 spokesReceived;  // Radar video, which is not acknowledged or retransmitted
+    quint64 spokesLost;
+    quint64 spokesSent;
+
+    // Rates over the sliding window
+    double packetsPerSecond;
+    double bytesPerSecond;
+    double lossPerSecond;
+
+    double lossRate;         // Percentage of packets lost since start
+    qint64 windowMs;         // Span actually covered by the rates
+
+    NetworkStatisticsSnapshot()
+        : packetsReceived(0), packetsSent(0), packetsLost(0), packetsInterpolated(0)
+        , acksSent(0), acksReceived(0), retransmissions(0), bytesReceived(0), bytesSent(0)
+        , spokesReceived(0), spokesLost(0), spokesSent(0)
+        , packetsPerSecond(0), bytesPerSecond(0), lossPerSecond(0), lossRate(0), windowMs(0) {}
+};
+
+Q_DECLARE_METATYPE(NetworkStatisticsSnapshot)
+
+// Lock-free counter aggregation with coalesced publication.
+// Hot paths only bump relaxed atomics; a timer turns them into a snapshot.
+class NetworkStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Counter {
+        PacketsReceived,
+        PacketsSent,
+        PacketsLost,
+        PacketsInterpolated,
+        AcksSent,
+        AcksReceived,
+        Retransmissions,
+        BytesReceived,
+        BytesSent,
+        SpokesReceived,
+        SpokesLost,
+        SpokesSent,
+        CounterCount
+    };
+
+    explicit NetworkStatistics(QObject *parent = nullptr);
+
+    void add(Counter counter, quint64 amount = 1)
+    {
+        m_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    quint64 value(Counter counter) const
+    {
+        return m_counters[counter].load(std::memory_order_relaxed);
+    }
+
+    // Publication settings
+    void setPublishIntervalMs(int intervalMs);
+    void setWindowMs(int windowMs) { m_windowMs = qMax(1, windowMs); }
+    int publishIntervalMs() const { return m_publishTimer->interval(); }
+    int windowMs() const { return m_windowMs; }
+
+    void start();
+    void stop();
+
+    // Builds a snapshot from the current counters (rates from the last
+    // publish). Safe from any thread; the rates may straddle two publishes.
+    NetworkStatisticsSnapshot snapshot() const;
+
+signals:
+    void snapshotPublished(const NetworkStatisticsSnapshot &snapshot);
+
+private slots:
+    void publish();
+
+private:
+    struct WindowSample {
+        qint64 elapsedMs;
+        quint64 packets;
+        quint64 bytes;
+        quint64 lost;
+    };
+
+    NetworkStatisticsSnapshot totals() const;
+
+    std::array<std::atomic<quint64>, CounterCount> m_counters;
+
+    QTimer *m_publishTimer;
+    QElapsedTimer m_clock;
+    int m_windowMs;
+
+    // Sliding window history, only touched by the publishing thread
+    QVector<WindowSample> m_window;
+    NetworkStatisticsSnapshot m_lastPublished;
+    bool m_hasPublished;
+
+    // Rates of the last publish, for snapshot() on other threads
+    std::atomic<double> m_packetsPerSecond;
+    std::atomic<double> m_bytesPerSecond;
+    std::atomic<double> m_lossPerSecond;
+    std::atomic<qint64> m_publishedWindowMs;
+};
+
+#endif // NETWORKSTATISTICS_H
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "phosphorlayer.h"
+#include "cpufeatures.h"
+#include <QPainter>
+#include <QRadialGradient>
+#include <cmath>
+
+namespace {
+
+#if defined(TELEMETRY_HAVE_SSE2)
+// Widen to 16 bits, multiply, keep the high byte, narrow again
+void decayBytesSse2(quint8 *bytes, int count, quint8 multiplier)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i factor = _mm_set1_epi16(multiplier);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+        __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), factor), 8);
+        __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), factor), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + i), _mm_packus_epi16(lo, hi));
+    }
+    PhosphorLayer::decayBytesScalar(bytes + i, count - i, multiplier);
+}
+#endif
+
+#if defined(TELEMETRY_X86)
+// Same as the SSE2 kernel; unpack and pack both work per 128-bit lane, so
+// byte order is preserved without a cross-lane permute
+TELEMETRY_TARGET_AVX2 void decayBytesAvx2(quint8 *bytes, int count, quint8 multiplier)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i factor = _mm256_set1_epi16(multiplier);
+
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i));
+        __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(v, zero), factor), 8);
+        __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(v, zero), factor), 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(bytes + i), _mm256_packus_epi16(lo, hi));
+    }
+    PhosphorLayer::decayBytesScalar(bytes + i, count - i, multiplier);
+}
+#endif
+
+struct DecayKernel {
+    void (*function)(quint8 *, int, quint8);
+    const char *name;
+};
+
+const DecayKernel &decayKernel()
+{
+    static const DecayKernel kernel = []() -> DecayKernel {
+#if defined(TELEMETRY_X86)
+        if (CpuFeatures::hasAvx2()) {
+            return {decayBytesAvx2, "avx2"};
+        }
+#endif
+#if defined(TELEMETRY_HAVE_SSE2)
+        return {decayBytesSse2, "sse2"};
+#else
+        return {PhosphorLayer::decayBytesScalar, "scalar"};
+#endif
+    }();
+    return kernel;
+}
+
+} // namespace
+
+PhosphorLayer::PhosphorLayer()
+    : m_devicePixelRatio(1.0)
+    , m_persistenceMs(3000)
+    , m_residual(0)
+    , m_pendingMs(0)
+{
+}
+
+void PhosphorLayer::decayBytesScalar(quint8 *bytes, int count, quint8 multiplier)
+{
+    for (int i = 0; i < count; ++i) {
+        bytes[i] = quint8((bytes[i] * multiplier) >> 8);
+    }
+}
+
+void PhosphorLayer::decayBytes(quint8 *bytes, int count, quint8 multiplier)
+{
+    decayKernel().function(bytes, count, multiplier);
+}
+
+const char *PhosphorLayer::decayKernelName()
+{
+    return decayKernel().name;
+}
+
+void PhosphorLayer::resize(const QRect &area, qreal devicePixelRatio)
+{
+    m_area = area;
+    m_devicePixelRatio = devicePixelRatio;
+    m_image = QImage(area.size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    m_image.setDevicePixelRatio(devicePixelRatio);
+    m_image.fill(Qt::transparent);
+    m_activeRect = QRect();
+    m_residual = 0;
+    m_pendingMs = 0;
+}
+
+void PhosphorLayer::clear()
+{
+    m_image.fill(Qt::transparent);
+    m_activeRect = QRect();
+    m_residual = 0;
+}
+
+void PhosphorLayer::markStamped(const QRectF &widgetRect)
+{
+    // Widget space -> image pixels
+    QRectF local = widgetRect.translated(-m_area.topLeft());
+    QRect pixels = QRectF(local.x() * m_devicePixelRatio, local.y() * m_devicePixelRatio,
+                          local.width() * m_devicePixelRatio, local.height() * m_devicePixelRatio)
+                       .toAlignedRect().adjusted(-1, -1, 1, 1)
+                       .intersected(m_image.rect());
+    m_activeRect |= pixels;
+    m_residual = 255;
+}
+
+void PhosphorLayer::stampSpot(const QPointF &center, double radius, const QColor &color)
+{
+    if (m_image.isNull()) return;
+
+    QRadialGradient glow(center - m_area.topLeft(), radius);
+    QColor edge = color;
+    edge.setAlpha(0);
+    glow.setColorAt(0, color);
+    glow.setColorAt(1, edge);
+
+    QPainter painter(&m_image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(glow);
+    painter.drawEllipse(center - m_area.topLeft(), radius, radius);
+
+    markStamped(QRectF(center.x() - radius, center.y() - radius, radius * 2, radius * 2));
+}
+
+void PhosphorLayer::stampRing(const QPointF &center, double radius, double width, const QColor &color)
+{
+    if (m_image.isNull() || radius <= 0) return;
+
+    QPainter painter(&m_image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(color, width));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawEllipse(center - m_area.topLeft(), radius, radius);
+
+    double outer = radius + width;
+    markStamped(QRectF(center.x() - outer, center.y() - outer, outer * 2, outer * 2));
+}
+
+void PhosphorLayer::decay(qint64 elapsedMs)
+{
+    if (m_residual == 0) return;
+
+    // Hold short intervals back until the step is coarse enough for 8-bit
+    // fixed point, otherwise truncation would make fast frame rates fade
+    // faster than the time constant says
+    m_pendingMs += elapsedMs;
+    int multiplier = int(std::exp(-double(m_pendingMs) / m_persistenceMs) * 256.0);
+    if (multiplier >= 255) return;
+    multiplier = qMax(0, multiplier);
+    m_pendingMs = 0;
+
+    // Premultiplied ARGB: scaling all four channels keeps pixels valid
+    int x = m_activeRect.x() * 4;
+    int bytes = m_activeRect.width() * 4;
+    for (int y = m_activeRect.top(); y <= m_activeRect.bottom(); ++y) {
+        decayBytes(m_image.scanLine(y) + x, bytes, quint8(multiplier));
+    }
+
+    // Every channel is at most the residual, which decays the same way.
+    // Once it reaches zero the whole image is dark again.
+    m_residual = (m_residual * multiplier) >> 8;
+    if (m_residual == 0) {
+        m_activeRect = QRect();
+    }
+}
+
+QRect PhosphorLayer::activeRect() const
+{
+    if (!isActive()) {
+        return QRect();
+    }
+    return QRectF(m_area.x() + m_activeRect.x() / m_devicePixelRatio,
+                  m_area.y() + m_activeRect.y() / m_devicePixelRatio,
+                  m_activeRect.width() / m_devicePixelRatio,
+                  m_activeRect.height() / m_devicePixelRatio).toAlignedRect();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef PHOSPHORLAYER_H
+#define PHOSPHORLAYER_H
+
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QRect>
+
+// PPI afterglow. Contacts and sweep energy are stamped into a premultiplied
+// ARGB image that fades exponentially, so the display draws one image
+// instead of re-blending history every frame. Decay runs only over the
+// part of the image that can still be lit.
+class PhosphorLayer
+{
+public:
+    PhosphorLayer();
+
+    // Cover a widget-space rectangle at the given device pixel ratio
+    void resize(const QRect &area, qreal devicePixelRatio);
+    void clear();
+
+    QRect area() const { return m_area; }
+    const QImage &image() const { return m_image; }
+
+    // Time for a stamp to fade to 1/e of its brightness
+    void setPersistenceMs(int persistenceMs) { m_persistenceMs = qMax(1, persistenceMs); }
+    int persistenceMs() const { return m_persistenceMs; }
+
+    // Stamping, in widget coordinates
+    void stampSpot(const QPointF &center, double radius, const QColor &color);
+    void stampRing(const QPointF &center, double radius, double width, const QColor &color);
+
+    // Fade everything by the time elapsed since the previous call
+    void decay(qint64 elapsedMs);
+
+    // Widget-space bounds of pixels that may still be non-zero
+    bool isActive() const { return m_residual > 0 && !m_activeRect.isEmpty(); }
+    QRect activeRect() const;
+
+    // Kernel: bytes[i] = (bytes[i] * multiplier) >> 8. Uses the widest
+    // instruction set available at run time; all paths are bit-identical.
+    static void decayBytes(quint8 *bytes, int count, quint8 multiplier);
+    static void decayBytesScalar(quint8 *bytes, int count, quint8 multiplier);
+    static const char *decayKernelName();
+
+private:
+    void markStamped(const QRectF &widgetRect);
+
+    QImage m_image;
+    QRect m_area;                    // Widget rect covered by the image
+    qreal m_devicePixelRatio;
+    int m_persistenceMs;
+
+    QRect m_activeRect;              // Image pixels, possibly lit
+    int m_residual;                  // Upper bound on any channel value
+    qint64 m_pendingMs;              // Elapsed time not yet applied
+};
+
+#endif // PHOSPHORLAYER_H
\ No newline at end of file
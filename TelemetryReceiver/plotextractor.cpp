@@ -0,0 +1,258 @@
+#include "plotextractor.h"
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+PlotExtractor::PlotExtractor(QObject *parent)
+    : QObject(parent)
+    , m_enabled(true)
+    , m_minimumSpokes(3)
+    , m_maximumSpokeFraction(1.0 / 16.0)
+    , m_spokesPerRevolution(0)
+    , m_binCount(0)
+    , m_rangeNM(0.0)
+    , m_timestampMs(0)
+{
+}
+
+void PlotExtractor::processSpokes(const QVector<SpokeMessage> &spokes)
+{
+    if (!m_enabled) return;
+
+    m_completed.clear();
+    for (const SpokeMessage &spoke : spokes) {
+        addSpoke(spoke, m_completed);
+    }
+    if (!m_completed.isEmpty()) {
+        emit plotsExtracted(m_completed);
+    }
+}
+
+void PlotExtractor::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled) {
+        m_open.clear();
+    }
+}
+
+void PlotExtractor::setCfarMode(int mode)
+{
+    CfarDetector::Settings settings = m_detector.settings();
+    settings.mode = mode == CfarDetector::OrderedStatistic ? CfarDetector::OrderedStatistic
+                                                           : CfarDetector::CellAveraging;
+    m_detector.setSettings(settings);
+}
+
+void PlotExtractor::setThresholdScale(double scale)
+{
+    CfarDetector::Settings settings = m_detector.settings();
+    settings.scale = scale;
+    m_detector.setSettings(settings);
+}
+
+int PlotExtractor::spokeOffset(int from, int to) const
+{
+    int offset = (to - from) % m_spokesPerRevolution;
+    return offset < 0 ? offset + m_spokesPerRevolution : offset;
+}
+
+void PlotExtractor::findRuns(const quint8 *bins, int count)
+{
+    m_runs.clear();
+    const quint8 *hits = m_hits.constData();
+    int i = 0;
+    while (i < count) {
+        // Hits are sparse; skip empty stretches eight bins at a time
+        if (i + 8 <= count) {
+            quint64 word;
+            std::memcpy(&word, hits + i, sizeof(word));
+            if (word == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        if (!hits[i]) {
+            ++i;
+            continue;
+        }
+
+        Run run = {i, i, 0, 0.0, 0.0};
+        for (; i < count && hits[i]; ++i) {
+            int level = bins[i];
+            run.last = i;
+            run.peak = qMax(run.peak, level);
+            run.weight += level;
+            run.binSum += level * (i + 0.5);
+        }
+        m_runs.append(run);
+    }
+}
+
+void PlotExtractor::absorb(OpenPlot &plot, const OpenPlot &other)
+{
+    // Rebase both azimuth sums on whichever plot began first
+    int shift = spokeOffset(plot.firstSpoke, other.firstSpoke);
+    if (shift > m_spokesPerRevolution / 2) {
+        int back = m_spokesPerRevolution - shift;
+        plot.azimuthSum += plot.weight * back;
+        plot.spokes += back;
+        plot.firstSpoke = other.firstSpoke;
+        shift = 0;
+    }
+    plot.azimuthSum += other.azimuthSum + other.weight * shift;
+    plot.spokes = qMax(plot.spokes, other.spokes + shift);
+
+    plot.edgeFirst = qMin(plot.edgeFirst, other.edgeFirst);
+    plot.edgeLast = qMax(plot.edgeLast, other.edgeLast);
+    plot.nextFirst = qMin(plot.nextFirst, other.nextFirst);
+    plot.nextLast = qMax(plot.nextLast, other.nextLast);
+    plot.extended = plot.extended || other.extended;
+    plot.minBin = qMin(plot.minBin, other.minBin);
+    plot.maxBin = qMax(plot.maxBin, other.maxBin);
+    plot.peak = qMax(plot.peak, other.peak);
+    plot.cells += other.cells;
+    plot.weight += other.weight;
+    plot.binSum += other.binSum;
+}
+
+void PlotExtractor::addSpoke(const SpokeMessage &spoke, QVector<RadarPlot> &out)
+{
+    int count = spoke.bins.size();
+    if (count == 0 || spoke.azimuth >= spoke.spokesPerRevolution) {
+        return;
+    }
+    if (spoke.spokesPerRevolution != m_spokesPerRevolution || count != m_binCount || spoke.rangeNM != m_rangeNM) {
+        flush(out);
+        m_spokesPerRevolution = spoke.spokesPerRevolution;
+        m_binCount = count;
+        m_rangeNM = spoke.rangeNM;
+    }
+    int azimuth = spoke.azimuth;
+    m_timestampMs = spoke.timestampMs;
+
+    // After lost spokes nothing open can continue
+    int previous = (azimuth + m_spokesPerRevolution - 1) % m_spokesPerRevolution;
+    int carried = 0;
+    for (const OpenPlot &plot : m_open) {
+        if (plot.lastSpoke == previous) {
+            m_open[carried++] = plot;
+        } else {
+            complete(plot, out);
+        }
+    }
+    m_open.resize(carried);
+
+    const quint8 *bins = reinterpret_cast<const quint8 *>(spoke.bins.constData());
+    m_hits.resize(count);
+    m_detector.detect(bins, count, m_hits.data());
+    findRuns(bins, count);
+
+    for (OpenPlot &plot : m_open) {
+        plot.extended = false;
+        plot.nextFirst = INT_MAX;
+        plot.nextLast = -1;
+    }
+
+    // Join each run to every plot it touches on the previous spoke,
+    // diagonals included. Plots started on this spoke are appended after
+    // the carried ones and never matched: their runs are not adjacent.
+    for (const Run &run : m_runs) {
+        int owner = -1;
+        for (int i = 0; i < carried; ++i) {
+            OpenPlot &plot = m_open[i];
+            if (run.first > plot.edgeLast + 1 || run.last < plot.edgeFirst - 1) {
+                continue;
+            }
+            if (owner >= 0) {
+                // The run bridges two plots; the second is emptied
+                absorb(m_open[owner], plot);
+                plot.cells = 0;
+                plot.edgeFirst = INT_MAX / 2;
+                plot.edgeLast = -2;
+                continue;
+            }
+            owner = i;
+            if (!plot.extended) {
+                ++plot.spokes;
+            }
+            plot.extended = true;
+            plot.nextFirst = qMin(plot.nextFirst, run.first);
+            plot.nextLast = qMax(plot.nextLast, run.last);
+            plot.minBin = qMin(plot.minBin, run.first);
+            plot.maxBin = qMax(plot.maxBin, run.last);
+            plot.peak = qMax(plot.peak, run.peak);
+            plot.cells += run.last - run.first + 1;
+            plot.weight += run.weight;
+            plot.binSum += run.binSum;
+            plot.azimuthSum += run.weight * spokeOffset(plot.firstSpoke, azimuth);
+        }
+
+        if (owner < 0) {
+            OpenPlot plot;
+            plot.firstSpoke = azimuth;
+            plot.lastSpoke = azimuth;
+            plot.edgeFirst = INT_MAX / 2;
+            plot.edgeLast = -2;
+            plot.nextFirst = run.first;
+            plot.nextLast = run.last;
+            plot.extended = true;
+            plot.spokes = 1;
+            plot.minBin = run.first;
+            plot.maxBin = run.last;
+            plot.peak = run.peak;
+            plot.cells = run.last - run.first + 1;
+            plot.weight = run.weight;
+            plot.binSum = run.binSum;
+            plot.azimuthSum = 0.0;
+            m_open.append(plot);
+        }
+    }
+
+    // Whatever this spoke did not extend is complete
+    int kept = 0;
+    for (const OpenPlot &plot : m_open) {
+        if (plot.cells == 0) {
+            continue;
+        }
+        if (!plot.extended) {
+            complete(plot, out);
+            continue;
+        }
+        OpenPlot &next = m_open[kept++];
+        next = plot;
+        next.lastSpoke = azimuth;
+        next.edgeFirst = next.nextFirst;
+        next.edgeLast = next.nextLast;
+    }
+    m_open.resize(kept);
+}
+
+void PlotExtractor::flush(QVector<RadarPlot> &out)
+{
+    for (const OpenPlot &plot : m_open) {
+        complete(plot, out);
+    }
+    m_open.clear();
+}
+
+void PlotExtractor::complete(const OpenPlot &plot, QVector<RadarPlot> &out) const
+{
+    int maximumSpokes = qMax(m_minimumSpokes, int(m_spokesPerRevolution * m_maximumSpokeFraction));
+    if (plot.spokes < m_minimumSpokes || plot.spokes > maximumSpokes || plot.weight <= 0.0) {
+        return;
+    }
+
+    double binNM = m_rangeNM / m_binCount;
+    double degreesPerSpoke = 360.0 / m_spokesPerRevolution;
+    RadarPlot result;
+    result.bearing = std::fmod((plot.firstSpoke + plot.azimuthSum / plot.weight) * degreesPerSpoke, 360.0);
+    result.range = plot.binSum / plot.weight * binNM;
+    result.bearingExtent = plot.spokes * degreesPerSpoke;
+    result.rangeExtent = (plot.maxBin - plot.minBin + 1) * binNM;
+    result.peak = plot.peak;
+    result.spokes = plot.spokes;
+    result.cells = plot.cells;
+    result.timestampMs = m_timestampMs;
+    out.append(result);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef PLOTEXTRACTOR_H
+#define PLOTEXTRACTOR_H
+
+#include <QObject>
+#include <QVector>
+#include "cfardetector.h"
+#include "radarplot.h"
+#include "telemetrypacket.h"
+
+// Plot extraction: CFAR along each spoke, then runs of hits are joined
+// with overlapping runs on the previous spoke. A plot is complete on the
+// first spoke that does not extend it, so targets come out a beamwidth
+// after the antenna passes them rather than once per revolution.
+// Spokes must arrive in rotation order; a change of spoke format closes
+// everything open.
+class PlotExtractor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlotExtractor(QObject *parent = nullptr);
+
+    // Detect and cluster one spoke; plots it completes are appended to out
+    void addSpoke(const SpokeMessage &spoke, QVector<RadarPlot> &out);
+    void flush(QVector<RadarPlot> &out);  // Complete everything still open
+
+    void setDetectorSettings(const CfarDetector::Settings &settings) { m_detector.setSettings(settings); }
+    const CfarDetector::Settings &detectorSettings() const { return m_detector.settings(); }
+
+    // Smaller groups are noise; larger ones are land or clutter banks
+    void setMinimumSpokes(int spokes) { m_minimumSpokes = qMax(1, spokes); }
+    int minimumSpokes() const { return m_minimumSpokes; }
+    void setMaximumSpokeFraction(double fraction) { m_maximumSpokeFraction = fraction; }
+
+    bool isEnabled() const { return m_enabled; }
+
+public slots:
+    void processSpokes(const QVector<SpokeMessage> &spokes);  // Emits plotsExtracted
+    void setEnabled(bool enabled);
+    void setCfarMode(int mode);                               // CfarDetector::Mode
+    void setThresholdScale(double scale);
+
+signals:
+    void plotsExtracted(const QVector<RadarPlot> &plots);
+
+private:
+    struct Run {
+        int first;                       // Bins, inclusive
+        int last;
+        int peak;
+        double weight;                   // Sum of intensities
+        double binSum;                   // Sum of intensity * bin centre
+    };
+
+    struct OpenPlot {
+        int firstSpoke;                  // Azimuth offsets are counted from here
+        int lastSpoke;
+        int edgeFirst, edgeLast;         // Bins hit on the last spoke
+        int nextFirst, nextLast;         // Bins hit on the current spoke
+        bool extended;                   // By the current spoke
+        int spokes;                      // Not wrapped, so a ring never closes
+        int minBin, maxBin;
+        int peak;
+        int cells;
+        double weight;
+        double binSum;
+        double azimuthSum;               // Sum of intensity * spoke offset
+    };
+
+    void findRuns(const quint8 *bins, int count);
+    void absorb(OpenPlot &plot, const OpenPlot &other);
+    void complete(const OpenPlot &plot, QVector<RadarPlot> &out) const;
+    int spokeOffset(int from, int to) const;
+
+    CfarDetector m_detector;
+    bool m_enabled;
+    int m_minimumSpokes;
+    double m_maximumSpokeFraction;       // Of a revolution
+
+    // Spoke format the open plots were measured in
+    int m_spokesPerRevolution;
+    int m_binCount;
+    double m_rangeNM;
+    qint64 m_timestampMs;
+
+    QVector<OpenPlot> m_open;
+    QVector<Run> m_runs;                 // Scratch, one spoke
+    QVector<quint8> m_hits;              // Scratch, one spoke
+    QVector<RadarPlot> m_completed;      // Scratch, one batch
+};
+
+#endif // PLOTEXTRACTOR_H
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "qualitygovernor.h"
+
+QualityGovernor::QualityGovernor()
+    : m_enabled(true)
+    , m_budgetMs(1000.0 / 30)
+    , m_level(FullQuality)
+    , m_slowSamples(0)
+    , m_headroomSinceMs(-1)
+    , m_stepUpHoldMs(STEP_UP_HOLD_MS)
+    , m_steppedUpMs(-1)
+{
+}
+
+void QualityGovernor::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled) {
+        setLevel(FullQuality);
+        m_stepUpHoldMs = STEP_UP_HOLD_MS;
+        m_steppedUpMs = -1;
+    }
+}
+
+bool QualityGovernor::update(double frameMs, qint64 nowMs)
+{
+    if (!m_enabled) {
+        return false;
+    }
+
+    if (frameMs > m_budgetMs) {
+        m_headroomSinceMs = -1;
+        if (++m_slowSamples < STEP_DOWN_SAMPLES || m_level == LevelCount - 1) {
+            return false;
+        }
+
+        // Slow again soon after stepping up: that level costs too much for
+        // now, so earn the next attempt with twice the headroom. A step
+        // down for any other reason starts the back-off afresh.
+        bool failedStepUp = m_steppedUpMs >= 0 && nowMs - m_steppedUpMs < m_stepUpHoldMs;
+        m_stepUpHoldMs = failedStepUp ? qMin(m_stepUpHoldMs * 2, MAX_STEP_UP_HOLD_MS) : STEP_UP_HOLD_MS;
+        m_steppedUpMs = -1;
+        setLevel(Level(m_level + 1));
+        return true;
+    }
+
+    m_slowSamples = 0;
+    if (m_level == FullQuality || frameMs >= m_budgetMs * HEADROOM) {
+        m_headroomSinceMs = -1; // Between the thresholds: hold the level
+        return false;
+    }
+    if (m_headroomSinceMs < 0) {
+        m_headroomSinceMs = nowMs;
+    }
+    if (nowMs - m_headroomSinceMs < m_stepUpHoldMs) {
+        return false;
+    }
+    setLevel(Level(m_level - 1));
+    m_steppedUpMs = nowMs;
+    return true;
+}
+
+void QualityGovernor::setLevel(Level level)
+{
+    m_level = level;
+    m_slowSamples = 0;
+    m_headroomSinceMs = -1;
+}
+
+RenderQuality QualityGovernor::qualityAt(Level level)
+{
+    RenderQuality quality;
+    quality.antialiasing = level < NoAntialiasing;
+    quality.waveRings = level < SingleWaveRing ? 3 : 1;
+    quality.beamLines = level < NoBeamLines;
+    quality.allLabels = level < SelectedLabelOnly;
+    return quality;
+}
+
+const char *QualityGovernor::levelName(Level level)
+{
+    static const char *const names[LevelCount] = {
+        "Full", "No antialiasing", "Single wave ring", "No beam lines", "Selected label only"
+    };
+    return level >= 0 && level < LevelCount ? names[level] : "";
+}
\ No newline at end of file
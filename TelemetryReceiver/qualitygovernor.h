@@ -0,0 +1,65 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <QtGlobal>
+
+// What the renderer may spend on the dynamic overlays. The static layers
+// are cached, so they always keep full quality.
+struct RenderQuality {
+    bool antialiasing = true;
+    int waveRings = 3;                   // Concentric rings of the scanning wave
+    bool beamLines = true;               // Radiating lines inside the wave
+    bool allLabels = true;               // Otherwise only the selected contact is labelled
+};
+
+// Steps render quality down while measured frame time is over budget and
+// back up once there is headroom. Stepping down is quick, since a slow
+// frame is visible; stepping up waits for sustained headroom, and waits
+// longer each time the level above turns out to be too slow again.
+class QualityGovernor
+{
+public:
+    // Most detailed first; each level keeps the reductions of those above it
+    enum Level {
+        FullQuality,
+        NoAntialiasing,
+        SingleWaveRing,
+        NoBeamLines,
+        SelectedLabelOnly,
+        LevelCount
+    };
+
+    static constexpr double HEADROOM = 0.6;        // Step up below this fraction of the budget
+    static constexpr int STEP_DOWN_SAMPLES = 2;    // Consecutive slow samples before stepping down
+    static constexpr qint64 STEP_UP_HOLD_MS = 2000; // Headroom needed before stepping up
+    static constexpr qint64 MAX_STEP_UP_HOLD_MS = 32000;
+
+    QualityGovernor();
+
+    void setEnabled(bool enabled);                 // Disabling restores full quality
+    bool isEnabled() const { return m_enabled; }
+    void setBudgetMs(double budgetMs) { m_budgetMs = qMax(0.1, budgetMs); }
+    double budgetMs() const { return m_budgetMs; }
+
+    // Feed the mean frame time over the interval ending at nowMs. Returns
+    // true when the level changed.
+    bool update(double frameMs, qint64 nowMs);
+
+    Level level() const { return m_level; }
+    RenderQuality quality() const { return qualityAt(m_level); }
+    static RenderQuality qualityAt(Level level);
+    static const char *levelName(Level level);
+
+private:
+    void setLevel(Level level);
+
+    bool m_enabled;
+    double m_budgetMs;
+    Level m_level;
+    int m_slowSamples;                             // Consecutive samples over budget
+    qint64 m_headroomSinceMs;                      // Start of the current headroom, -1 if none
+    qint64 m_stepUpHoldMs;                         // Backs off when stepping up fails
+    qint64 m_steppedUpMs;                          // When the level last went up, -1 if never
+};
+
+#endif // QUALITYGOVERNOR_H
\ No newline at end of file
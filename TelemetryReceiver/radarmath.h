@@ -0,0 +1,112 @@
+#ifndef RADARMATH_H
+#define RADARMATH_H
+
+#include <array>
+#include <cmath>
+
+// Trigonometry for display geometry. Screen layout only ever needs the
+// sine and cosine of a bearing, and most bearings it draws are whole
+// degrees, so those come from a table built at compile time. Arbitrary
+// bearings go through a short polynomial that is accurate to 1e-11,
+// far below a pixel at any radar range.
+namespace RadarMath {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG_TO_RAD = PI / 180.0;
+
+// Bearing as a unit vector: east = sin(bearing), north = cos(bearing).
+// Screen offsets are (east * r, -north * r).
+struct UnitVector {
+    double east;
+    double north;
+};
+
+namespace detail {
+
+// Taylor series on [-pi/4, pi/4] in Horner form; the first omitted terms
+// bound the error at 7e-12 for sine and 4e-13 for cosine
+constexpr double sinPolynomial(double x)
+{
+    double x2 = x * x;
+    double p = -1.0 / 39916800.0;
+    p = p * x2 + 1.0 / 362880.0;
+    p = p * x2 - 1.0 / 5040.0;
+    p = p * x2 + 1.0 / 120.0;
+    p = p * x2 - 1.0 / 6.0;
+    return x + x * x2 * p;
+}
+
+constexpr double cosPolynomial(double x)
+{
+    double x2 = x * x;
+    double p = 1.0 / 479001600.0;
+    p = p * x2 - 1.0 / 3628800.0;
+    p = p * x2 + 1.0 / 40320.0;
+    p = p * x2 - 1.0 / 720.0;
+    p = p * x2 + 1.0 / 24.0;
+    p = p * x2 - 0.5;
+    return 1.0 + x2 * p;
+}
+
+// Bearing = quadrant * 90 + remainder, with |remainder| <= 45 degrees
+constexpr UnitVector fromQuadrant(long long quadrant, double remainderDegrees)
+{
+    double x = remainderDegrees * DEG_TO_RAD;
+    double s = sinPolynomial(x);
+    double c = cosPolynomial(x);
+
+    // Rotate by whole quadrants with selects rather than a jump table;
+    // random bearings would mispredict a branch on every other call
+    bool swap = (quadrant & 1) != 0;
+    double east = swap ? c : s;
+    double north = swap ? s : c;
+    return {(quadrant & 2) ? -east : east, ((quadrant + 1) & 2) ? -north : north};
+}
+
+constexpr UnitVector wholeDegree(int degrees)
+{
+    int quadrant = (degrees + 45) / 90;
+    return fromQuadrant(quadrant, double(degrees - quadrant * 90));
+}
+
+constexpr std::array<UnitVector, 360> buildBearingTable()
+{
+    std::array<UnitVector, 360> table{};
+    for (int degrees = 0; degrees < 360; ++degrees) {
+        table[degrees] = wholeDegree(degrees);
+    }
+    return table;
+}
+
+} // namespace detail
+
+// Unit vectors for every whole degree, computed by the compiler
+inline constexpr std::array<UnitVector, 360> BEARING_TABLE = detail::buildBearingTable();
+
+static_assert(BEARING_TABLE[0].east == 0.0 && BEARING_TABLE[0].north == 1.0, "North must be exact");
+static_assert(BEARING_TABLE[90].east == 1.0 && BEARING_TABLE[90].north == 0.0, "East must be exact");
+static_assert(BEARING_TABLE[180].north == -1.0 && BEARING_TABLE[270].east == -1.0, "South and west must be exact");
+
+// Any whole-degree bearing, including negative ones and ones past 360
+inline UnitVector bearingVector(int degrees)
+{
+    int index = degrees % 360;
+    return BEARING_TABLE[index < 0 ? index + 360 : index];
+}
+
+// Arbitrary bearing in degrees; |error| < 1e-11 against std::sin/std::cos
+inline UnitVector fastBearingVector(double degrees)
+{
+    // Round to the nearest quadrant; truncation plus a fix-up for negative
+    // values avoids a floor() call on targets without SSE4.1
+    double scaled = degrees * (1.0 / 90.0) + 0.5;
+    long long quadrant = static_cast<long long>(scaled);
+    if (scaled < double(quadrant)) {
+        --quadrant;
+    }
+    return detail::fromQuadrant(quadrant, degrees - double(quadrant) * 90.0);
+}
+
+} // namespace RadarMath
+
+#endif // RADARMATH_H
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef RADARPLOT_H
+#define RADARPLOT_H
+
+#include <QMetaType>
+#include <QVector>
+#include <QtGlobal>
+
+// A target found in radar video: the intensity-weighted centre of a group
+// of CFAR hits that touch in range and azimuth
+struct RadarPlot {
+    double bearing = 0.0;                // Degrees from north
+    double range = 0.0;                  // Nautical miles
+    double bearingExtent = 0.0;          // Degrees covered
+    double rangeExtent = 0.0;            // Nautical miles covered
+    int peak = 0;                        // Strongest cell, 0-255
+    int spokes = 0;                      // Azimuth extent in spokes
+    int cells = 0;                       // Cells over threshold
+    qint64 timestampMs = 0;              // Of the spoke that closed the plot
+};
+
+Q_DECLARE_METATYPE(RadarPlot)
+Q_DECLARE_METATYPE(QVector<RadarPlot>)
+
+#endif // RADARPLOT_H
\ No newline at end of file
@@ -0,0 +1,517 @@
+#include "radarrenderer.h"
+#include "labelplacer.h"
+#include "radarmath.h"
+#include <QFontMetrics>
+#include <QPainterPath>
+#include <QRadialGradient>
+#include <QStringList>
+#include <QTransform>
+#include <algorithm>
+
+RadarRenderer::RadarRenderer()
+    : m_cacheDevicePixelRatio(0.0)
+    , m_cacheRadius(0.0)
+    , m_cacheRangeNM(0.0)
+    , m_cacheRevision(0)
+    , m_cachesValid(false)
+{
+}
+
+QRect RadarRenderer::waveRect(const QPointF &center, double discRadius, double radius)
+{
+    radius = qMin(radius, discRadius) + DIRTY_MARGIN;
+    return QRectF(center.x() - radius, center.y() - radius,
+                  radius * 2, radius * 2).toAlignedRect();
+}
+
+QRect RadarRenderer::infoPanelRect()
+{
+    return QRect(10, 10, 120, 4 * 20 + 10).adjusted(0, 0, 1, 1); // Includes the outline
+}
+
+QRect RadarRenderer::metricsPanelRect()
+{
+    // Four summary lines, then one per stage
+    int lines = 4 + FrameStats::StageCount;
+    return QRect(10, infoPanelRect().bottom() + 6, 170, lines * 15 + 10).adjusted(0, 0, 1, 1);
+}
+
+void RadarRenderer::render(QPainter &painter, const RadarScene &scene, const QRegion &dirty)
+{
+    FrameStageTimer timer(scene.metrics);
+    updateCaches(scene, timer);
+    timer.skip();
+
+    // Restore the background only where something changed
+    qreal dpr = m_background.devicePixelRatio();
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const QRect &rect : dirty) {
+        painter.drawImage(rect, m_background,
+                          QRectF(rect.x() * dpr, rect.y() * dpr, rect.width() * dpr, rect.height() * dpr));
+    }
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    timer.mark(FrameStats::BlitStage);
+
+    drawLayer(painter, scene.radarVideo, scene.radarVideoArea, dirty);
+    timer.mark(FrameStats::VideoStage);
+    drawLayer(painter, scene.afterglow, scene.afterglowArea, dirty);
+    timer.mark(FrameStats::AfterglowStage);
+
+    // Dynamic overlays, skipping those entirely outside the dirty region
+    painter.setRenderHint(QPainter::Antialiasing, scene.quality.antialiasing);
+    if (scene.sweepEnabled && dirty.intersects(waveRect(scene.center, scene.radius, scene.waveRadius))) {
+        drawScanningWave(painter, scene);
+    }
+    timer.mark(FrameStats::WaveStage);
+    drawTrails(painter, scene, dirty);
+    timer.mark(FrameStats::TrailsStage);
+    drawContacts(painter, scene, dirty);
+    timer.mark(FrameStats::ContactsStage);
+    if (dirty.intersects(infoPanelRect())) {
+        drawRadarInfo(painter, scene);
+    }
+    if (scene.metricsOverlay && dirty.intersects(metricsPanelRect())) {
+        drawMetricsOverlay(painter, scene);
+    }
+    timer.mark(FrameStats::InfoStage);
+    timer.finish();
+}
+
+void RadarRenderer::updateCaches(const RadarScene &scene, FrameStageTimer &timer)
+{
+    // Static layers only change on resize, range or style change
+    bool geometryChanged = !m_cachesValid
+                           || m_cacheSize != scene.size
+                           || m_cacheCenter != scene.center
+                           || m_cacheRadius != scene.radius
+                           || m_cacheRangeNM != scene.rangeNM;
+    bool styleChanged = !m_cachesValid
+                        || m_cacheRevision != scene.styleRevision
+                        || m_cacheDevicePixelRatio != scene.devicePixelRatio;
+
+    if (geometryChanged || styleChanged) {
+        renderBackground(scene, timer);
+    }
+    if (styleChanged) {
+        renderSpriteAtlas(scene);
+        m_labelCache.clear(); // Fonts may have changed
+    }
+
+    // Labels of tracks that are gone; cheap to rebuild if they come back
+    if (m_labelCache.size() > 2 * scene.tracks.size() + 64) {
+        m_labelCache.clear();
+    }
+
+    m_cacheSize = scene.size;
+    m_cacheDevicePixelRatio = scene.devicePixelRatio;
+    m_cacheCenter = scene.center;
+    m_cacheRadius = scene.radius;
+    m_cacheRangeNM = scene.rangeNM;
+    m_cacheRevision = scene.styleRevision;
+    m_cachesValid = true;
+}
+
+void RadarRenderer::renderBackground(const RadarScene &scene, FrameStageTimer &timer)
+{
+    // Render at device resolution so the blit is 1:1 on high-DPI screens
+    qreal dpr = scene.devicePixelRatio;
+    m_background = QImage(scene.size * dpr, QImage::Format_ARGB32_Premultiplied);
+    m_background.setDevicePixelRatio(dpr);
+    m_background.fill(scene.backgroundColor);
+
+    QPainter painter(&m_background);
+    painter.setRenderHint(QPainter::Antialiasing);
+    drawRadarBackground(painter, scene);
+    timer.mark(FrameStats::BackgroundStage);
+    drawRangeRings(painter, scene);
+    timer.mark(FrameStats::RingsStage);
+    drawBearingLines(painter, scene);
+    timer.mark(FrameStats::BearingsStage);
+    drawCompassRose(painter, scene);
+    painter.end(); // Finish drawing inside the compass stage
+    timer.mark(FrameStats::CompassStage);
+}
+
+void RadarRenderer::drawRadarBackground(QPainter &painter, const RadarScene &scene)
+{
+    // Draw circular radar screen with subtle gradient
+    QRadialGradient gradient(scene.center, scene.radius);
+    gradient.setColorAt(0, QColor(0, 30, 0, 50));
+    gradient.setColorAt(1, QColor(0, 10, 0, 100));
+
+    painter.setBrush(QBrush(gradient));
+    painter.setPen(QPen(scene.gridColor, 2));
+    painter.drawEllipse(scene.center.x() - scene.radius,
+                       scene.center.y() - scene.radius,
+                       scene.radius * 2, scene.radius * 2);
+}
+
+void RadarRenderer::drawRangeRings(QPainter &painter, const RadarScene &scene)
+{
+    painter.setPen(QPen(scene.gridColor, 1));
+    painter.setBrush(Qt::NoBrush);
+    painter.setFont(scene.ringLabelFont);
+
+    for (int i = 1; i <= scene.numRangeRings; ++i) {
+        double ringRadius = (scene.radius * i) / scene.numRangeRings;
+        painter.drawEllipse(scene.center.x() - ringRadius,
+                           scene.center.y() - ringRadius,
+                           ringRadius * 2, ringRadius * 2);
+
+        // Draw range labels
+        double range = (scene.rangeNM * i) / scene.numRangeRings;
+        QString label = QString("%1 NM").arg(range, 0, 'f', 1);
+
+        QPointF labelPos(scene.center.x() + ringRadius - 30, scene.center.y() - 5);
+        painter.drawText(labelPos, label);
+    }
+}
+
+void RadarRenderer::drawBearingLines(QPainter &painter, const RadarScene &scene)
+{
+    painter.setPen(QPen(scene.gridColor, 1));
+
+    // Draw major bearing lines (every 30 degrees)
+    for (int bearing = 0; bearing < 360; bearing += 30) {
+        RadarMath::UnitVector u = RadarMath::bearingVector(bearing);
+        QPointF start = scene.center;
+        QPointF end(scene.center.x() + scene.radius * u.east,
+                   scene.center.y() - scene.radius * u.north);
+        painter.drawLine(start, end);
+    }
+
+    // Draw minor bearing lines (every 10 degrees) - shorter
+    painter.setPen(QPen(scene.gridColor, 1, Qt::DotLine));
+    for (int bearing = 0; bearing < 360; bearing += 10) {
+        if (bearing % 30 != 0) { // Skip major bearing lines
+            RadarMath::UnitVector u = RadarMath::bearingVector(bearing);
+            QPointF start(scene.center.x() + scene.radius * 0.9 * u.east,
+                         scene.center.y() - scene.radius * 0.9 * u.north);
+            QPointF end(scene.center.x() + scene.radius * u.east,
+                       scene.center.y() - scene.radius * u.north);
+            painter.drawLine(start, end);
+        }
+    }
+}
+
+void RadarRenderer::drawCompassRose(QPainter &painter, const RadarScene &scene)
+{
+    painter.setFont(scene.compassFont);
+    painter.setPen(QPen(scene.gridColor));
+    QFontMetrics metrics(scene.compassFont);
+
+    // Draw cardinal directions
+    QStringList directions = {"N", "NE", "E", "SE", "S", "SW", "W", "NW"};
+    for (int i = 0; i < 8; ++i) {
+        RadarMath::UnitVector u = RadarMath::bearingVector(i * 45);
+
+        QPointF textPos(scene.center.x() + (scene.radius + 15) * u.east,
+                       scene.center.y() - (scene.radius + 15) * u.north);
+
+        QRect textRect = metrics.boundingRect(directions[i]);
+        textPos.setX(textPos.x() - textRect.width() / 2);
+        textPos.setY(textPos.y() + textRect.height() / 2);
+
+        painter.drawText(textPos, directions[i]);
+    }
+}
+
+void RadarRenderer::drawLayer(QPainter &painter, const QImage &image, const QRect &area, const QRegion &dirty)
+{
+    if (image.isNull()) return;
+
+    // One image, composited over the background
+    qreal imageDpr = image.devicePixelRatio();
+    for (const QRect &rect : dirty) {
+        QRect target = rect.intersected(area);
+        if (target.isEmpty()) {
+            continue;
+        }
+        QRect local = target.translated(-area.x(), -area.y());
+        painter.drawImage(target, image,
+                          QRectF(local.x() * imageDpr, local.y() * imageDpr,
+                                 local.width() * imageDpr, local.height() * imageDpr));
+    }
+}
+
+void RadarRenderer::drawScanningWave(QPainter &painter, const RadarScene &scene)
+{
+    if (!scene.sweepEnabled || scene.waveRadius <= 0) return;
+
+    // Save the current painter state
+    painter.save();
+
+    // Only draw within the radar circle, and still only inside the dirty area
+    QPainterPath clipPath;
+    clipPath.addEllipse(scene.center.x() - scene.radius,
+                       scene.center.y() - scene.radius,
+                       scene.radius * 2, scene.radius * 2);
+    painter.setClipPath(clipPath, painter.hasClipping() ? Qt::IntersectClip : Qt::ReplaceClip);
+
+    // Draw multiple concentric wave circles for better effect
+    for (int i = 0; i < scene.quality.waveRings; ++i) {
+        double waveOffset = i * 30.0; // Offset between waves
+        double currentWaveRadius = scene.waveRadius - waveOffset;
+
+        if (currentWaveRadius > 0 && currentWaveRadius <= scene.radius) {
+            // Calculate alpha based on wave position (fade as it expands)
+            double alpha = 1.0 - (currentWaveRadius / scene.radius);
+            alpha = qMax(0.1, qMin(1.0, alpha));
+
+            // Set wave color with calculated alpha
+            QColor waveColor(0, 255, 0, static_cast<int>(alpha * 120));
+            painter.setPen(QPen(waveColor, 2 + i));
+            painter.setBrush(Qt::NoBrush);
+
+            // Draw the wave circle
+            painter.drawEllipse(scene.center.x() - currentWaveRadius,
+                               scene.center.y() - currentWaveRadius,
+                               currentWaveRadius * 2, currentWaveRadius * 2);
+        }
+    }
+
+    // Draw scanning beam effect - radiating lines from center
+    if (scene.quality.beamLines && scene.waveRadius > 10) {
+        painter.setPen(QPen(QColor(0, 255, 0, 80), 1));
+        for (int angle = 0; angle < 360; angle += 15) {
+            RadarMath::UnitVector u = RadarMath::bearingVector(angle);
+            QPointF beamEnd(scene.center.x() + scene.waveRadius * u.east,
+                           scene.center.y() - scene.waveRadius * u.north);
+            painter.drawLine(scene.center, beamEnd);
+        }
+    }
+
+    // Restore painter state
+    painter.restore();
+}
+
+void RadarRenderer::drawTrails(QPainter &painter, const RadarScene &scene, const QRegion &dirty)
+{
+    const TrackStore &tracks = scene.tracks;
+    if (!scene.trailsEnabled || tracks.isEmpty()) return;
+
+    QColor trailColor = scene.contactColor;
+    trailColor.setAlpha(120);
+    painter.setPen(QPen(trailColor, 1.5));
+    painter.setBrush(Qt::NoBrush);
+
+    // Reject whole trails by their cached extent before touching the points
+    QRect dirtyBounds = dirty.boundingRect();
+    const double *ranges = tracks.ranges().constData();
+    for (int i = 0; i < tracks.size(); ++i) {
+        if (ranges[i] > scene.rangeNM || tracks.trailLength(i) < 2) {
+            continue;
+        }
+        QRect bounds = tracks.trailScreenBounds(i).toAlignedRect().adjusted(-2, -2, 2, 2);
+        if (!dirtyBounds.intersects(bounds) || !dirty.intersects(bounds)) {
+            continue;
+        }
+
+        // At most TRAIL_CAPACITY points, fewer once sub-pixel steps are dropped
+        int points = tracks.trailPolyline(i, m_trailPoints);
+        painter.drawPolyline(m_trailPoints.constData(), points);
+    }
+}
+
+void RadarRenderer::drawContacts(QPainter &painter, const RadarScene &scene, const QRegion &dirty)
+{
+    const TrackStore &tracks = scene.tracks;
+    if (tracks.isEmpty()) return;
+
+    // Only contacts that can touch the dirty area, found through the spatial
+    // grid. The margin reaches contacts whose label, on whichever side,
+    // extends into it and, when clustering, every contact of a cell the
+    // dirty area touches. Sideways that is as far as the widest label.
+    bool clustering = scene.clusterThreshold > 0;
+    double reach = clustering ? qMax(32.0, double(tracks.clusterCellSize())) : 32.0;
+    double labelReach = LabelPlacer::LABEL_SPACING + scene.widestLabel + DIRTY_MARGIN;
+    double sideReach = qMax(qMax(64.0, reach), labelReach);
+    m_visible.clear();
+    for (const QRect &rect : dirty) {
+        tracks.query(QRectF(rect).adjusted(-sideReach, -reach, sideReach, reach), m_visible);
+    }
+    if (dirty.rectCount() > 1) {
+        std::sort(m_visible.begin(), m_visible.end());
+        m_visible.erase(std::unique(m_visible.begin(), m_visible.end()), m_visible.end());
+    }
+
+    // Walk the columns directly; screen positions are already projected
+    const double *ranges = tracks.ranges().constData();
+    const float *screenX = tracks.screenX().constData();
+    const float *screenY = tracks.screenY().constData();
+    const qint64 *updatedMs = tracks.updatedMs().constData();
+    const bool *coasting = tracks.coasting().constData();
+    const qint8 *labelAnchors = tracks.labelAnchors().constData();
+    const QString *trackIds = tracks.trackIds().constData();
+
+    qint64 staleBefore = scene.nowMs - scene.contactTimeoutMs / 2;
+    int selected = scene.selectedTrackId.isEmpty() ? -1 : tracks.indexOf(scene.selectedTrackId);
+    qreal dpr = m_spriteAtlas.devicePixelRatio();
+    qreal cell = SPRITE_SIZE * dpr;
+    double half = SPRITE_SIZE / 2.0;
+
+    // Symbols: device-pixel cells of the atlas, drawn at logical size
+    m_cellPopulation.clear();
+    m_clusters.clear();
+    int drawn = 0;
+    for (int i : m_visible) {
+        if (ranges[i] > scene.rangeNM) {
+            continue; // Outside the display range
+        }
+
+        // Crowded cells are drawn once, as a cluster, after the contacts
+        if (clustering) {
+            QPointF pos(screenX[i], screenY[i]);
+            quint64 key = tracks.clusterKey(pos);
+            auto population = m_cellPopulation.constFind(key);
+            if (population == m_cellPopulation.constEnd()) {
+                m_clusterMembers.clear();
+                int count = tracks.clusterMembers(pos, scene.rangeNM, m_clusterMembers);
+                if (count > scene.clusterThreshold) {
+                    m_clusters.append({tracks.clusterCell(pos), count});
+                }
+                population = m_cellPopulation.insert(key, count);
+            }
+            if (population.value() > scene.clusterThreshold) {
+                continue;
+            }
+        }
+
+        int sprite = coasting[i] ? CoastingSprite : (updatedMs[i] < staleBefore ? StaleSprite : LiveSprite);
+        if (i == selected) {
+            sprite += SelectedSpriteOffset;
+        }
+        painter.drawImage(QRectF(screenX[i] - half, screenY[i] - half, SPRITE_SIZE, SPRITE_SIZE),
+                          m_spriteAtlas, QRectF(sprite * cell, 0, cell, cell));
+        m_visible[drawn++] = i;
+    }
+    m_visible.resize(drawn);
+
+    // Labels: pre-laid-out static text at the corner the placement pass
+    // chose; those it could not fit are left out
+    painter.setPen(scene.contactColor);
+    painter.setFont(scene.contactFont);
+    QFontMetrics metrics(scene.contactFont);
+    for (int i : m_visible) {
+        if (labelAnchors[i] == TrackStore::LabelHidden || (!scene.quality.allLabels && i != selected)) {
+            continue;
+        }
+        const QStaticText &label = contactLabel(scene, trackIds[i]);
+        QPointF offset = LabelPlacer::labelOffset(metrics, labelAnchors[i], label.size().width());
+        painter.drawStaticText(QPointF(screenX[i], screenY[i]) + offset, label);
+    }
+
+    drawClusters(painter, scene);
+}
+
+void RadarRenderer::drawClusters(QPainter &painter, const RadarScene &scene)
+{
+    if (m_clusters.isEmpty()) return;
+
+    // A counted disc inside the cell, so repainting the cell covers it
+    QColor fill = scene.contactColor;
+    fill.setAlpha(70);
+    painter.setPen(QPen(scene.contactColor, 2));
+    painter.setBrush(fill);
+    painter.setFont(scene.contactFont);
+    for (const Cluster &cluster : m_clusters) {
+        QRectF glyph = cluster.cell.adjusted(3, 3, -3, -3);
+        painter.drawEllipse(glyph);
+        painter.drawText(glyph, Qt::AlignCenter, QString::number(cluster.count));
+    }
+}
+
+const QStaticText &RadarRenderer::contactLabel(const RadarScene &scene, const QString &trackId)
+{
+    auto it = m_labelCache.find(trackId);
+    if (it == m_labelCache.end()) {
+        QStaticText label(trackId);
+        label.setTextFormat(Qt::PlainText);
+        label.setPerformanceHint(QStaticText::AggressiveCaching);
+        label.prepare(QTransform(), scene.contactFont);
+        it = m_labelCache.insert(trackId, label);
+    }
+    return it.value();
+}
+
+void RadarRenderer::renderSpriteAtlas(const RadarScene &scene)
+{
+    // One cell per symbol variant, rendered at device resolution
+    qreal dpr = scene.devicePixelRatio;
+    m_spriteAtlas = QImage(QSize(SPRITE_SIZE * SpriteCount, SPRITE_SIZE) * dpr, QImage::Format_ARGB32_Premultiplied);
+    m_spriteAtlas.setDevicePixelRatio(dpr);
+    m_spriteAtlas.fill(Qt::transparent);
+
+    QPainter painter(&m_spriteAtlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QColor staleColor = scene.contactColor;
+    staleColor.setAlphaF(0.4);
+    QColor coastingColor(255, 165, 0);
+    double radius = 6;
+
+    for (int sprite = 0; sprite < SpriteCount; ++sprite) {
+        QPointF center(sprite * SPRITE_SIZE + SPRITE_SIZE / 2.0, SPRITE_SIZE / 2.0);
+        int state = sprite % SelectedSpriteOffset;
+
+        // Small circle with cross (slightly larger for visibility). Coasting
+        // contacts are hollow so synthesized positions stand out.
+        QColor color = state == StaleSprite ? staleColor : state == CoastingSprite ? coastingColor : scene.contactColor;
+        painter.setPen(QPen(color, 3));
+        painter.setBrush(state == CoastingSprite ? QBrush(Qt::NoBrush) : QBrush(color));
+        painter.drawEllipse(center, radius, radius);
+        painter.drawLine(QPointF(center.x() - radius, center.y()), QPointF(center.x() + radius, center.y()));
+        painter.drawLine(QPointF(center.x(), center.y() - radius), QPointF(center.x(), center.y() + radius));
+
+        if (sprite >= SelectedSpriteOffset) {
+            painter.setPen(QPen(scene.gridColor, 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawEllipse(center, radius * 2, radius * 2);
+        }
+    }
+}
+
+void RadarRenderer::drawRadarInfo(QPainter &painter, const RadarScene &scene)
+{
+    // Draw radar information panel
+    painter.setFont(scene.infoFont);
+    painter.setPen(QPen(scene.gridColor));
+
+    QStringList info;
+    info << QString("Range: %1 NM").arg(scene.rangeNM, 0, 'f', 1);
+    info << QString("Sweep: %1 RPM").arg(scene.sweepRPM, 0, 'f', 1);
+    info << QString("Contacts: %1").arg(scene.tracks.size());
+    info << QString("Mode: %1").arg(scene.sweepEnabled ? "ACTIVE" : "STANDBY");
+
+    QRect infoRect(10, 10, 120, info.size() * 20 + 10);
+    painter.fillRect(infoRect, QColor(0, 0, 0, 100));
+    painter.drawRect(infoRect);
+
+    for (int i = 0; i < info.size(); ++i) {
+        painter.drawText(15, 25 + i * 15, info[i]);
+    }
+}
+
+void RadarRenderer::drawMetricsOverlay(QPainter &painter, const RadarScene &scene)
+{
+    const FrameStats &stats = scene.frameStats;
+    painter.setFont(scene.infoFont);
+    painter.setPen(QPen(scene.gridColor));
+
+    QStringList lines;
+    lines << QString("FPS: %1 (%2 frames)").arg(stats.fps, 0, 'f', 1).arg(stats.frames);
+    lines << QString("Frame p50: %1 ms").arg(stats.p50Ms, 0, 'f', 2);
+    lines << QString("Frame p99: %1 ms, max %2").arg(stats.p99Ms, 0, 'f', 2).arg(stats.maxMs, 0, 'f', 1);
+    lines << QString("Quality: %1").arg(QualityGovernor::levelName(scene.qualityLevel));
+    for (int stage = 0; stage < FrameStats::StageCount; ++stage) {
+        lines << QString("  %1: %2 ms").arg(FrameStats::stageName(stage))
+                                       .arg(stats.stageMeanMs[stage], 0, 'f', 3);
+    }
+
+    QRect panel = metricsPanelRect().adjusted(0, 0, -1, -1);
+    painter.fillRect(panel, QColor(0, 0, 0, 100));
+    painter.drawRect(panel);
+    for (int i = 0; i < lines.size(); ++i) {
+        painter.drawText(panel.left() + 5, panel.top() + 15 + i * 15, lines[i]);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef RADARRENDERER_H
+#define RADARRENDERER_H
+
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QRegion>
+#include <QStaticText>
+#include <QVector>
+#include "framemetrics.h"
+#include "radarscene.h"
+
+// Draws radar frames from a RadarScene. Holds the caches the drawing
+// needs (static layers, symbol atlas, laid-out labels) as QImages, so the
+// same renderer works on the GUI thread and on a render thread. An
+// instance must only be used by one thread at a time.
+class RadarRenderer
+{
+public:
+    // Extra pixels around anything invalidated: pen width plus antialiasing
+    static constexpr int DIRTY_MARGIN = 4;
+
+    RadarRenderer();
+
+    // Draw everything that intersects dirty; the painter should be clipped
+    // to it already
+    void render(QPainter &painter, const RadarScene &scene, const QRegion &dirty);
+
+    // Layout shared with the widget's dirty-region tracking
+    static QRect waveRect(const QPointF &center, double discRadius, double radius);
+    static QRect infoPanelRect();
+    static QRect metricsPanelRect();     // Below the info panel, when the overlay is on
+
+private:
+    // Cached layers, rebuilt when the geometry or style revision changes
+    void updateCaches(const RadarScene &scene, FrameStageTimer &timer);
+    void renderBackground(const RadarScene &scene, FrameStageTimer &timer);
+    void renderSpriteAtlas(const RadarScene &scene);
+    const QStaticText &contactLabel(const RadarScene &scene, const QString &trackId);
+
+    // Drawing methods
+    void drawRadarBackground(QPainter &painter, const RadarScene &scene);
+    void drawRangeRings(QPainter &painter, const RadarScene &scene);
+    void drawBearingLines(QPainter &painter, const RadarScene &scene);
+    void drawCompassRose(QPainter &painter, const RadarScene &scene);
+    void drawLayer(QPainter &painter, const QImage &image, const QRect &area, const QRegion &dirty);
+    void drawScanningWave(QPainter &painter, const RadarScene &scene);
+    void drawTrails(QPainter &painter, const RadarScene &scene, const QRegion &dirty);
+    void drawContacts(QPainter &painter, const RadarScene &scene, const QRegion &dirty);
+    void drawClusters(QPainter &painter, const RadarScene &scene);
+    void drawRadarInfo(QPainter &painter, const RadarScene &scene);
+    void drawMetricsOverlay(QPainter &painter, const RadarScene &scene);
+
+    // Static layers (background, rings, bearings, compass) rendered once
+    QImage m_background;                 // Device-pixel-ratio aware
+    QSize m_cacheSize;                   // Scene geometry the caches were built for
+    qreal m_cacheDevicePixelRatio;
+    QPointF m_cacheCenter;
+    double m_cacheRadius;
+    double m_cacheRangeNM;
+    quint32 m_cacheRevision;
+    bool m_cachesValid;
+
+    // Contact symbols, one atlas cell per variant
+    enum ContactSprite {
+        LiveSprite,
+        CoastingSprite,                  // Interpolated or held position
+        StaleSprite,                     // Not updated for half the timeout
+        SelectedSpriteOffset,            // Added for the selected variants
+        SpriteCount = SelectedSpriteOffset * 2
+    };
+    static constexpr int SPRITE_SIZE = 32; // Logical pixels per atlas cell
+    QImage m_spriteAtlas;
+    QHash<QString, QStaticText> m_labelCache; // Track ID -> laid-out label
+
+    // Grid cells drawn as one counted glyph instead of their contacts
+    struct Cluster {
+        QRectF cell;
+        int count;
+    };
+
+    // Reused between frames
+    QVector<int> m_visible;
+    QVector<QPointF> m_trailPoints;
+    QHash<quint64, int> m_cellPopulation; // Cell key -> contacts in range, this frame
+    QVector<int> m_clusterMembers;
+    QVector<Cluster> m_clusters;
+};
+
+#endif // RADARRENDERER_H
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "radarrenderworker.h"
+#include <QMetaObject>
+#include <QMutexLocker>
+
+RadarRenderWorker::RadarRenderWorker(QObject *parent)
+    : QObject(parent)
+    , m_front(0)
+    , m_renderQueued(false)
+{
+}
+
+void RadarRenderWorker::submit(const RadarScene &scene, const QRegion &dirty)
+{
+    QMutexLocker locker(&m_pendingLock);
+    m_pendingScene = scene;
+    m_pendingDirty |= dirty;
+
+    // One queued render at a time; later submissions ride along with it
+    if (!m_renderQueued) {
+        m_renderQueued = true;
+        QMetaObject::invokeMethod(this, "renderPending", Qt::QueuedConnection);
+    }
+}
+
+void RadarRenderWorker::renderPending()
+{
+    RadarScene scene;
+    QRegion dirty;
+    {
+        QMutexLocker locker(&m_pendingLock);
+        scene = m_pendingScene;
+        dirty = m_pendingDirty;
+        m_pendingScene = RadarScene(); // Drop our references so the GUI thread need not detach
+        m_pendingDirty = QRegion();
+        m_renderQueued = false;
+    }
+
+    QRegion damage = renderScene(scene, dirty);
+    scene = RadarScene();
+    if (!damage.isEmpty()) {
+        emit frameReady(damage);
+    }
+    emit sceneReleased();
+}
+
+QRegion RadarRenderWorker::renderScene(const RadarScene &scene, QRegion dirty)
+{
+    if (scene.size.isEmpty()) {
+        return QRegion();
+    }
+
+    // The back image last drew the frame before the front one, so it misses
+    // that frame's changes as well as this one's
+    int back = 1 - m_front;
+    QImage &image = m_buffers[back];
+    QRect bounds(QPoint(0, 0), scene.size);
+    QSize pixels = scene.size * scene.devicePixelRatio;
+    QRegion damage = (dirty | m_previousDirty) & bounds;
+
+    if (image.size() != pixels || image.devicePixelRatio() != scene.devicePixelRatio) {
+        image = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(scene.devicePixelRatio);
+        damage = bounds;
+        dirty = bounds; // The other image needs a full frame too
+    }
+    if (damage.isEmpty()) {
+        return QRegion();
+    }
+
+    QPainter painter(&image);
+    painter.setClipRegion(damage);
+    m_renderer.render(painter, scene, damage);
+    painter.end();
+
+    {
+        QMutexLocker locker(&m_swapLock);
+        m_front = back;
+    }
+    m_previousDirty = dirty;
+    return damage;
+}
+
+bool RadarRenderWorker::blit(QPainter &painter, const QRegion &region, const QSize &size)
+{
+    QMutexLocker locker(&m_swapLock);
+    const QImage &front = m_buffers[m_front];
+    qreal dpr = front.devicePixelRatio();
+    if (front.isNull() || front.size() != size * dpr) {
+        return false;
+    }
+
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const QRect &rect : region) {
+        painter.drawImage(rect, front,
+                          QRectF(rect.x() * dpr, rect.y() * dpr, rect.width() * dpr, rect.height() * dpr));
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef RADARRENDERWORKER_H
+#define RADARRENDERWORKER_H
+
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPainter>
+#include <QRegion>
+#include "radarrenderer.h"
+#include "radarscene.h"
+
+// Rasterizes radar frames on its own thread into two QImages. The worker
+// always draws into the back image and swaps it to the front when done,
+// so the GUI thread only ever blits a finished frame and never waits for
+// drawing. Scenes submitted while a frame is in progress are merged:
+// only the newest is drawn, with the union of their dirty regions.
+class RadarRenderWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RadarRenderWorker(QObject *parent = nullptr);
+
+    // Any thread
+    void submit(const RadarScene &scene, const QRegion &dirty);
+
+    // GUI thread: draw the newest finished frame. Returns false until the
+    // first frame of the current size is available.
+    bool blit(QPainter &painter, const QRegion &region, const QSize &size);
+
+signals:
+    // The front image changed inside region
+    void frameReady(const QRegion &region);
+    // A render pass is over and its scene dropped. Unless another scene was
+    // submitted since, the worker shares no data with the submitter now.
+    void sceneReleased();
+
+private slots:
+    void renderPending();
+
+private:
+    QRegion renderScene(const RadarScene &scene, QRegion dirty); // Returns the damage drawn
+
+    RadarRenderer m_renderer;            // Render thread only
+
+    // Double buffer. Only the render thread writes m_front, under m_swapLock;
+    // the GUI thread reads the front image under the same lock.
+    QMutex m_swapLock;
+    QImage m_buffers[2];
+    int m_front;
+    QRegion m_previousDirty;             // What the back image is missing besides the new frame
+
+    // Latest submitted scene, waiting for the render thread
+    QMutex m_pendingLock;
+    RadarScene m_pendingScene;
+    QRegion m_pendingDirty;
+    bool m_renderQueued;
+};
+
+#endif // RADARRENDERWORKER_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef RADARSCENE_H
+#define RADARSCENE_H
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QPointF>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include "framemetrics.h"
+#include "qualitygovernor.h"
+#include "trackstore.h"
+
+// Everything needed to draw one radar frame, copied out of the widget.
+// The containers inside are implicitly shared, so taking a scene costs a
+// few reference counts. Changing the widget's copy while a scene is out
+// would copy the whole container, so the widget holds its per-frame
+// changes until the render thread hands the scene back.
+struct RadarScene {
+    // Geometry
+    QSize size;
+    qreal devicePixelRatio = 1.0;
+    QPointF center;
+    double radius = 0.0;
+    double rangeNM = 0.0;
+    int numRangeRings = 0;
+
+    // Style. Bumped whenever the static layers or symbols must be redrawn.
+    quint32 styleRevision = 0;
+    QColor backgroundColor;
+    QColor gridColor;
+    QColor contactColor;
+    QFont ringLabelFont;
+    QFont compassFont;
+    QFont contactFont;
+    QFont infoFont;
+
+    // Animation
+    bool sweepEnabled = false;
+    double sweepRPM = 0.0;
+    double waveRadius = 0.0;
+    QImage radarVideo;                   // Scan-converted spokes, null when off or none received
+    QRect radarVideoArea;
+    QImage afterglow;                    // Null when off or fully faded
+    QRect afterglowArea;                 // Widget rect the afterglow covers
+
+    // Contacts
+    TrackStore tracks;
+    bool trailsEnabled = false;
+    int clusterThreshold = 0;            // Contacts a cell holds before it clusters, 0 for never
+    qreal widestLabel = 0.0;             // Widest contact label measured so far, logical pixels
+    QString selectedTrackId;
+    qint64 nowMs = 0;
+    int contactTimeoutMs = 0;
+
+    // Detail of the dynamic overlays, lowered by the quality governor
+    RenderQuality quality;
+    QualityGovernor::Level qualityLevel = QualityGovernor::FullQuality;
+
+    // Instrumentation. The renderer records into metrics when it is set;
+    // the overlay shows the statistics as of when the scene was taken.
+    FrameMetrics *metrics = nullptr;     // Owned by the widget, outlives any renderer
+    bool metricsOverlay = false;
+    FrameStats frameStats;
+};
+
+#endif // RADARSCENE_H
\ No newline at end of file
@@ -1,19 +1,53 @@
 #include "radarwidget.h"
+#include "radarmath.h"
+#include "radarrenderworker.h"
+#include "asynclogger.h"
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QResizeEvent>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QWindow>
+#include <QThread>
 #include <QFont>
 #include <QFontMetrics>
-#include <QRadialGradient>
 #include <QConicalGradient>
-#include <QPainterPath>
+#include <QHelpEvent>
+#include <QToolTip>
 #include <algorithm>
 #include <cmath>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+namespace {
+constexpr int DIRTY_MARGIN = RadarRenderer::DIRTY_MARGIN;
+
+// Cover the ring between two radii with one rect per angular segment. The
+// union hugs the ring closely, unlike its bounding box, so the cost of a
+// thin expanding wave scales with its circumference instead of its area.
+QRegion annulusRegion(const QPointF &center, double inner, double outer, int segments = 32)
+{
+    inner = qMax(0.0, inner);
+    QRegion region;
+    
+    for (int i = 0; i < segments; ++i) {
+        RadarMath::UnitVector u0 = RadarMath::fastBearingVector(360.0 * i / segments);
+        RadarMath::UnitVector u1 = RadarMath::fastBearingVector(360.0 * (i + 1) / segments);
+        double s0 = u0.east, c0 = u0.north;
+        double s1 = u1.east, c1 = u1.north;
+        
+        // Segments are split on the axes, so the corners bound each one
+        double xs[4] = {inner * s0, inner * s1, outer * s0, outer * s1};
+        double ys[4] = {inner * c0, inner * c1, outer * c0, outer * c1};
+        double minX = *std::min_element(xs, xs + 4), maxX = *std::max_element(xs, xs + 4);
+        double minY = *std::min_element(ys, ys + 4), maxY = *std::max_element(ys, ys + 4);
+        
+        QRectF segment(QPointF(center.x() + minX, center.y() - maxY),
+                       QPointF(center.x() + maxX, center.y() - minY));
+        region += segment.toAlignedRect().adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN);
+    }
+    return region;
+}
+}
 
 RadarWidget::RadarWidget(QWidget *parent)
     : QWidget(parent)
@@ -28,329 +62,982 @@ RadarWidget::RadarWidget(QWidget *parent)
     , m_gridColor(QColor(0, 255, 0, 180))
     , m_sweepColor(QColor(0, 255, 0, 100))
     , m_contactColor(QColor(255, 255, 0))
-    , m_hasContact(false)
-    , m_radarLat(39.0)  // Center position for telemetry area (between 36-42 lat)
-    , m_radarLon(35.5)  // Center position for telemetry area (between 26-45 lon)
+    , m_ringLabelFont("Arial", 8)
+    , m_compassFont("Arial", 10, QFont::Bold)
+    , m_contactFont("Arial", 10, QFont::Bold)
+    , m_infoFont("Arial", 9)
+    , m_contactMetrics(m_contactFont)
+    , m_styleRevision(0)
+    , m_renderThread(nullptr)
+    , m_renderWorker(nullptr)
+    , m_submitScheduled(false)
+    , m_sceneInFlight(false)
+    , m_expiryStaged(false)
+    , m_labelPlacementStaged(false)
+    , m_frameStaged(false)
+    , m_lastFrameNs(0)
+    , m_targetFrameRate(30)
+    , m_idleFrameRate(2)
+    , m_animationPaused(true)   // Until the first show event
+    , m_contactTimeoutMs(60000)
+    , m_trailsEnabled(true)
+    , m_clusterThreshold(3)
+    , m_labelPlacementScheduled(false)
+    , m_afterglowEnabled(true)
+    , m_radarVideoEnabled(true)
+    , m_plotTrackCount(0)
+    , m_frameMetricsEnabled(false)
+    , m_metricsOverlayVisible(false)
+    , m_overlayRefreshNs(0)
+    , m_governorSampleNs(0)
+    , m_plane(Geodesy::makeOrigin(39.0, 35.5)) // Center of the telemetry area (36-42 lat, 26-45 lon)
 {
     setMinimumSize(400, 400);
     setAttribute(Qt::WA_OpaquePaintEvent);
     
-    // Setup sweep animation timer
-    m_sweepTimer = new QTimer(this);
-    connect(m_sweepTimer, &QTimer::timeout, this, &RadarWidget::updateSweep);
-    m_sweepTimer->setInterval(50); // 20 FPS
-    if (m_sweepEnabled) {
-        m_sweepTimer->start();
-    }
+    // Animation timer; it only sets the pace, motion follows m_frameClock
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &RadarWidget::advanceFrame);
+    m_frameClock.start();
     
+    m_expiryTimer = new QTimer(this);
+    connect(m_expiryTimer, &QTimer::timeout, this, &RadarWidget::expireContacts);
+    m_expiryTimer->setInterval(1000);
+    m_expiryTimer->start();
+    
+    m_governor.setBudgetMs(1000.0 / m_targetFrameRate);
+    updateProjection();
 }
 
-RadarWidget::~RadarWidget() = default;
+RadarWidget::~RadarWidget()
+{
+    setThreadedRendering(false);
+}
 
 void RadarWidget::setRange(double nauticalMiles)
 {
-    m_rangeNM = qMax(0.5, qMin(100.0, nauticalMiles));
+    m_rangeNM = qMax(0.5, qMin(1000.0, nauticalMiles));
     m_numRangeRings = (m_rangeNM <= 2.0) ? 4 : (m_rangeNM <= 10.0) ? 5 : 6;
+    invalidateBackground(); // Ring labels depend on the range
+    updateProjection();
+    m_phosphor.clear();     // Everything moved
     emit rangeChanged(m_rangeNM);
-    update();
 }
 
 void RadarWidget::setSweepSpeed(double rpm)
 {
     m_sweepRPM = qMax(1.0, qMin(60.0, rpm));
+    updateInfoPanel();
+}
+
+void RadarWidget::setOrigin(double latitude, double longitude)
+{
+    latitude = qBound(-90.0, latitude, 90.0);
+    m_plane = Geodesy::TangentPlane(Geodesy::makeOrigin(latitude, longitude), m_plane.errorBudgetNM());
+    m_tracks.relocate(m_plane.origin());
+    m_phosphor.clear(); // Everything moved
+    markDirty(rect());
+    scheduleLabelPlacement();
+    TLOG_INFO("Radar", "Origin {}, {}: planar within {} NM, max error {} NM",
+              latitude, longitude, m_plane.planarLimitNM(), m_plane.maxPlanarErrorNM());
+}
+
+void RadarWidget::setPlanarErrorBudget(double nauticalMiles)
+{
+    // Contacts already placed keep their positions until their next update
+    m_plane = Geodesy::TangentPlane(m_plane.origin(), qMax(1e-6, nauticalMiles));
+    TLOG_INFO("Radar", "Planar error budget {} NM: planar within {} NM, max error {} NM",
+              m_plane.errorBudgetNM(), m_plane.planarLimitNM(), m_plane.maxPlanarErrorNM());
+}
+
+void RadarWidget::setTargetFrameRate(int fps)
+{
+    m_targetFrameRate = qBound(1, fps, 120);
+    m_idleFrameRate = qMin(m_idleFrameRate, m_targetFrameRate);
+    m_governor.setBudgetMs(1000.0 / m_targetFrameRate);
+    scheduleFrames();
+}
+
+void RadarWidget::setIdleFrameRate(int fps)
+{
+    m_idleFrameRate = qBound(1, fps, m_targetFrameRate);
+    scheduleFrames();
 }
 
 void RadarWidget::addTelemetryContact(const TelemetryData &data)
 {
-    // Calculate bearing and range from radar position
-    double bearing = calculateBearing(m_radarLat, m_radarLon, data.latitude, data.longitude);
-    double range = calculateRange(m_radarLat, m_radarLon, data.latitude, data.longitude);
+    if (m_sceneInFlight) {
+        m_stagedContacts.append(data);
+        return;
+    }
+    addContact(data, TrackStore::TelemetrySource);
+}
+
+void RadarWidget::addContact(const TelemetryData &data, TrackStore::Source source)
+{
+    // Position relative to the radar
+    Geodesy::Fix fix;
+    m_plane.project(data.latitude, data.longitude, fix);
     
-    // Only show contact if within radar range
-    if (range <= m_rangeNM) {
-        // Update the single current contact
-        m_currentContact = RadarContact(bearing, range, data.latitude, data.longitude, 1.0, "SHIP");
-        m_hasContact = true;
-        update();
+    // Repaint where the contact was and where it is now
+    int previous = m_tracks.indexOf(data.trackId);
+    QPointF previousPos;
+    if (previous >= 0) {
+        previousPos = m_tracks.screenPosition(previous);
+        updateContact(previous);
+        if (m_tracks.trailLength(previous) == TrackStore::TRAIL_CAPACITY) {
+            updateTrailSegment(previous, 0); // Oldest fix is about to drop off
+        }
     } else {
-        // Contact is out of range, hide it
-        m_hasContact = false;
-        update();
+        updateInfoPanel(); // Contact count changed
+    }
+    
+    // Contacts beyond the current range are kept and culled when drawing,
+    // so zooming out shows them again without waiting for an update
+    bool coasting = data.status == "INTERPOLATED" || data.status == "LAST_KNOWN";
+    int index = m_tracks.upsert(data.trackId, fix, data.latitude, data.longitude,
+                                1.0f, QDateTime::currentMSecsSinceEpoch(), coasting, source);
+    updateContact(index);
+    if (previous < 0 || m_tracks.screenPosition(index) != previousPos) {
+        scheduleLabelPlacement(); // Labels of stationary contacts stay where they are
+    }
+    if (m_clusterThreshold > 0) {
+        if (previous >= 0) {
+            updateCluster(previousPos);
+        }
+        updateCluster(m_tracks.screenPosition(index));
+    }
+    if (m_afterglowEnabled && fix.range <= m_rangeNM) {
+        QColor glow = m_contactColor;
+        glow.setAlpha(160);
+        m_phosphor.stampSpot(m_tracks.screenPosition(index), 10.0, glow);
+        scheduleFrames(); // Leave the idle rate while it fades
+    }
+    if (m_tracks.trailLength(index) >= 2) {
+        updateTrailSegment(index, m_tracks.trailLength(index) - 2);
+    }
+}
+
+void RadarWidget::setRadarVideoEnabled(bool enabled)
+{
+    if (m_radarVideoEnabled != enabled) {
+        m_radarVideoEnabled = enabled;
+        m_scanConverter.clear();
+        markDirty(m_scanConverter.area());
+    }
+}
+
+void RadarWidget::addSpokes(const QVector<SpokeMessage> &spokes)
+{
+    if (!m_radarVideoEnabled) {
+        return;
+    }
+    
+    // Only the polar history changes here; the raster is written on the
+    // next frame, once however many spokes arrive in between
+    for (const SpokeMessage &spoke : spokes) {
+        m_scanConverter.addSpoke(spoke);
+    }
+    scheduleFrames();
+}
+
+void RadarWidget::addPlots(const QVector<RadarPlot> &plots)
+{
+    if (m_sceneInFlight) {
+        m_stagedPlots += plots;
+        return;
+    }
+    associatePlots(plots);
+}
+
+void RadarWidget::addTrajectory(const QString &trackId, const QVector<TrajectorySample> &samples)
+{
+    if (m_sceneInFlight) {
+        m_stagedTrajectories.append(qMakePair(trackId, samples));
+        return;
+    }
+    insertTrajectory(trackId, samples);
+}
+
+void RadarWidget::insertTrajectory(const QString &trackId, const QVector<TrajectorySample> &samples)
+{
+    if (samples.isEmpty()) {
+        return;
+    }
+    
+    // A track not shown yet starts, coasting, where the segment ends
+    int count = samples.size();
+    int index = m_tracks.indexOf(trackId);
+    if (index < 0) {
+        const TrajectorySample &latest = samples.last();
+        addContact(TelemetryData(latest.latitude, latest.longitude, latest.speed,
+                                 latest.interpolated ? "INTERPOLATED" : "LAST_KNOWN", trackId),
+                   TrackStore::TelemetrySource);
+        index = m_tracks.indexOf(trackId);
+        --count;
+    }
+    if (count == 0) {
+        return;
+    }
+    
+    m_trajectoryFixes.clear();
+    for (int i = 0; i < count; ++i) {
+        Geodesy::Fix fix;
+        m_plane.project(samples[i].latitude, samples[i].longitude, fix);
+        m_trajectoryFixes.append(QPointF(fix.east, fix.north));
+    }
+    
+    // The whole trail may change shape where old fixes drop off
+    QRect before = m_tracks.trailScreenBounds(index).toAlignedRect();
+    m_tracks.insertTrail(index, m_trajectoryFixes);
+    QRect after = m_tracks.trailScreenBounds(index).toAlignedRect();
+    if (m_trailsEnabled) {
+        markDirty(before.united(after).adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN));
+    }
+}
+
+void RadarWidget::associatePlots(const QVector<RadarPlot> &plots)
+{
+    // A plot is only a position. It continues the nearest radar track
+    // within the gate, found through the track grid, or starts a new one.
+    double pixelsPerNM = m_radarRadius / m_rangeNM;
+    for (const RadarPlot &plot : plots) {
+        double latitude, longitude;
+        Geodesy::destination(m_plane.origin(), plot.bearing, plot.range, latitude, longitude);
+        Geodesy::Fix fix;
+        m_plane.project(latitude, longitude, fix);
+        QPointF pos(m_radarCenter.x() + fix.east * pixelsPerNM, m_radarCenter.y() - fix.north * pixelsPerNM);
+        
+        double gate = qMax(PLOT_GATE_NM, plot.rangeExtent) * pixelsPerNM;
+        m_plotCandidates.clear();
+        m_tracks.query(QRectF(pos.x() - gate, pos.y() - gate, 2.0 * gate, 2.0 * gate), m_plotCandidates);
+        QString trackId;
+        double nearest = gate * gate;
+        const quint8 *sources = m_tracks.sources().constData();
+        for (int index : m_plotCandidates) {
+            if (sources[index] != TrackStore::PlotSource) {
+                continue; // Telemetry contacts are never merged with plots
+            }
+            QPointF offset = m_tracks.screenPosition(index) - pos;
+            double distance = offset.x() * offset.x() + offset.y() * offset.y();
+            if (distance <= nearest) {
+                nearest = distance;
+                trackId = m_tracks.trackIds()[index];
+            }
+        }
+        if (trackId.isEmpty()) {
+            // Never an ID a telemetry contact, or an older plot track, holds
+            do {
+                trackId = QString("R%1").arg(++m_plotTrackCount);
+            } while (m_tracks.indexOf(trackId) >= 0);
+        }
+        addContact(TelemetryData(latitude, longitude, 0.0, "RADAR", trackId), TrackStore::PlotSource);
+    }
+}
+
+void RadarWidget::setAfterglowEnabled(bool enabled)
+{
+    if (m_afterglowEnabled != enabled) {
+        m_afterglowEnabled = enabled;
+        m_phosphor.clear();
+        markDirty(rect());
+        scheduleFrames();
+    }
+}
+
+void RadarWidget::setClusterThreshold(int contacts)
+{
+    contacts = qMax(0, contacts);
+    if (m_clusterThreshold != contacts) {
+        m_clusterThreshold = contacts;
+        markDirty(rect());
+        scheduleLabelPlacement();
     }
 }
 
-void RadarWidget::clearContact()
+void RadarWidget::setFrameMetricsEnabled(bool enabled)
 {
-    m_hasContact = false;
-    update();
+    m_frameMetricsEnabled = enabled;
+}
+
+void RadarWidget::setAdaptiveQuality(bool enabled)
+{
+    if (m_governor.isEnabled() == enabled) {
+        return;
+    }
+    QualityGovernor::Level previous = m_governor.level();
+    m_governor.setEnabled(enabled);
+    m_governorSampleNs = m_frameMetrics.nowNs(); // Judge only frames drawn from now on
+    if (m_governor.level() != previous) {
+        markDirty(rect());
+    }
+}
+
+void RadarWidget::setMetricsOverlayVisible(bool visible)
+{
+    if (m_metricsOverlayVisible != visible) {
+        m_metricsOverlayVisible = visible;
+        markDirty(RadarRenderer::metricsPanelRect());
+    }
+}
+
+void RadarWidget::setTrailsEnabled(bool enabled)
+{
+    if (m_trailsEnabled != enabled) {
+        m_trailsEnabled = enabled;
+        markDirty(rect());
+    }
+}
+
+void RadarWidget::removeContact(const QString &trackId)
+{
+    applyStagedChanges(); // Updates that arrived before the removal
+    int index = m_tracks.indexOf(trackId);
+    if (index >= 0) {
+        QPointF pos = m_tracks.screenPosition(index);
+        updateContact(index);
+        updateInfoPanel();
+        m_tracks.remove(trackId);
+        if (m_clusterThreshold > 0) {
+            updateCluster(pos);
+        }
+        scheduleLabelPlacement();
+    }
+}
+
+void RadarWidget::clearContacts()
+{
+    m_stagedContacts.clear();
+    m_stagedTrajectories.clear();
+    m_stagedPlots.clear();
+    m_tracks.clear();
+    markDirty(rect());
+}
+
+RadarContact RadarWidget::contact(int index) const
+{
+    RadarContact contact(m_tracks.bearings()[index], m_tracks.ranges()[index],
+                         m_tracks.latitudes()[index], m_tracks.longitudes()[index],
+                         m_tracks.strengths()[index], m_tracks.trackIds()[index]);
+    contact.position = polarToCartesian(contact.bearing, contact.range);
+    contact.timestamp = QDateTime::fromMSecsSinceEpoch(m_tracks.updatedMs()[index]);
+    return contact;
+}
+
+void RadarWidget::expireContacts()
+{
+    if (m_sceneInFlight) {
+        m_expiryStaged = true;
+        return;
+    }
+    m_expiryStaged = false;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    
+    // Expiry is rare and may remove many tracks at once: repaint everything
+    if (m_tracks.expire(now, m_contactTimeoutMs) > 0) {
+        markDirty(rect());
+        scheduleLabelPlacement();
+        return;
+    }
+    
+    // Contacts that turned stale since the last tick switch symbol
+    qint64 staleAge = m_contactTimeoutMs / 2;
+    const qint64 *updatedMs = m_tracks.updatedMs().constData();
+    for (int i = 0; i < m_tracks.size(); ++i) {
+        qint64 age = now - updatedMs[i];
+        if (age >= staleAge && age < staleAge + m_expiryTimer->interval()) {
+            updateContact(i);
+        }
+    }
+}
+
+QRect RadarWidget::contactRect(int index) const
+{
+    // Symbol and selection ring around the point, label at its anchor
+    QPointF pos = m_tracks.screenPosition(index);
+    QRect symbol = QRectF(pos.x() - 14, pos.y() - 14, 28, 28).toAlignedRect();
+    return symbol.united(labelRect(index, m_tracks.labelAnchors()[index]))
+                 .adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN);
+}
+
+QRect RadarWidget::labelRect(int index, int anchor) const
+{
+    if (anchor == TrackStore::LabelHidden) {
+        return QRect();
+    }
+    // Measured through the placer, so the renderer's label reach covers it
+    qreal width = m_labelPlacer.labelWidth(m_contactMetrics, m_tracks.trackIds()[index]);
+    QPointF topLeft = m_tracks.screenPosition(index) + LabelPlacer::labelOffset(m_contactMetrics, anchor, width);
+    return QRectF(topLeft, QSizeF(width, m_contactMetrics.height())).toAlignedRect();
+}
+
+QRect RadarWidget::waveRect(double radius) const
+{
+    return RadarRenderer::waveRect(m_radarCenter, m_radarRadius, radius);
+}
+
+QRect RadarWidget::infoPanelRect() const
+{
+    return RadarRenderer::infoPanelRect();
+}
+
+void RadarWidget::updateContact(int index)
+{
+    if (m_tracks.ranges()[index] <= m_rangeNM) {
+        markDirty(contactRect(index));
+        if (m_clusterThreshold > 0) {
+            // A cluster glyph fills the cell, and its count may change
+            QRect cell = m_tracks.clusterCell(m_tracks.screenPosition(index)).toAlignedRect();
+            markDirty(cell.adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN));
+        }
+    }
+}
+
+void RadarWidget::updateCluster(const QPointF &pos)
+{
+    // Crossing the threshold swaps the glyph for the members' own symbols
+    // and labels or back, and those reach outside the cell
+    m_clusterMembers.clear();
+    int count = m_tracks.clusterMembers(pos, m_rangeNM, m_clusterMembers);
+    if (count == m_clusterThreshold || count == m_clusterThreshold + 1) {
+        for (int member : m_clusterMembers) {
+            markDirty(contactRect(member));
+        }
+    }
+}
+
+void RadarWidget::updateTrailSegment(int index, int fix)
+{
+    if (!m_trailsEnabled || m_tracks.ranges()[index] > m_rangeNM) {
+        return;
+    }
+    QRectF segment(m_tracks.trailScreenPoint(index, fix), m_tracks.trailScreenPoint(index, fix + 1));
+    markDirty(segment.normalized().toAlignedRect().adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN));
+}
+
+void RadarWidget::updateInfoPanel()
+{
+    markDirty(infoPanelRect());
+}
+
+void RadarWidget::scheduleLabelPlacement()
+{
+    // Many contacts move per pass when updates arrive in bursts; one
+    // placement covers them all
+    if (!m_labelPlacementScheduled) {
+        m_labelPlacementScheduled = true;
+        QTimer::singleShot(0, this, &RadarWidget::placeLabels);
+    }
+}
+
+void RadarWidget::placeLabels()
+{
+    m_labelPlacementScheduled = false;
+    if (m_sceneInFlight) {
+        m_labelPlacementStaged = true;
+        return;
+    }
+    m_labelPlacementStaged = false;
+    int selected = m_selectedTrackId.isEmpty() ? -1 : m_tracks.indexOf(m_selectedTrackId);
+    m_labelChanges.clear();
+    m_labelPlacer.place(m_tracks, m_contactMetrics, m_rangeNM, m_clusterThreshold, selected, m_labelChanges);
+    
+    // Only labels that moved, appeared or were hidden need repainting
+    for (const LabelPlacer::Change &change : m_labelChanges) {
+        QRect before = labelRect(change.index, change.previous);
+        QRect after = labelRect(change.index, m_tracks.labelAnchors()[change.index]);
+        for (const QRect &label : {before, after}) {
+            if (!label.isNull()) {
+                markDirty(label.adjusted(-DIRTY_MARGIN, -DIRTY_MARGIN, DIRTY_MARGIN, DIRTY_MARGIN));
+            }
+        }
+    }
 }
 
 void RadarWidget::toggleSweep(bool enabled)
 {
     m_sweepEnabled = enabled;
-    if (enabled && !m_sweepTimer->isActive()) {
-        m_sweepTimer->start();
-    } else if (!enabled && m_sweepTimer->isActive()) {
-        m_sweepTimer->stop();
-    }
+    markDirty(waveRect(m_waveRadius));
+    updateInfoPanel();
+    scheduleFrames();
 }
 
 void RadarWidget::paintEvent(QPaintEvent *event)
 {
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
     
-    // Fill background
-    painter.fillRect(rect(), m_backgroundColor);
+    // Threaded: only copy the finished frame; until one of the right size
+    // exists, show the background colour
+    if (m_renderWorker) {
+        if (!m_renderWorker->blit(painter, event->region(), size())) {
+            painter.fillRect(event->rect(), m_backgroundColor);
+        }
+        return;
+    }
     
-    // Draw radar components
-    drawRadarBackground(painter);
-    drawRangeRings(painter);
-    drawBearingLines(painter);
-    drawCompassRose(painter);
-    drawScanningWave(painter);
-    drawContact(painter);
-    drawRadarInfo(painter);
+    m_renderer.render(painter, makeScene(), event->region());
 }
 
-void RadarWidget::resizeEvent(QResizeEvent *event)
+RadarScene RadarWidget::makeScene()
 {
-    QWidget::resizeEvent(event);
+    // The afterglow covers the disc at device resolution
+    qreal dpr = devicePixelRatioF();
+    QRect afterglowArea = waveRect(m_radarRadius);
+    if (m_phosphor.area() != afterglowArea || m_phosphor.image().devicePixelRatio() != dpr) {
+        m_phosphor.resize(afterglowArea, dpr);
+    }
     
-    // Update radar center and radius based on new size
-    int minDimension = qMin(width(), height());
-    m_radarRadius = (minDimension - 60) / 2;
-    m_radarCenter = QPointF(width() / 2.0, height() / 2.0);
+    // So does the radar video. A new geometry redraws the whole raster,
+    // which only happens along with a full repaint.
+    if (m_scanConverter.setGeometry(m_radarCenter, m_radarRadius, m_rangeNM, dpr)) {
+        m_scanConverter.update();
+    }
+    
+    RadarScene scene;
+    scene.size = size();
+    scene.devicePixelRatio = dpr;
+    scene.center = m_radarCenter;
+    scene.radius = m_radarRadius;
+    scene.rangeNM = m_rangeNM;
+    scene.numRangeRings = m_numRangeRings;
+    scene.styleRevision = m_styleRevision;
+    scene.backgroundColor = m_backgroundColor;
+    scene.gridColor = m_gridColor;
+    scene.contactColor = m_contactColor;
+    scene.ringLabelFont = m_ringLabelFont;
+    scene.compassFont = m_compassFont;
+    scene.contactFont = m_contactFont;
+    scene.infoFont = m_infoFont;
+    scene.sweepEnabled = m_sweepEnabled;
+    scene.sweepRPM = m_sweepRPM;
+    scene.waveRadius = m_waveRadius;
+    if (m_radarVideoEnabled && m_scanConverter.isActive()) {
+        scene.radarVideo = m_scanConverter.image();
+        scene.radarVideoArea = m_scanConverter.area();
+    }
+    if (m_afterglowEnabled && m_phosphor.isActive()) {
+        scene.afterglow = m_phosphor.image();
+        scene.afterglowArea = m_phosphor.area();
+    }
+    scene.tracks = m_tracks;
+    scene.trailsEnabled = m_trailsEnabled;
+    scene.clusterThreshold = m_clusterThreshold;
+    scene.widestLabel = m_labelPlacer.widestLabel();
+    scene.selectedTrackId = m_selectedTrackId;
+    scene.nowMs = QDateTime::currentMSecsSinceEpoch();
+    scene.contactTimeoutMs = m_contactTimeoutMs;
+    scene.quality = m_governor.quality();
+    scene.qualityLevel = m_governor.level();
+    bool timed = m_frameMetricsEnabled || m_metricsOverlayVisible || m_governor.isEnabled();
+    scene.metrics = timed ? &m_frameMetrics : nullptr;
+    scene.metricsOverlay = m_metricsOverlayVisible;
+    if (m_metricsOverlayVisible) {
+        scene.frameStats = m_frameMetrics.snapshot();
+    }
+    return scene;
 }
 
-void RadarWidget::mousePressEvent(QMouseEvent *event)
+void RadarWidget::markDirty(const QRegion &region)
 {
-    // Handle contact selection (future enhancement)
-    QPointF clickPos = event->position();
-    // Convert to world coordinates and check for nearby contacts
-    QWidget::mousePressEvent(event);
+    if (!m_renderWorker) {
+        update(region);
+        return;
+    }
+    
+    // Collect everything invalidated during this event loop pass and hand
+    // it to the render thread once
+    m_pendingDirty |= region;
+    if (!m_submitScheduled) {
+        m_submitScheduled = true;
+        QTimer::singleShot(0, this, &RadarWidget::submitFrame);
+    }
 }
 
-void RadarWidget::wheelEvent(QWheelEvent *event)
+void RadarWidget::submitFrame()
 {
-    // Zoom in/out by changing range
-    if (event->angleDelta().y() > 0) {
-        setRange(m_rangeNM * 0.8);  // Zoom in
-    } else {
-        setRange(m_rangeNM * 1.25); // Zoom out
+    m_submitScheduled = false;
+    if (!m_renderWorker || m_sceneInFlight || m_pendingDirty.isEmpty()) {
+        return; // A scene in flight picks up the rest when it comes back
     }
-    event->accept();
+    m_sceneInFlight = true;
+    m_renderWorker->submit(makeScene(), m_pendingDirty);
+    m_pendingDirty = QRegion();
 }
 
-void RadarWidget::updateSweep()
+void RadarWidget::onFrameReady(const QRegion &region)
 {
-    // Update wave radius - expand from center to edge
-    double waveSpeed = m_sweepRPM * 3.0; // Wave expansion speed
-    double deltaTime = m_sweepTimer->interval() / 1000.0;
-    m_waveRadius += waveSpeed * deltaTime;
-    
-    // Reset wave when it reaches the edge
-    if (m_waveRadius >= m_radarRadius) {
-        m_waveRadius = 0.0;
+    update(region);
+}
+
+void RadarWidget::onSceneReleased()
+{
+    m_sceneInFlight = false;
+    applyStagedChanges();
+    submitFrame();
+}
+
+void RadarWidget::applyStagedChanges()
+{
+    // Telemetry first, so new plot tracks never take a ship's ID
+    QVector<TelemetryData> contacts;
+    contacts.swap(m_stagedContacts);
+    for (const TelemetryData &data : contacts) {
+        addContact(data, TrackStore::TelemetrySource);
+    }
+    QVector<QPair<QString, QVector<TrajectorySample>>> trajectories;
+    trajectories.swap(m_stagedTrajectories);
+    for (const auto &trajectory : trajectories) {
+        insertTrajectory(trajectory.first, trajectory.second);
+    }
+    if (!m_stagedPlots.isEmpty()) {
+        QVector<RadarPlot> plots;
+        plots.swap(m_stagedPlots);
+        associatePlots(plots);
     }
     
-    update();
+    // Timer work that came due meanwhile. Each stays staged if a scene is
+    // still out, as when this runs ahead of a removal.
+    if (m_expiryStaged) {
+        expireContacts();
+    }
+    if (m_labelPlacementStaged) {
+        placeLabels();
+    }
+    if (m_frameStaged) {
+        advanceFrame();
+    }
 }
 
+void RadarWidget::setThreadedRendering(bool enabled)
+{
+    if (enabled == (m_renderWorker != nullptr)) {
+        return;
+    }
+    
+    if (enabled) {
+        m_renderThread = new QThread(this);
+        m_renderThread->setObjectName("RadarRender");
+        m_renderWorker = new RadarRenderWorker();
+        m_renderWorker->moveToThread(m_renderThread);
+        connect(m_renderThread, &QThread::finished, m_renderWorker, &QObject::deleteLater);
+        connect(m_renderWorker, &RadarRenderWorker::frameReady,
+                this, &RadarWidget::onFrameReady, Qt::QueuedConnection);
+        connect(m_renderWorker, &RadarRenderWorker::sceneReleased,
+                this, &RadarWidget::onSceneReleased, Qt::QueuedConnection);
+        m_renderThread->start();
+    } else {
+        // The worker is deleted on its own thread as that thread finishes
+        m_renderWorker->disconnect(this);
+        m_renderWorker = nullptr;
+        m_renderThread->quit();
+        m_renderThread->wait();
+        delete m_renderThread;
+        m_renderThread = nullptr;
+        m_pendingDirty = QRegion();
+        m_sceneInFlight = false;
+        applyStagedChanges();
+    }
+    markDirty(rect());
+}
 
-void RadarWidget::drawRadarBackground(QPainter &painter)
+void RadarWidget::resizeEvent(QResizeEvent *event)
 {
-    // Draw circular radar screen with subtle gradient
-    QRadialGradient gradient(m_radarCenter, m_radarRadius);
-    gradient.setColorAt(0, QColor(0, 30, 0, 50));
-    gradient.setColorAt(1, QColor(0, 10, 0, 100));
+    QWidget::resizeEvent(event);
     
-    painter.setBrush(QBrush(gradient));
-    painter.setPen(QPen(m_gridColor, 2));
-    painter.drawEllipse(m_radarCenter.x() - m_radarRadius, 
-                       m_radarCenter.y() - m_radarRadius, 
-                       m_radarRadius * 2, m_radarRadius * 2);
+    // Update radar center and radius based on new size
+    int minDimension = qMin(width(), height());
+    m_radarRadius = (minDimension - 60) / 2;
+    m_radarCenter = QPointF(width() / 2.0, height() / 2.0);
+    invalidateBackground();
+    updateProjection();
+    m_phosphor.clear();
 }
 
-void RadarWidget::drawRangeRings(QPainter &painter)
+void RadarWidget::changeEvent(QEvent *event)
 {
-    painter.setPen(QPen(m_gridColor, 1));
-    painter.setBrush(Qt::NoBrush);
+    QWidget::changeEvent(event);
     
-    for (int i = 1; i <= m_numRangeRings; ++i) {
-        double ringRadius = (m_radarRadius * i) / m_numRangeRings;
-        painter.drawEllipse(m_radarCenter.x() - ringRadius, 
-                           m_radarCenter.y() - ringRadius, 
-                           ringRadius * 2, ringRadius * 2);
-        
-        // Draw range labels
-        QFont font("Arial", 8);
-        painter.setFont(font);
-        double range = (m_rangeNM * i) / m_numRangeRings;
-        QString label = QString("%1 NM").arg(range, 0, 'f', 1);
-        
-        QPointF labelPos(m_radarCenter.x() + ringRadius - 30, m_radarCenter.y() - 5);
-        painter.drawText(labelPos, label);
+    switch (event->type()) {
+    case QEvent::PaletteChange:
+    case QEvent::StyleChange:
+    case QEvent::FontChange:
+        m_contactMetrics = QFontMetrics(m_contactFont);
+        m_labelPlacer.clearWidths();
+        invalidateBackground();
+        scheduleLabelPlacement();
+        break;
+    default:
+        break;
     }
 }
 
-void RadarWidget::drawBearingLines(QPainter &painter)
+void RadarWidget::showEvent(QShowEvent *event)
 {
-    painter.setPen(QPen(m_gridColor, 1));
+    QWidget::showEvent(event);
     
-    // Draw major bearing lines (every 30 degrees)
-    for (int bearing = 0; bearing < 360; bearing += 30) {
-        double radians = bearing * DEG_TO_RAD;
-        QPointF start = m_radarCenter;
-        QPointF end(m_radarCenter.x() + m_radarRadius * sin(radians),
-                   m_radarCenter.y() - m_radarRadius * cos(radians));
-        painter.drawLine(start, end);
+    // Minimizing and occlusion are reported to the top level, not to us
+    QWidget *topLevel = window();
+    if (m_watchedTopLevel != topLevel) {
+        if (m_watchedTopLevel) {
+            m_watchedTopLevel->removeEventFilter(this);
+        }
+        m_watchedTopLevel = topLevel;
+        topLevel->installEventFilter(this);
     }
-    
-    // Draw minor bearing lines (every 10 degrees) - shorter
-    painter.setPen(QPen(m_gridColor, 1, Qt::DotLine));
-    for (int bearing = 0; bearing < 360; bearing += 10) {
-        if (bearing % 30 != 0) { // Skip major bearing lines
-            double radians = bearing * DEG_TO_RAD;
-            QPointF start(m_radarCenter.x() + m_radarRadius * 0.9 * sin(radians),
-                         m_radarCenter.y() - m_radarRadius * 0.9 * cos(radians));
-            QPointF end(m_radarCenter.x() + m_radarRadius * sin(radians),
-                       m_radarCenter.y() - m_radarRadius * cos(radians));
-            painter.drawLine(start, end);
+    QWindow *handle = topLevel->windowHandle();
+    if (m_watchedWindow != handle) {
+        if (m_watchedWindow) {
+            m_watchedWindow->removeEventFilter(this);
+        }
+        m_watchedWindow = handle;
+        if (handle) {
+            handle->installEventFilter(this);
         }
     }
+    updateVisibility();
+}
+
+void RadarWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    updateVisibility();
+}
+
+bool RadarWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    if ((watched == m_watchedTopLevel && event->type() == QEvent::WindowStateChange)
+        || (watched == m_watchedWindow && event->type() == QEvent::Expose)) {
+        updateVisibility();
+    }
+    return QWidget::eventFilter(watched, event);
 }
 
-void RadarWidget::drawCompassRose(QPainter &painter)
+void RadarWidget::invalidateBackground()
 {
-    QFont font("Arial", 10, QFont::Bold);
-    painter.setFont(font);
-    painter.setPen(QPen(m_gridColor));
+    ++m_styleRevision; // Renderers rebuild static layers and symbols
+    markDirty(rect());
+}
+
+void RadarWidget::mousePressEvent(QMouseEvent *event)
+{
+    // Select the contact under the cursor, or clear the selection
+    int index = contactAt(event->position());
+    QString trackId = index >= 0 ? m_tracks.trackIds()[index] : QString();
     
-    // Draw cardinal directions
-    QStringList directions = {"N", "NE", "E", "SE", "S", "SW", "W", "NW"};
-    for (int i = 0; i < 8; ++i) {
-        double bearing = i * 45;
-        double radians = bearing * DEG_TO_RAD;
-        
-        QPointF textPos(m_radarCenter.x() + (m_radarRadius + 15) * sin(radians),
-                       m_radarCenter.y() - (m_radarRadius + 15) * cos(radians));
-        
-        QFontMetrics metrics(font);
-        QRect textRect = metrics.boundingRect(directions[i]);
-        textPos.setX(textPos.x() - textRect.width() / 2);
-        textPos.setY(textPos.y() + textRect.height() / 2);
-        
-        painter.drawText(textPos, directions[i]);
+    if (trackId != m_selectedTrackId) {
+        int previous = m_selectedTrackId.isEmpty() ? -1 : m_tracks.indexOf(m_selectedTrackId);
+        if (previous >= 0) {
+            updateContact(previous);
+        }
+        if (index >= 0) {
+            updateContact(index);
+        }
+        m_selectedTrackId = trackId;
+        scheduleLabelPlacement(); // The selected label is placed first
+    }
+    if (index >= 0) {
+        emit contactSelected(contact(index));
+    }
+    QWidget::mousePressEvent(event);
+}
+
+bool RadarWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto *helpEvent = static_cast<QHelpEvent *>(event);
+        int index = contactAt(helpEvent->pos());
+        if (index >= 0) {
+            QToolTip::showText(helpEvent->globalPos(),
+                               QString("%1\nBrg %2°  Rng %3 NM\n%4°, %5°")
+                               .arg(m_tracks.trackIds()[index])
+                               .arg(m_tracks.bearings()[index], 0, 'f', 1)
+                               .arg(m_tracks.ranges()[index], 0, 'f', 1)
+                               .arg(m_tracks.latitudes()[index], 0, 'f', 4)
+                               .arg(m_tracks.longitudes()[index], 0, 'f', 4),
+                               this);
+        } else {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+int RadarWidget::contactAt(const QPointF &screenPos) const
+{
+    // Generous radius so small symbols are still easy to hit
+    return m_tracks.hitTest(screenPos, 10.0, m_rangeNM);
+}
+
+void RadarWidget::wheelEvent(QWheelEvent *event)
+{
+    // Zoom in/out by changing range
+    if (event->angleDelta().y() > 0) {
+        setRange(m_rangeNM * 0.8);  // Zoom in
+    } else {
+        setRange(m_rangeNM * 1.25); // Zoom out
     }
+    event->accept();
 }
 
-void RadarWidget::drawScanningWave(QPainter &painter)
+void RadarWidget::advanceFrame()
 {
-    if (!m_sweepEnabled || m_waveRadius <= 0) return;
+    // The afterglow and video rasters are still being drawn from. The
+    // frame runs once they come back, covering the time since the last one.
+    if (m_sceneInFlight) {
+        m_frameStaged = true;
+        return;
+    }
+    m_frameStaged = false;
     
-    // Save the current painter state
-    painter.save();
+    // Advance by the time that really passed, so a late or slow frame
+    // moves the animation further instead of slowing it down
+    qint64 nowNs = m_frameClock.nsecsElapsed();
+    qint64 elapsedNs = nowNs - m_lastFrameNs;
+    qint64 elapsedMs = nowNs / 1000000 - m_lastFrameNs / 1000000; // No drift from rounding
+    m_lastFrameNs = nowNs;
     
-    // Create a clipping region to only draw within the radar circle
-    QPainterPath clipPath;
-    clipPath.addEllipse(m_radarCenter.x() - m_radarRadius, 
-                       m_radarCenter.y() - m_radarRadius, 
-                       m_radarRadius * 2, m_radarRadius * 2);
-    painter.setClipPath(clipPath);
+    if (m_sweepEnabled) {
+        advanceSweep(elapsedNs / 1e9);
+    }
     
-    // Draw multiple concentric wave circles for better effect
-    for (int i = 0; i < 3; ++i) {
-        double waveOffset = i * 30.0; // Offset between waves
-        double currentWaveRadius = m_waveRadius - waveOffset;
-        
-        if (currentWaveRadius > 0 && currentWaveRadius <= m_radarRadius) {
-            // Calculate alpha based on wave position (fade as it expands)
-            double alpha = 1.0 - (currentWaveRadius / m_radarRadius);
-            alpha = qMax(0.1, qMin(1.0, alpha));
-            
-            // Set wave color with calculated alpha
-            QColor waveColor(0, 255, 0, static_cast<int>(alpha * 120));
-            painter.setPen(QPen(waveColor, 2 + i));
-            painter.setBrush(Qt::NoBrush);
-            
-            // Draw the wave circle
-            painter.drawEllipse(m_radarCenter.x() - currentWaveRadius, 
-                               m_radarCenter.y() - currentWaveRadius, 
-                               currentWaveRadius * 2, currentWaveRadius * 2);
+    // Fade the afterglow and lay down this frame's sweep energy. The lit
+    // part of the layer changes every frame, including the frame in which
+    // it fades out completely.
+    if (m_afterglowEnabled) {
+        QRect lit = m_phosphor.activeRect();
+        m_phosphor.decay(elapsedMs);
+        if (m_sweepEnabled && m_waveRadius > 0) {
+            m_phosphor.stampRing(m_radarCenter, m_waveRadius, 3.0, QColor(0, 255, 0, 60));
         }
+        markDirty(lit | m_phosphor.activeRect());
     }
     
-    // Draw scanning beam effect - radiating lines from center
-    if (m_waveRadius > 10) {
-        painter.setPen(QPen(QColor(0, 255, 0, 80), 1));
-        for (int angle = 0; angle < 360; angle += 15) {
-            double radians = angle * DEG_TO_RAD;
-            QPointF beamEnd(m_radarCenter.x() + m_waveRadius * sin(radians),
-                           m_radarCenter.y() - m_waveRadius * cos(radians));
-            painter.drawLine(m_radarCenter, beamEnd);
-        }
+    // Write the spokes received since the last frame into the video raster
+    if (m_radarVideoEnabled) {
+        markDirty(m_scanConverter.update());
+    }
+    
+    // A few overlay refreshes a second are readable; every frame is not
+    if (m_metricsOverlayVisible && nowNs - m_overlayRefreshNs >= 250000000) {
+        m_overlayRefreshNs = nowNs;
+        markDirty(RadarRenderer::metricsPanelRect());
     }
     
-    // Restore painter state
-    painter.restore();
+    updateQuality();
+    
+    // Drop to the idle rate once the afterglow has faded out and the video stops
+    scheduleFrames();
 }
 
-void RadarWidget::drawContact(QPainter &painter)
+void RadarWidget::advanceSweep(double elapsedSeconds)
 {
-    if (!m_hasContact) return;
+    double previousRadius = m_waveRadius;
     
-    // Convert polar coordinates to screen position
-    QPointF screenPos = polarToCartesian(m_currentContact.bearing, m_currentContact.range);
-    screenPos = worldToScreen(screenPos);
+    // Update wave radius - expand from center to edge
+    double waveSpeed = m_sweepRPM * 3.0; // Wave expansion speed, px/s
+    m_waveRadius += waveSpeed * elapsedSeconds;
     
-    // Draw contact with full intensity (no fading)
-    QColor contactColor = m_contactColor;
-    painter.setPen(QPen(contactColor, 3));
-    painter.setBrush(QBrush(contactColor));
+    // Wrap when it reaches the edge, keeping the overshoot so the period
+    // does not depend on the frame rate
+    if (m_waveRadius >= m_radarRadius) {
+        m_waveRadius = m_radarRadius > 0 ? std::fmod(m_waveRadius, m_radarRadius) : 0.0;
+        markDirty(waveRect(m_radarRadius)); // Clear the whole disc once per cycle
+        return;
+    }
     
-    // Draw contact as small circle with cross (slightly larger for visibility)
-    double radius = 6;
-    painter.drawEllipse(screenPos.x() - radius, screenPos.y() - radius, 
-                       radius * 2, radius * 2);
-    painter.drawLine(screenPos.x() - radius, screenPos.y(), 
-                    screenPos.x() + radius, screenPos.y());
-    painter.drawLine(screenPos.x(), screenPos.y() - radius,
-                    screenPos.x(), screenPos.y() + radius);
+    // The beams appear all at once when the wave passes 10 px
+    if (previousRadius <= 10 && m_waveRadius > 10) {
+        markDirty(waveRect(m_waveRadius));
+        return;
+    }
     
-    // Always draw track ID for the current contact
-    QFont font("Arial", 10, QFont::Bold);
-    painter.setFont(font);
-    painter.drawText(screenPos + QPointF(10, -10), m_currentContact.trackId);
+    // Otherwise only the band swept by each wave ring changes (the beams
+    // grow inside the outermost band)
+    QRegion dirty;
+    for (int i = 0; i < m_governor.quality().waveRings; ++i) {
+        double waveOffset = i * 30.0;
+        if (m_waveRadius - waveOffset > 0) {
+            dirty |= annulusRegion(m_radarCenter, previousRadius - waveOffset, m_waveRadius - waveOffset);
+        }
+    }
+    markDirty(dirty);
 }
 
-void RadarWidget::drawRadarInfo(QPainter &painter)
+void RadarWidget::updateQuality()
 {
-    // Draw radar information panel
-    QFont font("Arial", 9);
-    painter.setFont(font);
-    painter.setPen(QPen(m_gridColor));
-    
-    QStringList info;
-    info << QString("Range: %1 NM").arg(m_rangeNM, 0, 'f', 1);
-    info << QString("Sweep: %1 RPM").arg(m_sweepRPM, 0, 'f', 1);
-    info << QString("Contact: %1").arg(m_hasContact ? "DETECTED" : "NONE");
-    info << QString("Mode: %1").arg(m_sweepEnabled ? "ACTIVE" : "STANDBY");
+    // A few frames per sample smooth out single slow ones; idle periods
+    // without frames say nothing either way
+    qint64 nowNs = m_frameMetrics.nowNs();
+    if (!m_governor.isEnabled() || nowNs - m_governorSampleNs < 250000000) {
+        return;
+    }
+    int frames = 0;
+    double frameMs = m_frameMetrics.meanSinceMs(m_governorSampleNs, frames);
+    m_governorSampleNs = nowNs;
+    if (frames == 0) {
+        return;
+    }
     
-    QRect infoRect(10, 10, 120, info.size() * 20 + 10);
-    painter.fillRect(infoRect, QColor(0, 0, 0, 100));
-    painter.drawRect(infoRect);
+    QualityGovernor::Level previous = m_governor.level();
+    if (m_governor.update(frameMs, nowNs / 1000000)) {
+        markDirty(rect()); // Every overlay may change
+        TLOG_INFO("Radar", "Render quality {} -> {}: {} ms per frame against {} ms",
+                  QualityGovernor::levelName(previous), QualityGovernor::levelName(m_governor.level()),
+                  frameMs, m_governor.budgetMs());
+    }
+}
+
+bool RadarWidget::isAnimating() const
+{
+    return m_sweepEnabled || (m_afterglowEnabled && m_phosphor.isActive())
+           || m_scanConverter.hasPendingSpokes();
+}
+
+void RadarWidget::updateVisibility()
+{
+    // Occlusion by other windows is only known where the platform reports
+    // it through expose events; minimizing and hiding are always seen
+    QWidget *topLevel = window();
+    m_animationPaused = !isVisible()
+                        || topLevel->isMinimized()
+                        || (m_watchedWindow && !m_watchedWindow->isExposed())
+                        || visibleRegion().isEmpty();
+    scheduleFrames();
+}
+
+void RadarWidget::scheduleFrames()
+{
+    if (m_animationPaused) {
+        m_frameTimer->stop();
+        return;
+    }
     
-    for (int i = 0; i < info.size(); ++i) {
-        painter.drawText(15, 25 + i * 15, info[i]);
+    int fps = isAnimating() ? m_targetFrameRate : m_idleFrameRate;
+    int interval = qMax(1, 1000 / fps);
+    if (m_frameTimer->interval() != interval) {
+        m_frameTimer->setInterval(interval);
+    }
+    if (!m_frameTimer->isActive()) {
+        // Resuming: time spent paused does not move the animation
+        m_lastFrameNs = m_frameClock.nsecsElapsed();
+        m_frameTimer->start();
     }
 }
 
+void RadarWidget::updateProjection()
+{
+    m_tracks.setProjection(m_radarCenter, m_radarRadius / m_rangeNM);
+    scheduleLabelPlacement();
+}
+
 QPointF RadarWidget::polarToCartesian(double bearing, double range) const
 {
-    double radians = bearing * DEG_TO_RAD;
-    double x = range * sin(radians);
-    double y = -range * cos(radians); // Negative because screen Y increases downward
+    RadarMath::UnitVector u = RadarMath::fastBearingVector(bearing);
+    double x = range * u.east;
+    double y = -range * u.north; // Negative because screen Y increases downward
     return QPointF(x, y);
 }
 
@@ -365,32 +1052,4 @@ QPointF RadarWidget::screenToWorld(const QPointF &screenPos) const
     double scale = m_rangeNM / m_radarRadius;
     QPointF offset = screenPos - m_radarCenter;
     return QPointF(offset.x() * scale, offset.y() * scale);
-}
-
-double RadarWidget::calculateBearing(double lat1, double lon1, double lat2, double lon2) const
-{
-    double dLon = (lon2 - lon1) * DEG_TO_RAD;
-    double lat1Rad = lat1 * DEG_TO_RAD;
-    double lat2Rad = lat2 * DEG_TO_RAD;
-    
-    double y = sin(dLon) * cos(lat2Rad);
-    double x = cos(lat1Rad) * sin(lat2Rad) - sin(lat1Rad) * cos(lat2Rad) * cos(dLon);
-    
-    double bearing = atan2(y, x) * RAD_TO_DEG;
-    return fmod(bearing + 360.0, 360.0); // Normalize to 0-360
-}
-
-double RadarWidget::calculateRange(double lat1, double lon1, double lat2, double lon2) const
-{
-    double dLat = (lat2 - lat1) * DEG_TO_RAD;
-    double dLon = (lon2 - lon1) * DEG_TO_RAD;
-    
-    double a = sin(dLat/2) * sin(dLat/2) +
-               cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) *
-               sin(dLon/2) * sin(dLon/2);
-    double c = 2 * atan2(sqrt(a), sqrt(1-a));
-    
-    // Earth radius in nautical miles (approximately 3440.065 NM)
-    double earthRadiusNM = 3440.065;
-    return earthRadiusNM * c;
 }
\ No newline at end of file
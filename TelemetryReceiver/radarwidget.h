@@ -4,6 +4,8 @@
 #include <QWidget>
 #include <QPainter>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
 #include <QDateTime>
 #include <QVector>
 #include <QPointF>
@@ -11,8 +13,24 @@
 #include <QWheelEvent>
 #include <QPaintEvent>
 #include <QResizeEvent>
+#include <QFont>
+#include <QFontMetrics>
+#include <QRegion>
 #include <cmath>
-#include "telemetryreceiversocket.h"
+#include "telemetrydata.h"
+#include "telemetrypacket.h"
+#include "trackstore.h"
+#include "phosphorlayer.h"
+#include "scanconverter.h"
+#include "radarplot.h"
+#include "radarrenderer.h"
+#include "qualitygovernor.h"
+#include "labelplacer.h"
+#include "geodesy.h"
+
+class QThread;
+class QWindow;
+class RadarRenderWorker;
 
 struct RadarContact {
     QPointF position;        // Relative position (meters from radar center)
@@ -44,11 +62,83 @@ public:
     void setSweepSpeed(double rpm);
     double getSweepSpeed() const { return m_sweepRPM; }
     
+    // Radar position that bearings and ranges are measured from. Contacts
+    // inside planarLimitNM() are placed on the local tangent plane, within
+    // the error budget; farther ones use great-circle math.
+    void setOrigin(double latitude, double longitude);
+    const Geodesy::Origin &origin() const { return m_plane.origin(); }
+    void setPlanarErrorBudget(double nauticalMiles);
+    double planarErrorBudget() const { return m_plane.errorBudgetNM(); }
+    double planarLimitNM() const { return m_plane.planarLimitNM(); }
+    double maxPlanarErrorNM() const { return m_plane.maxPlanarErrorNM(); }
+    
+    // Frame pacing: the target rate while something moves, the idle rate
+    // otherwise. Animation stops while the widget cannot be seen.
+    void setTargetFrameRate(int fps);
+    int targetFrameRate() const { return m_targetFrameRate; }
+    void setIdleFrameRate(int fps);
+    int idleFrameRate() const { return m_idleFrameRate; }
+    bool isAnimationPaused() const { return m_animationPaused; }
+    
+    // Rasterize on a render thread into double-buffered images; paintEvent
+    // then only blits the newest finished frame
+    void setThreadedRendering(bool enabled);
+    bool threadedRendering() const { return m_renderWorker != nullptr; }
+    
+    // Contacts not updated for this long are dropped
+    void setContactTimeoutMs(int timeoutMs) { m_contactTimeoutMs = qMax(1000, timeoutMs); }
+    int getContactTimeoutMs() const { return m_contactTimeoutMs; }
+    int contactCount() const { return m_tracks.size(); }
+    RadarContact contact(int index) const;
+    QString selectedTrackId() const { return m_selectedTrackId; }
+    
+    // History tails behind each contact
+    void setTrailsEnabled(bool enabled);
+    bool trailsEnabled() const { return m_trailsEnabled; }
+    
+    // Level of detail: a screen cell holding more than this many contacts
+    // is drawn as one glyph with a count. 0 never clusters.
+    void setClusterThreshold(int contacts);
+    int clusterThreshold() const { return m_clusterThreshold; }
+    
+    // Frame timing per render stage over a rolling window. Nothing is
+    // timed unless enabled here or the overlay, which shows the statistics
+    // on screen, is visible.
+    void setFrameMetricsEnabled(bool enabled);
+    bool frameMetricsEnabled() const { return m_frameMetricsEnabled; }
+    void setMetricsOverlayVisible(bool visible);
+    bool metricsOverlayVisible() const { return m_metricsOverlayVisible; }
+    FrameStats frameStats() const { return m_frameMetrics.snapshot(); }
+    void resetFrameMetrics() { m_frameMetrics.reset(); }
+    
+    // Lower the detail of the dynamic overlays while frames take longer
+    // than the target frame rate allows, and restore it with headroom.
+    // Frame timing runs while this is on.
+    void setAdaptiveQuality(bool enabled);
+    bool adaptiveQuality() const { return m_governor.isEnabled(); }
+    QualityGovernor::Level qualityLevel() const { return m_governor.level(); }
+    
+    // Phosphor afterglow of contacts and sweep
+    void setAfterglowEnabled(bool enabled);
+    bool afterglowEnabled() const { return m_afterglowEnabled; }
+    void setAfterglowPersistenceMs(int persistenceMs) { m_phosphor.setPersistenceMs(persistenceMs); }
+    
+    // Raw radar video from received spokes, drawn under the contacts
+    void setRadarVideoEnabled(bool enabled);
+    bool radarVideoEnabled() const { return m_radarVideoEnabled; }
+    void setScanAveraging(bool enabled) { m_scanConverter.setScanAveraging(enabled); }
+    
 
 public slots:
     void addTelemetryContact(const TelemetryData &data);
-    void clearContact();
+    void removeContact(const QString &trackId);
+    void clearContacts();
     void toggleSweep(bool enabled);
+    void addSpokes(const QVector<SpokeMessage> &spokes);
+    void addPlots(const QVector<RadarPlot> &plots);  // As "R<n>" contacts
+    // Positions synthesized for a gap, oldest first, into the trail ahead
+    // of the newest fix. The contact itself does not move.
+    void addTrajectory(const QString &trackId, const QVector<TrajectorySample> &samples);
 
 signals:
     void contactSelected(const RadarContact &contact);
@@ -57,28 +147,57 @@ signals:
 protected:
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
+    bool event(QEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
 
 private slots:
-    void updateSweep();
+    void advanceFrame();
+    void expireContacts();
+    void submitFrame();
+    void onFrameReady(const QRegion &region);
+    void onSceneReleased();
+    void placeLabels();
 
 private:
-    // Drawing methods
-    void drawRadarBackground(QPainter &painter);
-    void drawRangeRings(QPainter &painter);
-    void drawBearingLines(QPainter &painter);
-    void drawCompassRose(QPainter &painter);
-    void drawScanningWave(QPainter &painter);
-    void drawContact(QPainter &painter);
-    void drawRadarInfo(QPainter &painter);
+    // Animation, advanced by measured time rather than timer ticks
+    void advanceSweep(double elapsedSeconds);
+    bool isAnimating() const;
+    void updateVisibility();             // Pause or resume with the window
+    void scheduleFrames();               // Pick the timer rate for the current state
+    void updateQuality();                // Feed the governor the frames since its last update
+    
+    // Rendering
+    void invalidateBackground();         // Static layers and symbols changed
+    RadarScene makeScene();              // Snapshot of everything drawn
+    
+    // Dirty-region tracking. Everything goes through markDirty so that the
+    // threaded mode can forward it to the render thread.
+    void markDirty(const QRegion &region);
+    QRect contactRect(int index) const;  // Everything drawn for one contact
+    QRect labelRect(int index, int anchor) const; // Null when hidden
+    QRect waveRect(double radius) const; // Bounds of the wave disc at a radius
+    QRect infoPanelRect() const;
+    void addContact(const TelemetryData &data, TrackStore::Source source);
+    void associatePlots(const QVector<RadarPlot> &plots);
+    void insertTrajectory(const QString &trackId, const QVector<TrajectorySample> &samples);
+    void applyStagedChanges();           // Held back while a scene was in flight
+    void updateContact(int index);
+    void updateCluster(const QPointF &pos); // Members, if the cell at pos may have crossed the threshold
+    void updateTrailSegment(int index, int fix); // Segment from fix to fix + 1
+    void updateInfoPanel();
+    void scheduleLabelPlacement();       // Once per event loop pass, after contacts moved
     
     // Coordinate conversion
+    void updateProjection();
+    int contactAt(const QPointF &screenPos) const;
     QPointF polarToCartesian(double bearing, double range) const;
     QPointF worldToScreen(const QPointF &worldPos) const;
     QPointF screenToWorld(const QPointF &screenPos) const;
-    double calculateBearing(double lat1, double lon1, double lat2, double lon2) const;
-    double calculateRange(double lat1, double lon1, double lat2, double lon2) const;
     
     // Radar parameters
     double m_rangeNM;                    // Radar range in nautical miles
@@ -94,20 +213,70 @@ private:
     QColor m_gridColor;                  // Grid and text color
     QColor m_sweepColor;                 // Sweep line color
     QColor m_contactColor;               // Contact color
+    QFont m_ringLabelFont;               // Range ring labels
+    QFont m_compassFont;                 // Cardinal direction labels
+    QFont m_contactFont;                 // Contact track IDs
+    QFont m_infoFont;                    // Info panel text
+    QFontMetrics m_contactMetrics;       // For label extents
+    
+    // Drawing, either here in paintEvent or on the render thread
+    RadarRenderer m_renderer;            // Used when not threaded
+    quint32 m_styleRevision;             // Passed on in every scene
+    QThread *m_renderThread;
+    RadarRenderWorker *m_renderWorker;   // Null when not threaded
+    QRegion m_pendingDirty;              // Not yet submitted to the worker
+    bool m_submitScheduled;
+    
+    // While the render thread holds a scene it shares the track columns,
+    // grid and rasters with us; changing them would copy them whole. So
+    // per-frame changes wait until it hands the scene back.
+    bool m_sceneInFlight;
+    QVector<TelemetryData> m_stagedContacts;
+    QVector<RadarPlot> m_stagedPlots;
+    QVector<QPair<QString, QVector<TrajectorySample>>> m_stagedTrajectories;
+    bool m_expiryStaged;
+    bool m_labelPlacementStaged;
+    bool m_frameStaged;
     
     // Animation and data
-    QTimer *m_sweepTimer;                // Sweep animation timer
-    RadarContact m_currentContact;       // Current single contact
-    bool m_hasContact;                   // Whether we have a valid contact
+    QTimer *m_frameTimer;                // Drives sweep and afterglow
+    QElapsedTimer m_frameClock;          // Monotonic, for frame deltas
+    qint64 m_lastFrameNs;                // Clock reading at the previous frame
+    int m_targetFrameRate;               // FPS while animating
+    int m_idleFrameRate;                 // FPS when nothing moves
+    bool m_animationPaused;              // Hidden, minimized or unexposed
+    QPointer<QWidget> m_watchedTopLevel; // Filtered for window state changes
+    QPointer<QWindow> m_watchedWindow;   // Filtered for expose changes
+    QTimer *m_expiryTimer;               // Stale contact cleanup
+    TrackStore m_tracks;                 // All contacts, keyed by track ID
+    int m_contactTimeoutMs;              // Age at which a contact is dropped
+    QString m_selectedTrackId;           // Clicked contact, empty if none
+    bool m_trailsEnabled;                // Draw history tails
+    int m_clusterThreshold;              // Contacts per cell before clustering, 0 for off
+    QVector<int> m_clusterMembers;       // Scratch for updateCluster
+    LabelPlacer m_labelPlacer;           // Picks label corners; reruns only when contacts move
+    QVector<LabelPlacer::Change> m_labelChanges; // Scratch for placeLabels
+    bool m_labelPlacementScheduled;
+    bool m_afterglowEnabled;             // Stamp into and draw the phosphor layer
+    PhosphorLayer m_phosphor;            // Decaying afterglow over the radar disc
+    bool m_radarVideoEnabled;            // Accept spokes and draw the video raster
+    ScanConverter m_scanConverter;       // Spokes -> raster, written once per frame
+    int m_plotTrackCount;                // Radar tracks started from plots
+    QVector<int> m_plotCandidates;       // Scratch for addPlots
+    QVector<QPointF> m_trajectoryFixes;  // Scratch for insertTrajectory
+    FrameMetrics m_frameMetrics;         // Recorded into by whichever thread renders
+    bool m_frameMetricsEnabled;
+    bool m_metricsOverlayVisible;
+    qint64 m_overlayRefreshNs;           // Frame clock reading of the last overlay refresh
+    QualityGovernor m_governor;          // Render quality for the measured frame time
+    qint64 m_governorSampleNs;           // Metrics clock reading of the last governor update
     
     // Reference position (radar location)
-    double m_radarLat;                   // Radar latitude
-    double m_radarLon;                   // Radar longitude
+    Geodesy::TangentPlane m_plane;       // Origin with its cached projection constants
     
     // Constants
     static constexpr double NAUTICAL_MILE_TO_METERS = 1852.0;
-    static constexpr double DEG_TO_RAD = M_PI / 180.0;
-    static constexpr double RAD_TO_DEG = 180.0 / M_PI;
+    static constexpr double PLOT_GATE_NM = 0.25;  // Plot to radar track association
 };
 
 #endif // RADARWIDGET_H
\ No newline at end of file
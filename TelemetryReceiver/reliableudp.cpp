@@ -1,9 +1,14 @@
 #include "reliableudp.h"
 #include <QHostAddress>
 #include <QNetworkDatagram>
-#include <QDebug>
+#include "asynclogger.h"
 #include <algorithm>
-#include <cstdio>
+#include <cmath>
+
+namespace {
+// Upper bound on samples synthesized for a single gap
+constexpr int MAX_GAP_SAMPLES = 1024;
+}
 
 // ReliableUdpReceiver Implementation
 ReliableUdpReceiver::ReliableUdpReceiver(QObject *parent)
@@ -11,25 +16,35 @@ ReliableUdpReceiver::ReliableUdpReceiver(QObject *parent)
     , m_socket(new QUdpSocket(this))
     , m_timeoutTimer(new QTimer(this))
     , m_cleanupTimer(new QTimer(this))
+    , m_playoutTimer(new QTimer(this))
+    , m_drainScheduled(false)
+    , m_hasReceivedPacket(false)
     , m_expectedSequenceNumber(1)
     , m_lastValidSequenceNumber(0)
+    , m_hasReceivedSpoke(false)
+    , m_lastSpokeSequence(0)
     , m_interpolationEnabled(true)
     , m_maxBufferSize(1000)
     , m_packetTimeoutMs(5000)
-    , m_packetsReceived(0)
-    , m_packetsLost(0)
-    , m_packetsInterpolated(0)
-    , m_acksSent(0)
+    , m_jitterBufferEnabled(false)
+    , m_playoutDelayMs(200)
+    , m_adaptivePlayout(true)
+    , m_trackTimeoutMs(60000)
+    , m_statistics(new NetworkStatistics(this))
     , m_listeningPort(12345)
     , m_isListening(false)
 {
     // Setup timers
     m_timeoutTimer->setInterval(1000); // Check every second
     m_cleanupTimer->setInterval(10000); // Cleanup every 10 seconds
+    m_playoutTimer->setSingleShot(true);
+    m_playoutTimer->setTimerType(Qt::PreciseTimer);
     
     connect(m_socket, &QUdpSocket::readyRead, this, &ReliableUdpReceiver::processPendingDatagrams);
     connect(m_timeoutTimer, &QTimer::timeout, this, &ReliableUdpReceiver::checkForMissingPackets);
     connect(m_cleanupTimer, &QTimer::timeout, this, &ReliableUdpReceiver::cleanupOldPackets);
+    connect(m_playoutTimer, &QTimer::timeout, this, &ReliableUdpReceiver::releaseDuePackets);
+    connect(m_statistics, &NetworkStatistics::snapshotPublished, this, &ReliableUdpReceiver::statisticsUpdated);
 }
 
 ReliableUdpReceiver::~ReliableUdpReceiver()
@@ -39,7 +54,7 @@ ReliableUdpReceiver::~ReliableUdpReceiver()
 
 bool ReliableUdpReceiver::startListening(quint16 port)
 {
-    QMutexLocker locker(&m_socketLock);
+    Q_ASSERT(QThread::currentThread() == thread());
     
     if (m_isListening) {
         return true;
@@ -52,14 +67,11 @@ bool ReliableUdpReceiver::startListening(quint16 port)
         m_isListening = true;
         m_timeoutTimer->start();
         m_cleanupTimer->start();
+        m_statistics->start();
         emit connectionStatusChanged(true);
-        qDebug() << "ReliableUDP: Listening on port" << port;
-        printf("ReliableUDP: Successfully listening on port %d\n", port);
-        fflush(stdout);
+        TLOG_INFO("ReliableUDP", "Listening on port {}", port);
     } else {
-        qWarning() << "ReliableUDP: Failed to bind to port" << port << ":" << m_socket->errorString();
-        printf("ReliableUDP: FAILED to bind to port %d: %s\n", port, m_socket->errorString().toStdString().c_str());
-        fflush(stdout);
+        TLOG_ERROR("ReliableUDP", "Failed to bind to port {}: {}", port, m_socket->errorString());
     }
     
     return success;
@@ -67,15 +79,15 @@ bool ReliableUdpReceiver::startListening(quint16 port)
 
 void ReliableUdpReceiver::stopListening()
 {
-    QMutexLocker locker(&m_socketLock);
-    
     if (m_isListening) {
         m_timeoutTimer->stop();
         m_cleanupTimer->stop();
+        flushJitterBuffers();
+        m_statistics->stop();
         m_socket->close();
         m_isListening = false;
         emit connectionStatusChanged(false);
-        qDebug() << "ReliableUDP: Stopped listening";
+        TLOG_INFO("ReliableUDP", "Stopped listening");
     }
 }
 
@@ -84,19 +96,105 @@ bool ReliableUdpReceiver::isListening() const
     return m_isListening;
 }
 
-void ReliableUdpReceiver::processPendingDatagrams()
+void ReliableUdpReceiver::post(const ReceiverCommand &command)
 {
-    QMutexLocker socketLocker(&m_socketLock);
+    if (!m_commands.push(command)) {
+        TLOG_WARN_EVERY("ReliableUDP", 1000, "Receiver command queue full, command dropped");
+        return;
+    }
+    
+    // One wake-up per burst: the drain picks up everything queued before it runs
+    if (!m_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &ReliableUdpReceiver::drainCommands, Qt::QueuedConnection);
+    }
+}
+
+void ReliableUdpReceiver::drainCommands()
+{
+    // Clear with a read-modify-write: it reads the flag as the last producer
+    // left it, so anything pushed before that producer's exchange is visible
+    // to the pops below. A plain release store would not order the pops.
+    m_drainScheduled.exchange(false, std::memory_order_acq_rel);
+    
+    ReceiverCommand command;
+    while (m_commands.pop(command)) {
+        switch (command.type) {
+        case ReceiverCommand::SetInterpolationEnabled:
+            m_interpolationEnabled = command.value != 0;
+            break;
+        case ReceiverCommand::SetMaxBufferSize:
+            m_maxBufferSize = command.value;
+            break;
+        case ReceiverCommand::SetPacketTimeout:
+            m_packetTimeoutMs = command.value;
+            break;
+        case ReceiverCommand::SetJitterBufferEnabled:
+            m_jitterBufferEnabled = command.value != 0;
+            if (!m_jitterBufferEnabled) {
+                flushJitterBuffers();
+            }
+            break;
+        case ReceiverCommand::SetPlayoutDelay:
+            m_playoutDelayMs = qMax(0, command.value);
+            for (auto it = m_jitterBuffers.begin(); it != m_jitterBuffers.end(); ++it) {
+                it.value().setPlayoutDelayMs(m_playoutDelayMs);
+            }
+            break;
+        case ReceiverCommand::SetAdaptivePlayout:
+            m_adaptivePlayout = command.value != 0;
+            for (auto it = m_jitterBuffers.begin(); it != m_jitterBuffers.end(); ++it) {
+                it.value().setAdaptive(m_adaptivePlayout);
+            }
+            break;
+        case ReceiverCommand::SetTrackTimeout:
+            m_trackTimeoutMs = qMax(1000, command.value);
+            break;
+        }
+    }
     
+    // Re-check before going idle so no command is ever left waiting for the
+    // next post(); a push landing here normally schedules its own drain
+    if (!m_commands.isEmpty() && !m_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &ReliableUdpReceiver::drainCommands, Qt::QueuedConnection);
+    }
+}
+
+void ReliableUdpReceiver::processPendingDatagrams()
+{
     while (m_socket->hasPendingDatagrams()) {
         QNetworkDatagram datagram = m_socket->receiveDatagram();
         
         if (datagram.isValid()) {
+            m_statistics->add(NetworkStatistics::BytesReceived, datagram.data().size());
+            
+            if (SpokeMessage::isSpokeDatagram(datagram.data())) {
+                SpokeMessage spoke;
+                if (!SpokeMessage::fromDatagram(datagram.data(), spoke)) {
+                    TLOG_WARN_EVERY("ReliableUDP", 1000, "Malformed spoke datagram ({} bytes)", datagram.data().size());
+                    continue;
+                }
+                // Only a spoke ahead of the newest moves the mark; a reordered
+                // older one must not rewind it, or the run up to the newest
+                // would be counted lost a second time
+                quint32 ahead = spoke.sequenceNumber - m_lastSpokeSequence;
+                bool forward = ahead > 0 && ahead < 0x80000000u;
+                if (m_hasReceivedSpoke && forward && ahead > 1) {
+                    m_statistics->add(NetworkStatistics::SpokesLost, ahead - 1);
+                }
+                if (!m_hasReceivedSpoke || forward) {
+                    m_hasReceivedSpoke = true;
+                    m_lastSpokeSequence = spoke.sequenceNumber;
+                }
+                m_statistics->add(NetworkStatistics::SpokesReceived);
+                m_spokeBatch.append(spoke);
+                continue;
+            }
+            
             QJsonParseError parseError;
             QJsonDocument doc = QJsonDocument::fromJson(datagram.data(), &parseError);
             
             if (parseError.error != QJsonParseError::NoError) {
-                qWarning() << "ReliableUDP: JSON parse error:" << parseError.errorString();
+                TLOG_WARN_EVERY("ReliableUDP", 1000, "JSON parse error: {}", parseError.errorString());
                 continue;
             }
             
@@ -110,8 +208,8 @@ void ReliableUdpReceiver::processPendingDatagrams()
             
             // Parse telemetry packet
             TelemetryPacket packet = TelemetryPacket::fromJson(obj);
-            printf("ReliableUDP: Received packet seq=%d, lat=%f, lon=%f\n", packet.sequenceNumber, packet.latitude, packet.longitude);
-            fflush(stdout);
+            TLOG_DEBUG("ReliableUDP", "Received packet seq={} lat={} lon={}",
+                       packet.sequenceNumber, packet.latitude, packet.longitude);
             
             // Send ACK if requested
             if (packet.needsAck) {
@@ -122,6 +220,12 @@ void ReliableUdpReceiver::processPendingDatagrams()
             processReceivedPacket(packet);
         }
     }
+    
+    // One signal per pass keeps the cross-thread queue short at full video rate
+    if (!m_spokeBatch.isEmpty()) {
+        emit spokesReceived(m_spokeBatch);
+        m_spokeBatch.clear();
+    }
 }
 
 void ReliableUdpReceiver::sendAck(quint32 sequenceNumber, const QHostAddress &sender, quint16 senderPort)
@@ -133,22 +237,25 @@ void ReliableUdpReceiver::sendAck(quint32 sequenceNumber, const QHostAddress &se
     QJsonDocument doc(ack.toJson());
     QByteArray data = doc.toJson(QJsonDocument::Compact);
     
-    QMutexLocker locker(&m_socketLock);
     qint64 sent = m_socket->writeDatagram(data, sender, senderPort);
     
     if (sent != -1) {
-        m_acksSent++;
-        qDebug() << "ReliableUDP: Sent ACK for sequence" << sequenceNumber;
+        m_statistics->add(NetworkStatistics::AcksSent);
+        TLOG_TRACE("ReliableUDP", "Sent ACK for sequence {}", sequenceNumber);
     } else {
-        qWarning() << "ReliableUDP: Failed to send ACK:" << m_socket->errorString();
+        TLOG_WARN_EVERY("ReliableUDP", 1000, "Failed to send ACK: {}", m_socket->errorString());
     }
 }
 
 void ReliableUdpReceiver::processReceivedPacket(const TelemetryPacket &packet)
 {
-    QWriteLocker locker(&m_dataLock);
+    m_statistics->add(NetworkStatistics::PacketsReceived);
     
-    m_packetsReceived++;
+    // Start counting from whatever the sender is at when we join
+    if (!m_hasReceivedPacket) {
+        m_hasReceivedPacket = true;
+        m_expectedSequenceNumber = packet.sequenceNumber;
+    }
     
     // Update last valid packet
     if (packet.sequenceNumber >= m_lastValidSequenceNumber) {
@@ -156,139 +263,215 @@ void ReliableUdpReceiver::processReceivedPacket(const TelemetryPacket &packet)
         m_lastValidPacket = packet;
     }
     
-    // For now, just emit every packet immediately to avoid ordering issues
-    emit telemetryDataReceived(packet);
-    
-    // Update expected sequence for next packet
+    // Track it for gap detection unless its slot was already resolved
     if (packet.sequenceNumber >= m_expectedSequenceNumber) {
-        m_expectedSequenceNumber = packet.sequenceNumber + 1;
+        m_receivedPackets.insert(packet.sequenceNumber, {packet, QDateTime::currentMSecsSinceEpoch()});
+        advanceExpectedSequence();
     }
     
-    updateStatistics();
+    if (m_jitterBufferEnabled) {
+        // Hold the sample back so jitter and reordering don't reach the display
+        auto it = m_jitterBuffers.find(packet.trackId);
+        if (it == m_jitterBuffers.end()) {
+            JitterBuffer buffer;
+            buffer.setPlayoutDelayMs(m_playoutDelayMs);
+            buffer.setAdaptive(m_adaptivePlayout);
+            it = m_jitterBuffers.insert(packet.trackId, buffer);
+        }
+        it.value().push(packet, QDateTime::currentMSecsSinceEpoch());
+        releaseDuePackets();
+    } else {
+        emit telemetryDataReceived(packet);
+    }
 }
 
-void ReliableUdpReceiver::checkForMissingPackets()
+void ReliableUdpReceiver::advanceExpectedSequence()
 {
-    QWriteLocker locker(&m_dataLock);
-    
-    // Check for packets that should have arrived by now
-    QDateTime cutoffTime = QDateTime::currentDateTime().addMSecs(-m_packetTimeoutMs);
+    while (m_receivedPackets.contains(m_expectedSequenceNumber)) {
+        ++m_expectedSequenceNumber;
+    }
     
-    // Find missing packets in the expected range
-    for (quint32 seq = m_expectedSequenceNumber; seq < m_lastValidSequenceNumber; ++seq) {
-        if (!m_receivedPackets.contains(seq)) {
-            // This packet is missing
-            m_packetsLost++;
-            
-            if (m_interpolationEnabled) {
-                // Try to interpolate
-                TelemetryPacket interpolated = interpolatePacket(seq);
-                emit telemetryDataReceived(interpolated);
-                m_packetsInterpolated++;
-                qDebug() << "ReliableUDP: Interpolated packet" << seq;
-            } else {
-                // Use last valid packet
-                TelemetryPacket lastPacket = m_lastValidPacket;
-                lastPacket.sequenceNumber = seq;
-                lastPacket.timestamp = QDateTime::currentDateTime();
-                emit telemetryDataReceived(lastPacket);
-                qDebug() << "ReliableUDP: Used last valid for packet" << seq;
-            }
-            
-            m_expectedSequenceNumber = seq + 1;
+    // Only the newest in-order packet is needed as an interpolation anchor
+    while (m_receivedPackets.size() > 1 && m_receivedPackets.firstKey() + 1 < m_expectedSequenceNumber) {
+        m_receivedPackets.erase(m_receivedPackets.begin());
+    }
+}
+
+void ReliableUdpReceiver::checkForMissingPackets()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    
+    // Each hole in front of a received packet is one gap. It is declared lost
+    // once the packet after it has waited a full timeout for it (reordering
+    // and retransmissions get that long), or earlier if the buffer is full.
+    while (m_expectedSequenceNumber < m_lastValidSequenceNumber) {
+        auto next = m_receivedPackets.lowerBound(m_expectedSequenceNumber);
+        if (next == m_receivedPackets.end()) {
+            break;
+        }
+        
+        bool overfull = m_receivedPackets.size() > m_maxBufferSize;
+        if (!overfull && now - next.value().arrivalMs < m_packetTimeoutMs) {
+            break;
         }
+        
+        reportGap(SequenceRange(m_expectedSequenceNumber, next.key() - 1));
+        m_expectedSequenceNumber = next.key();
+        advanceExpectedSequence();
+    }
+}
+
+void ReliableUdpReceiver::reportGap(const SequenceRange &range)
+{
+    int missing = range.count();
+    m_statistics->add(NetworkStatistics::PacketsLost, missing);
+    if (m_interpolationEnabled) {
+        m_statistics->add(NetworkStatistics::PacketsInterpolated, missing);
     }
     
-    updateStatistics();
+    QString trackId;
+    QVector<TrajectorySample> trajectory = synthesizeGap(range, &trackId);
+    TLOG_DEBUG("ReliableUDP", "Gap {}-{}: {} packets lost, {} samples synthesized",
+               range.first, range.last, missing, trajectory.size());
+    
+    emit gapDetected(trackId, range, trajectory);
 }
 
-TelemetryPacket ReliableUdpReceiver::interpolatePacket(quint32 sequenceNumber)
+void ReliableUdpReceiver::releaseDuePackets()
 {
-    // Find nearest packets before and after
-    TelemetryPacket beforePacket, afterPacket;
-    bool hasBefore = false, hasAfter = false;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVector<TelemetryPacket> due;
     
-    // Look for packet before
-    for (quint32 i = sequenceNumber - 1; i > 0 && i > sequenceNumber - 10; --i) {
-        if (m_receivedPackets.contains(i)) {
-            beforePacket = m_receivedPackets[i];
-            hasBefore = true;
-            break;
-        }
+    for (auto it = m_jitterBuffers.begin(); it != m_jitterBuffers.end(); ++it) {
+        it.value().popDue(now, due);
+    }
+    for (const TelemetryPacket &packet : due) {
+        emit telemetryDataReceived(packet);
     }
     
-    // Look for packet after
-    for (quint32 i = sequenceNumber + 1; i < sequenceNumber + 10; ++i) {
-        if (m_receivedPackets.contains(i)) {
-            afterPacket = m_receivedPackets[i];
-            hasAfter = true;
-            break;
+    schedulePlayout();
+}
+
+void ReliableUdpReceiver::schedulePlayout()
+{
+    qint64 nextDue = -1;
+    for (auto it = m_jitterBuffers.constBegin(); it != m_jitterBuffers.constEnd(); ++it) {
+        qint64 due = it.value().nextDueMs();
+        if (due >= 0 && (nextDue < 0 || due < nextDue)) {
+            nextDue = due;
         }
     }
     
-    TelemetryPacket interpolated;
-    interpolated.sequenceNumber = sequenceNumber;
-    interpolated.timestamp = QDateTime::currentDateTime();
-    interpolated.status = "INTERPOLATED";
+    if (nextDue < 0) {
+        m_playoutTimer->stop();
+        return;
+    }
     
-    if (hasBefore && hasAfter) {
-        // Linear interpolation
-        double factor = double(sequenceNumber - beforePacket.sequenceNumber) / 
-                       double(afterPacket.sequenceNumber - beforePacket.sequenceNumber);
-        
-        interpolated.latitude = beforePacket.latitude + 
-                               factor * (afterPacket.latitude - beforePacket.latitude);
-        interpolated.longitude = beforePacket.longitude + 
-                                factor * (afterPacket.longitude - beforePacket.longitude);
-        interpolated.speed = beforePacket.speed + 
-                            factor * (afterPacket.speed - beforePacket.speed);
-    } else if (hasBefore) {
-        // Use previous packet data
-        interpolated.latitude = beforePacket.latitude;
-        interpolated.longitude = beforePacket.longitude;
-        interpolated.speed = beforePacket.speed;
-    } else if (hasAfter) {
-        // Use next packet data
-        interpolated.latitude = afterPacket.latitude;
-        interpolated.longitude = afterPacket.longitude;
-        interpolated.speed = afterPacket.speed;
-    } else {
-        // Use last valid packet
-        interpolated.latitude = m_lastValidPacket.latitude;
-        interpolated.longitude = m_lastValidPacket.longitude;
-        interpolated.speed = m_lastValidPacket.speed;
+    qint64 delay = qMax<qint64>(0, nextDue - QDateTime::currentMSecsSinceEpoch());
+    m_playoutTimer->start(static_cast<int>(delay));
+}
+
+void ReliableUdpReceiver::flushJitterBuffers()
+{
+    m_playoutTimer->stop();
+    
+    QVector<TelemetryPacket> remaining;
+    for (auto it = m_jitterBuffers.begin(); it != m_jitterBuffers.end(); ++it) {
+        it.value().flush(remaining);
     }
+    m_jitterBuffers.clear();
     
-    return interpolated;
+    for (const TelemetryPacket &packet : remaining) {
+        emit telemetryDataReceived(packet);
+    }
 }
 
-void ReliableUdpReceiver::cleanupOldPackets()
+void ReliableUdpReceiver::pruneJitterBuffers(qint64 nowMs)
 {
-    QWriteLocker locker(&m_dataLock);
+    // Track IDs come off the wire, so a buffer per ID ever seen would grow
+    // without bound. A drained buffer whose track has gone quiet for as long
+    // as the display keeps its contact holds nothing worth keeping.
+    int pruned = 0;
+    for (auto it = m_jitterBuffers.begin(); it != m_jitterBuffers.end();) {
+        if (it.value().size() == 0 && nowMs - it.value().lastArrivalMs() > m_trackTimeoutMs) {
+            it = m_jitterBuffers.erase(it);
+            ++pruned;
+        } else {
+            ++it;
+        }
+    }
+    if (pruned > 0) {
+        TLOG_DEBUG("ReliableUDP", "Dropped {} idle jitter buffers", pruned);
+    }
+}
+
+QVector<TrajectorySample> ReliableUdpReceiver::synthesizeGap(const SequenceRange &range, QString *trackId) const
+{
+    // Anchors on both sides of the run. The packet after it is always
+    // buffered; the one before is missing only if we joined mid-gap.
+    auto afterIt = m_receivedPackets.constFind(range.last + 1);
+    auto beforeIt = m_receivedPackets.constFind(range.first - 1);
+    const TelemetryPacket &after = afterIt != m_receivedPackets.constEnd() ? afterIt.value().packet : m_lastValidPacket;
+    const TelemetryPacket &before = beforeIt != m_receivedPackets.constEnd() ? beforeIt.value().packet : after;
+    
+    if (trackId) {
+        *trackId = before.trackId;
+    }
     
-    // Remove packets older than buffer size
-    if (m_receivedPackets.size() > m_maxBufferSize) {
-        QList<quint32> keys = m_receivedPackets.keys();
-        std::sort(keys.begin(), keys.end());
+    // A very long outage is summarized rather than expanded one-for-one
+    int sampleCount = qMin(range.count(), MAX_GAP_SAMPLES);
+    double step = sampleCount > 1 ? double(range.count() - 1) / double(sampleCount - 1) : 0.0;
+    
+    qint64 beforeMs = before.timestamp.toMSecsSinceEpoch();
+    qint64 afterMs = after.timestamp.toMSecsSinceEpoch();
+    double span = double(after.sequenceNumber) - double(before.sequenceNumber);
+    bool interpolate = m_interpolationEnabled && span > 0.0;
+    
+    QVector<TrajectorySample> trajectory;
+    trajectory.reserve(sampleCount);
+    
+    for (int i = 0; i < sampleCount; ++i) {
+        TrajectorySample sample;
+        sample.sequenceNumber = range.first + quint32(std::lround(i * step));
+        
+        double factor = span > 0.0 ? (double(sample.sequenceNumber) - double(before.sequenceNumber)) / span : 0.0;
+        sample.timestampMs = beforeMs + qint64(factor * double(afterMs - beforeMs));
+        sample.interpolated = interpolate;
         
-        int toRemove = m_receivedPackets.size() - m_maxBufferSize;
-        for (int i = 0; i < toRemove; ++i) {
-            m_receivedPackets.remove(keys[i]);
+        if (interpolate) {
+            // Linear interpolation
+            sample.latitude = before.latitude + factor * (after.latitude - before.latitude);
+            sample.longitude = before.longitude + factor * (after.longitude - before.longitude);
+            sample.speed = before.speed + factor * (after.speed - before.speed);
+        } else {
+            // Hold the last known position
+            sample.latitude = before.latitude;
+            sample.longitude = before.longitude;
+            sample.speed = before.speed;
         }
         
-        qDebug() << "ReliableUDP: Cleaned up" << toRemove << "old packets";
+        trajectory.append(sample);
     }
+    
+    return trajectory;
 }
 
-void ReliableUdpReceiver::updateStatistics()
+void ReliableUdpReceiver::cleanupOldPackets()
 {
-    emit statisticsUpdated();
+    // Received packets are released as soon as the sequence catches up; only
+    // a long-standing gap keeps them around, so resolve it early when full.
+    if (m_receivedPackets.size() > m_maxBufferSize) {
+        int buffered = m_receivedPackets.size();
+        checkForMissingPackets();
+        TLOG_DEBUG("ReliableUDP", "Cleaned up {} old packets", buffered - m_receivedPackets.size());
+    }
+    
+    pruneJitterBuffers(QDateTime::currentMSecsSinceEpoch());
 }
 
 double ReliableUdpReceiver::getPacketLossRate() const
 {
-    int total = m_packetsReceived + m_packetsLost;
-    return total > 0 ? (double(m_packetsLost) / total) * 100.0 : 0.0;
+    return m_statistics->snapshot().lossRate;
 }
 
 // ReliableUdpSender Implementation
@@ -296,21 +479,23 @@ ReliableUdpSender::ReliableUdpSender(QObject *parent)
     : QObject(parent)
     , m_socket(new QUdpSocket(this))
     , m_timeoutTimer(new QTimer(this))
+    , m_drainScheduled(false)
+    , m_droppedCommands(0)
     , m_targetPort(12345)
     , m_nextSequenceNumber(1)
     , m_ackTimeoutMs(3000)
     , m_maxRetransmissions(3)
     , m_reliabilityEnabled(true)
-    , m_packetsSent(0)
-    , m_acksReceived(0)
-    , m_retransmissions(0)
+    , m_statistics(new NetworkStatistics(this))
 {
     m_timeoutTimer->setInterval(1000); // Check timeouts every second
     
     connect(m_socket, &QUdpSocket::readyRead, this, &ReliableUdpSender::processIncomingAcks);
     connect(m_timeoutTimer, &QTimer::timeout, this, &ReliableUdpSender::checkForTimeouts);
+    connect(m_statistics, &NetworkStatistics::snapshotPublished, this, &ReliableUdpSender::statisticsUpdated);
     
     m_timeoutTimer->start();
+    m_statistics->start();
 }
 
 ReliableUdpSender::~ReliableUdpSender()
@@ -320,39 +505,131 @@ ReliableUdpSender::~ReliableUdpSender()
 
 void ReliableUdpSender::setTarget(const QHostAddress &address, quint16 port)
 {
-    m_targetAddress = address;
-    m_targetPort = port;
-    qDebug() << "ReliableUDP Sender: Target set to" << address.toString() << ":" << port;
+    SenderCommand command;
+    command.type = SenderCommand::SetTarget;
+    command.address = address;
+    command.value = port;
+    post(command);
+}
+
+void ReliableUdpSender::setAckTimeoutMs(int timeoutMs)
+{
+    SenderCommand command;
+    command.type = SenderCommand::SetAckTimeout;
+    command.value = timeoutMs;
+    post(command);
+}
+
+void ReliableUdpSender::setMaxRetransmissions(int maxRetries)
+{
+    SenderCommand command;
+    command.type = SenderCommand::SetMaxRetransmissions;
+    command.value = maxRetries;
+    post(command);
+}
+
+void ReliableUdpSender::setReliabilityEnabled(bool enabled)
+{
+    SenderCommand command;
+    command.type = SenderCommand::SetReliabilityEnabled;
+    command.value = enabled ? 1 : 0;
+    post(command);
+}
+
+quint32 ReliableUdpSender::sendTelemetryData(const TelemetryPacket &packet)
+{
+    SenderCommand command;
+    command.type = SenderCommand::SendTelemetry;
+    command.packet = packet;
+    command.packet.sequenceNumber = m_nextSequenceNumber.fetch_add(1, std::memory_order_relaxed);
+    command.packet.timestamp = QDateTime::currentDateTime();
+    
+    quint32 sequenceNumber = command.packet.sequenceNumber;
+    post(command);
+    return sequenceNumber;
+}
+
+void ReliableUdpSender::sendSpokes(const QVector<SpokeMessage> &spokes)
+{
+    // The whole batch is one command, so video at thousands of spokes per
+    // second costs the mailbox a few hundred pushes
+    SenderCommand command;
+    command.type = SenderCommand::SendSpokes;
+    command.spokes = spokes;
+    post(command);
 }
 
-void ReliableUdpSender::sendTelemetryData(const TelemetryPacket &packet)
+void ReliableUdpSender::post(const SenderCommand &command)
 {
-    QMutexLocker pendingLocker(&m_pendingLock);
+    if (!m_commands.push(command)) {
+        m_droppedCommands.fetch_add(1, std::memory_order_relaxed);
+        TLOG_WARN_EVERY("ReliableUDP", 1000, "Sender command queue full, command dropped");
+        return;
+    }
     
-    TelemetryPacket sendPacket = packet;
-    sendPacket.sequenceNumber = m_nextSequenceNumber++;
-    sendPacket.timestamp = QDateTime::currentDateTime();
+    // One wake-up per burst: the drain picks up everything queued before it runs
+    if (!m_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &ReliableUdpSender::drainCommands, Qt::QueuedConnection);
+    }
+}
+
+void ReliableUdpSender::drainCommands()
+{
+    // Clear with a read-modify-write: it reads the flag as the last producer
+    // left it, so anything pushed before that producer's exchange is visible
+    // to the pops below. A plain release store would not order the pops.
+    m_drainScheduled.exchange(false, std::memory_order_acq_rel);
+    
+    SenderCommand command;
+    while (m_commands.pop(command)) {
+        switch (command.type) {
+        case SenderCommand::SendTelemetry:
+            transmit(command.packet);
+            break;
+        case SenderCommand::SendSpokes:
+            transmitSpokes(command.spokes);
+            break;
+        case SenderCommand::SetTarget:
+            m_targetAddress = command.address;
+            m_targetPort = quint16(command.value);
+            TLOG_INFO("ReliableUDP Sender", "Target set to {}:{}", m_targetAddress.toString(), m_targetPort);
+            break;
+        case SenderCommand::SetAckTimeout:
+            m_ackTimeoutMs = command.value;
+            break;
+        case SenderCommand::SetMaxRetransmissions:
+            m_maxRetransmissions = command.value;
+            break;
+        case SenderCommand::SetReliabilityEnabled:
+            m_reliabilityEnabled = command.value != 0;
+            break;
+        }
+    }
+    
+    // Re-check before going idle so no command is ever left waiting for the
+    // next post(); a push landing here normally schedules its own drain
+    if (!m_commands.isEmpty() && !m_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, &ReliableUdpSender::drainCommands, Qt::QueuedConnection);
+    }
+}
+
+void ReliableUdpSender::transmit(TelemetryPacket sendPacket)
+{
     sendPacket.needsAck = m_reliabilityEnabled;
     
     QJsonDocument doc(sendPacket.toJson());
     QByteArray data = doc.toJson(QJsonDocument::Compact);
     
-    {
-        QMutexLocker socketLocker(&m_socketLock);
-        qint64 sent = m_socket->writeDatagram(data, m_targetAddress, m_targetPort);
-        
-        if (sent != -1) {
-            m_packetsSent++;
-            qDebug() << "ReliableUDP: Sent packet" << sendPacket.sequenceNumber;
-            printf("ReliableUDP: Sent packet seq=%d to %s:%d (%lld bytes)\n", sendPacket.sequenceNumber, 
-                   m_targetAddress.toString().toStdString().c_str(), m_targetPort, sent);
-            fflush(stdout);
-        } else {
-            qWarning() << "ReliableUDP: Failed to send packet:" << m_socket->errorString();
-            printf("ReliableUDP: FAILED to send packet: %s\n", m_socket->errorString().toStdString().c_str());
-            fflush(stdout);
-            return;
-        }
+    qint64 sent = m_socket->writeDatagram(data, m_targetAddress, m_targetPort);
+    
+    if (sent != -1) {
+        m_statistics->add(NetworkStatistics::PacketsSent);
+        m_statistics->add(NetworkStatistics::BytesSent, sent);
+        TLOG_DEBUG("ReliableUDP", "Sent packet seq={} to {}:{} ({} bytes)",
+                   sendPacket.sequenceNumber, m_targetAddress.toString(), m_targetPort, sent);
+    } else {
+        TLOG_WARN_EVERY("ReliableUDP", 1000, "Failed to send packet: {}", m_socket->errorString());
+        return;
     }
     
     // If reliability is enabled, track this packet for ACK
@@ -364,18 +641,30 @@ void ReliableUdpSender::sendTelemetryData(const TelemetryPacket &packet)
         
         m_pendingAcks[sendPacket.sequenceNumber] = pending;
     }
-    
-    emit statisticsUpdated();
+}
+
+void ReliableUdpSender::transmitSpokes(const QVector<SpokeMessage> &spokes)
+{
+    for (const SpokeMessage &spoke : spokes) {
+        qint64 sent = m_socket->writeDatagram(spoke.toDatagram(), m_targetAddress, m_targetPort);
+        if (sent == -1) {
+            // Usually a full send buffer; the receiver counts the gap
+            TLOG_WARN_EVERY("ReliableUDP", 1000, "Failed to send spoke: {}", m_socket->errorString());
+            continue;
+        }
+        m_statistics->add(NetworkStatistics::SpokesSent);
+        m_statistics->add(NetworkStatistics::BytesSent, sent);
+    }
 }
 
 void ReliableUdpSender::processIncomingAcks()
 {
-    QMutexLocker socketLocker(&m_socketLock);
-    
     while (m_socket->hasPendingDatagrams()) {
         QNetworkDatagram datagram = m_socket->receiveDatagram();
         
         if (datagram.isValid()) {
+            m_statistics->add(NetworkStatistics::BytesReceived, datagram.data().size());
+            
             QJsonParseError parseError;
             QJsonDocument doc = QJsonDocument::fromJson(datagram.data(), &parseError);
             
@@ -389,24 +678,19 @@ void ReliableUdpSender::processIncomingAcks()
             if (obj.contains("type") && obj["type"].toString() == "ACK") {
                 AckPacket ack = AckPacket::fromJson(obj);
                 
-                QMutexLocker pendingLocker(&m_pendingLock);
                 if (m_pendingAcks.contains(ack.sequenceNumber)) {
                     m_pendingAcks.remove(ack.sequenceNumber);
-                    m_acksReceived++;
+                    m_statistics->add(NetworkStatistics::AcksReceived);
                     emit ackReceived(ack.sequenceNumber);
-                    qDebug() << "ReliableUDP: Received ACK for packet" << ack.sequenceNumber;
+                    TLOG_TRACE("ReliableUDP", "Received ACK for packet {}", ack.sequenceNumber);
                 }
             }
         }
     }
-    
-    emit statisticsUpdated();
 }
 
 void ReliableUdpSender::checkForTimeouts()
 {
-    QMutexLocker locker(&m_pendingLock);
-    
     QDateTime cutoffTime = QDateTime::currentDateTime().addMSecs(-m_ackTimeoutMs);
     QList<quint32> timedOutPackets;
     
@@ -425,8 +709,9 @@ void ReliableUdpSender::checkForTimeouts()
         } else {
             // Give up
             m_pendingAcks.remove(seq);
+            m_statistics->add(NetworkStatistics::PacketsLost);
             emit packetTimeout(seq);
-            qWarning() << "ReliableUDP: Packet" << seq << "timed out after" << m_maxRetransmissions << "retries";
+            TLOG_WARN_EVERY("ReliableUDP", 1000, "Packet {} timed out after {} retries", seq, m_maxRetransmissions);
         }
     }
 }
@@ -444,16 +729,13 @@ void ReliableUdpSender::retransmitPacket(quint32 sequenceNumber)
     QJsonDocument doc(pending.packet.toJson());
     QByteArray data = doc.toJson(QJsonDocument::Compact);
     
-    QMutexLocker socketLocker(&m_socketLock);
     qint64 sent = m_socket->writeDatagram(data, m_targetAddress, m_targetPort);
     
     if (sent != -1) {
-        m_retransmissions++;
-        qDebug() << "ReliableUDP: Retransmitted packet" << sequenceNumber 
-                 << "(attempt" << pending.retransmissionCount << ")";
+        m_statistics->add(NetworkStatistics::Retransmissions);
+        m_statistics->add(NetworkStatistics::BytesSent, sent);
+        TLOG_DEBUG("ReliableUDP", "Retransmitted packet {} (attempt {})", sequenceNumber, pending.retransmissionCount);
     } else {
-        qWarning() << "ReliableUDP: Failed to retransmit packet:" << m_socket->errorString();
+        TLOG_WARN_EVERY("ReliableUDP", 1000, "Failed to retransmit packet: {}", m_socket->errorString());
     }
-    
-    emit statisticsUpdated();
 }
\ No newline at end of file
@@ -5,71 +5,21 @@
 #include <QUdpSocket>
 #include <QTimer>
 #include <QThread>
-#include <QMutex>
 #include <QQueue>
 #include <QDateTime>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QHash>
-#include <QReadWriteLock>
+#include <QMap>
+#include <QHostAddress>
+#include <atomic>
+#include "networkstatistics.h"
+#include "telemetrypacket.h"
+#include "jitterbuffer.h"
+#include "mpscqueue.h"
 
-struct TelemetryPacket {
-    quint32 sequenceNumber;
-    QDateTime timestamp;
-    double latitude;
-    double longitude;
-    double speed;
-    QString status;
-    bool needsAck;
-    
-    TelemetryPacket() : sequenceNumber(0), latitude(0), longitude(0), speed(0), needsAck(false) {}
-    
-    QJsonObject toJson() const {
-        QJsonObject obj;
-        obj["seq"] = static_cast<qint64>(sequenceNumber);
-        obj["timestamp"] = timestamp.toMSecsSinceEpoch();
-        obj["latitude"] = latitude;
-        obj["longitude"] = longitude;
-        obj["speed"] = speed;
-        obj["status"] = status;
-        obj["needsAck"] = needsAck;
-        return obj;
-    }
-    
-    static TelemetryPacket fromJson(const QJsonObject &obj) {
-        TelemetryPacket packet;
-        packet.sequenceNumber = static_cast<quint32>(obj["seq"].toInt());
-        packet.timestamp = QDateTime::fromMSecsSinceEpoch(obj["timestamp"].toVariant().toLongLong());
-        packet.latitude = obj["latitude"].toDouble();
-        packet.longitude = obj["longitude"].toDouble();
-        packet.speed = obj["speed"].toDouble();
-        packet.status = obj["status"].toString();
-        packet.needsAck = obj["needsAck"].toBool();
-        return packet;
-    }
-};
-
-struct AckPacket {
-    quint32 sequenceNumber;
-    QDateTime timestamp;
-    
-    QJsonObject toJson() const {
-        QJsonObject obj;
-        obj["type"] = "ACK";
-        obj["seq"] = static_cast<qint64>(sequenceNumber);
-        obj["timestamp"] = timestamp.toMSecsSinceEpoch();
-        return obj;
-    }
-    
-    static AckPacket fromJson(const QJsonObject &obj) {
-        AckPacket ack;
-        ack.sequenceNumber = static_cast<quint32>(obj["seq"].toInt());
-        ack.timestamp = QDateTime::fromMSecsSinceEpoch(obj["timestamp"].toVariant().toLongLong());
-        return ack;
-    }
-};
-
-// Thread-safe receiver with buffering
+// Receiver actor: all reliability state is owned by the thread the object
+// lives in. Other threads reach it only through the command queue.
 class ReliableUdpReceiver : public QObject
 {
     Q_OBJECT
@@ -78,68 +28,123 @@ public:
     explicit ReliableUdpReceiver(QObject *parent = nullptr);
     ~ReliableUdpReceiver();
     
+    // Must be called on the owning thread
     bool startListening(quint16 port = 12345);
     void stopListening();
     bool isListening() const;
     
-    // Reliability settings
-    void setInterpolationEnabled(bool enabled) { m_interpolationEnabled = enabled; }
-    void setMaxBufferSize(int size) { m_maxBufferSize = size; }
-    void setPacketTimeoutMs(int timeoutMs) { m_packetTimeoutMs = timeoutMs; }
+    // Reliability settings (any thread)
+    void setInterpolationEnabled(bool enabled) { post({ReceiverCommand::SetInterpolationEnabled, enabled ? 1 : 0}); }
+    void setMaxBufferSize(int size) { post({ReceiverCommand::SetMaxBufferSize, size}); }
+    void setPacketTimeoutMs(int timeoutMs) { post({ReceiverCommand::SetPacketTimeout, timeoutMs}); }
+    
+    // Playout smoothing (any thread). When enabled, each track is held in a
+    // jitter buffer and released in order after the playout delay.
+    void setJitterBufferEnabled(bool enabled) { post({ReceiverCommand::SetJitterBufferEnabled, enabled ? 1 : 0}); }
+    void setPlayoutDelayMs(int delayMs) { post({ReceiverCommand::SetPlayoutDelay, delayMs}); }
+    void setAdaptivePlayoutEnabled(bool enabled) { post({ReceiverCommand::SetAdaptivePlayout, enabled ? 1 : 0}); }
+    // A track's empty buffer is dropped once it has been silent this long
+    void setTrackTimeoutMs(int timeoutMs) { post({ReceiverCommand::SetTrackTimeout, timeoutMs}); }
     
     // Statistics
-    int getPacketsReceived() const { return m_packetsReceived; }
-    int getPacketsLost() const { return m_packetsLost; }
-    int getPacketsInterpolated() const { return m_packetsInterpolated; }
+    int getPacketsReceived() const { return int(m_statistics->value(NetworkStatistics::PacketsReceived)); }
+    int getPacketsLost() const { return int(m_statistics->value(NetworkStatistics::PacketsLost)); }
+    int getPacketsInterpolated() const { return int(m_statistics->value(NetworkStatistics::PacketsInterpolated)); }
     double getPacketLossRate() const;
+    NetworkStatistics *statistics() const { return m_statistics; }
 
 signals:
     void telemetryDataReceived(const TelemetryPacket &packet);
+    // One event per lost run, carrying the whole synthesized segment
+    void gapDetected(const QString &trackId, const SequenceRange &range,
+                     const QVector<TrajectorySample> &trajectory);
     void connectionStatusChanged(bool connected);
-    void statisticsUpdated();
+    void statisticsUpdated(const NetworkStatisticsSnapshot &snapshot);
+    // Radar video, every spoke from one pass over the socket in arrival order
+    void spokesReceived(const QVector<SpokeMessage> &spokes);
 
 private slots:
     void processPendingDatagrams();
     void checkForMissingPackets();
     void cleanupOldPackets();
+    void drainCommands();
+    void releaseDuePackets();
 
 private:
+    struct ReceiverCommand {
+        enum Type {
+            SetInterpolationEnabled,
+            SetMaxBufferSize,
+            SetPacketTimeout,
+            SetJitterBufferEnabled,
+            SetPlayoutDelay,
+            SetAdaptivePlayout,
+            SetTrackTimeout
+        };
+        Type type;
+        int value;
+    };
+    
+    void post(const ReceiverCommand &command);
     void sendAck(quint32 sequenceNumber, const QHostAddress &sender, quint16 senderPort);
     void processReceivedPacket(const TelemetryPacket &packet);
-    TelemetryPacket interpolatePacket(quint32 sequenceNumber);
-    void updateStatistics();
+    void advanceExpectedSequence();
+    void reportGap(const SequenceRange &range);
+    QVector<TrajectorySample> synthesizeGap(const SequenceRange &range, QString *trackId) const;
+    void schedulePlayout();
+    void flushJitterBuffers();
+    void pruneJitterBuffers(qint64 nowMs);
     
     QUdpSocket *m_socket;
     QTimer *m_timeoutTimer;
     QTimer *m_cleanupTimer;
+    QTimer *m_playoutTimer;
     
-    // Thread safety
-    mutable QReadWriteLock m_dataLock;
-    QMutex m_socketLock;
+    // Command mailbox, drained on the owning thread
+    MpscQueue<ReceiverCommand> m_commands;
+    std::atomic<bool> m_drainScheduled;
+    
+    // Buffering and reliability. m_receivedPackets holds everything from the
+    // last in-order packet (the interpolation anchor) up to the newest one.
+    struct ReceivedPacket {
+        TelemetryPacket packet;
+        qint64 arrivalMs;
+    };
     
-    // Buffering and reliability
-    QHash<quint32, TelemetryPacket> m_receivedPackets;
+    QMap<quint32, ReceivedPacket> m_receivedPackets;
     QQueue<TelemetryPacket> m_processingQueue;
-    quint32 m_expectedSequenceNumber;
+    bool m_hasReceivedPacket;
+    quint32 m_expectedSequenceNumber;           // Oldest sequence not yet received or declared lost
     quint32 m_lastValidSequenceNumber;
     TelemetryPacket m_lastValidPacket;
     
+    // Radar video bypasses reliability: a late spoke is worth less than the
+    // next one, so gaps are only counted
+    QVector<SpokeMessage> m_spokeBatch;
+    bool m_hasReceivedSpoke;
+    quint32 m_lastSpokeSequence;
+    
+    // Playout smoothing, one buffer per track
+    QHash<QString, JitterBuffer> m_jitterBuffers;
+    
     // Settings
     bool m_interpolationEnabled;
     int m_maxBufferSize;
     int m_packetTimeoutMs;
+    bool m_jitterBufferEnabled;
+    int m_playoutDelayMs;
+    bool m_adaptivePlayout;
+    int m_trackTimeoutMs;
     
     // Statistics
-    std::atomic<int> m_packetsReceived;
-    std::atomic<int> m_packetsLost;
-    std::atomic<int> m_packetsInterpolated;
-    std::atomic<int> m_acksSent;
+    NetworkStatistics *m_statistics;
     
     quint16 m_listeningPort;
-    bool m_isListening;
+    std::atomic<bool> m_isListening;
 };
 
-// Thread-safe sender with reliability
+// Sender actor: any thread may queue packets, only the owning thread
+// touches the socket and the pending-ACK table.
 class ReliableUdpSender : public QObject
 {
     Q_OBJECT
@@ -148,29 +153,56 @@ public:
     explicit ReliableUdpSender(QObject *parent = nullptr);
     ~ReliableUdpSender();
     
+    // All of these are safe to call from any thread
     void setTarget(const QHostAddress &address, quint16 port);
-    void sendTelemetryData(const TelemetryPacket &packet);
+    quint32 sendTelemetryData(const TelemetryPacket &packet); // Returns the assigned sequence number
+    void sendSpokes(const QVector<SpokeMessage> &spokes);     // Radar video, never acknowledged
     
     // Reliability settings
-    void setAckTimeoutMs(int timeoutMs) { m_ackTimeoutMs = timeoutMs; }
-    void setMaxRetransmissions(int maxRetries) { m_maxRetransmissions = maxRetries; }
-    void setReliabilityEnabled(bool enabled) { m_reliabilityEnabled = enabled; }
+    void setAckTimeoutMs(int timeoutMs);
+    void setMaxRetransmissions(int maxRetries);
+    void setReliabilityEnabled(bool enabled);
+    
+    quint64 droppedCommands() const { return m_droppedCommands.load(std::memory_order_relaxed); }
+    
+    // Statistics
+    NetworkStatistics *statistics() const { return m_statistics; }
 
 signals:
     void ackReceived(quint32 sequenceNumber);
     void packetTimeout(quint32 sequenceNumber);
-    void statisticsUpdated();
+    void statisticsUpdated(const NetworkStatisticsSnapshot &snapshot);
 
 private slots:
     void processIncomingAcks();
     void checkForTimeouts();
+    void drainCommands();
 
 private:
+    struct SenderCommand {
+        enum Type { SendTelemetry, SendSpokes, SetTarget, SetAckTimeout, SetMaxRetransmissions, SetReliabilityEnabled };
+        Type type;
+        TelemetryPacket packet;
+        QVector<SpokeMessage> spokes;
+        QHostAddress address;
+        int value;
+        
+        SenderCommand() : type(SendTelemetry), value(0) {}
+    };
+    
+    void post(const SenderCommand &command);
+    void transmit(TelemetryPacket packet);
+    void transmitSpokes(const QVector<SpokeMessage> &spokes);
     void retransmitPacket(quint32 sequenceNumber);
     
     QUdpSocket *m_socket;
     QTimer *m_timeoutTimer;
     
+    // Command mailbox, drained on the owning thread
+    MpscQueue<SenderCommand> m_commands;
+    std::atomic<bool> m_drainScheduled;
+    std::atomic<quint64> m_droppedCommands;
+    
     // Target
     QHostAddress m_targetAddress;
     quint16 m_targetPort;
@@ -183,21 +215,15 @@ private:
     };
     
     QHash<quint32, PendingPacket> m_pendingAcks;
-    quint32 m_nextSequenceNumber;
+    std::atomic<quint32> m_nextSequenceNumber;
     
-    // Settings
+    // Settings (owning thread)
     int m_ackTimeoutMs;
     int m_maxRetransmissions;
     bool m_reliabilityEnabled;
     
-    // Thread safety
-    QMutex m_pendingLock;
-    QMutex m_socketLock;
-    
     // Statistics
-    std::atomic<int> m_packetsSent;
-    std::atomic<int> m_acksReceived;
-    std::atomic<int> m_retransmissions;
+    NetworkStatistics *m_statistics;
 };
 
 #endif // RELIABLEUDP_H
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "scanconverter.h"
+#include "cpufeatures.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double TWO_PI = 6.283185307179586;
+
+#if defined(TELEMETRY_HAVE_SSE2)
+// pavgb rounds up, exactly like the scalar kernel
+void blendBytesSse2(quint8 *history, const quint8 *spoke, int count)
+{
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(history + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(spoke + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(history + i), _mm_avg_epu8(a, b));
+    }
+    ScanConverter::blendBytesScalar(history + i, spoke + i, count - i);
+}
+#endif
+
+#if defined(TELEMETRY_X86)
+TELEMETRY_TARGET_AVX2 void blendBytesAvx2(quint8 *history, const quint8 *spoke, int count)
+{
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(history + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(spoke + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(history + i), _mm256_avg_epu8(a, b));
+    }
+    ScanConverter::blendBytesScalar(history + i, spoke + i, count - i);
+}
+#endif
+
+struct BlendKernel {
+    void (*function)(quint8 *, const quint8 *, int);
+    const char *name;
+};
+
+const BlendKernel &blendKernel()
+{
+    static const BlendKernel kernel = []() -> BlendKernel {
+#if defined(TELEMETRY_X86)
+        if (CpuFeatures::hasAvx2()) {
+            return {blendBytesAvx2, "avx2"};
+        }
+#endif
+#if defined(TELEMETRY_HAVE_SSE2)
+        return {blendBytesSse2, "sse2"};
+#else
+        return {ScanConverter::blendBytesScalar, "scalar"};
+#endif
+    }();
+    return kernel;
+}
+
+} // namespace
+
+ScanConverter::ScanConverter()
+    : m_radius(0.0)
+    , m_displayRangeNM(0.0)
+    , m_devicePixelRatio(1.0)
+    , m_spokeCount(0)
+    , m_binCount(0)
+    , m_spokeRangeNM(0.0)
+    , m_scanAveraging(true)
+    , m_hasVideo(false)
+    , m_fullRedraw(false)
+    , m_tableDirty(true)
+    , m_binsDirty(true)
+{
+    setColor(QColor(255, 190, 40));
+}
+
+void ScanConverter::blendBytesScalar(quint8 *history, const quint8 *spoke, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        history[i] = quint8((history[i] + spoke[i] + 1) >> 1);
+    }
+}
+
+void ScanConverter::blendBytes(quint8 *history, const quint8 *spoke, int count)
+{
+    blendKernel().function(history, spoke, count);
+}
+
+const char *ScanConverter::blendKernelName()
+{
+    return blendKernel().name;
+}
+
+bool ScanConverter::setGeometry(const QPointF &center, double radius, double displayRangeNM, qreal devicePixelRatio)
+{
+    if (center != m_center || radius != m_radius || devicePixelRatio != m_devicePixelRatio || m_image.isNull()) {
+        m_center = center;
+        m_radius = radius;
+        m_devicePixelRatio = devicePixelRatio;
+        m_area = QRectF(center.x() - radius, center.y() - radius, radius * 2, radius * 2).toAlignedRect();
+        m_image = QImage(m_area.size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+        m_image.setDevicePixelRatio(devicePixelRatio);
+        m_image.fill(Qt::transparent);
+        m_tableDirty = true;
+        m_fullRedraw = true;
+    }
+    if (displayRangeNM != m_displayRangeNM) {
+        m_displayRangeNM = displayRangeNM;
+        m_binsDirty = true;
+        m_fullRedraw = true;
+    }
+    return m_fullRedraw && m_hasVideo;
+}
+
+void ScanConverter::setColor(const QColor &color)
+{
+    // Intensity sets the alpha, so weak echoes let the grid show through
+    for (int i = 0; i < 256; ++i) {
+        m_palette[i] = qPremultiply(qRgba(color.red(), color.green(), color.blue(), i));
+    }
+    m_fullRedraw = true;
+}
+
+void ScanConverter::clear()
+{
+    m_history.fill(0);
+    m_received.fill(false);
+    m_isPending.fill(false);
+    m_pending.clear();
+    m_hasVideo = false;
+    m_fullRedraw = false;
+    m_image.fill(Qt::transparent);
+}
+
+void ScanConverter::resetHistory(int spokeCount, int binCount, double rangeNM)
+{
+    if (spokeCount != m_spokeCount) {
+        m_tableDirty = true;
+    }
+    if (binCount != m_binCount || rangeNM != m_spokeRangeNM) {
+        m_binsDirty = true;
+    }
+    m_spokeCount = spokeCount;
+    m_binCount = binCount;
+    m_spokeRangeNM = rangeNM;
+
+    m_history.fill(0, spokeCount * binCount);
+    m_received.fill(false, spokeCount);
+    m_isPending.fill(false, spokeCount);
+    m_pending.clear();
+    m_fullRedraw = true;
+}
+
+void ScanConverter::addSpoke(const SpokeMessage &spoke)
+{
+    int binCount = spoke.bins.size();
+    if (spoke.azimuth >= spoke.spokesPerRevolution || binCount == 0) {
+        return;
+    }
+    if (spoke.spokesPerRevolution != m_spokeCount || binCount != m_binCount || spoke.rangeNM != m_spokeRangeNM) {
+        resetHistory(spoke.spokesPerRevolution, binCount, spoke.rangeNM);
+    }
+
+    int row = spoke.azimuth;
+    quint8 *history = m_history.data() + row * m_binCount;
+    const quint8 *bins = reinterpret_cast<const quint8 *>(spoke.bins.constData());
+    if (m_scanAveraging && m_received[row]) {
+        blendBytes(history, bins, m_binCount);
+    } else {
+        // Nothing to average with yet
+        std::memcpy(history, bins, m_binCount);
+        m_received[row] = true;
+    }
+
+    if (!m_isPending[row]) {
+        m_isPending[row] = true;
+        m_pending.append(row);
+    }
+    m_hasVideo = true;
+}
+
+void ScanConverter::rebuildTable()
+{
+    m_spokeStart.fill(0, m_spokeCount + 1);
+    m_pixelIndex.clear();
+    m_pixelRadius.clear();
+    if (m_image.isNull() || m_spokeCount == 0) {
+        return;
+    }
+
+    int width = m_image.width();
+    int height = m_image.height();
+    double cx = (m_center.x() - m_area.x()) * m_devicePixelRatio;
+    double cy = (m_center.y() - m_area.y()) * m_devicePixelRatio;
+    double radius = m_radius * m_devicePixelRatio;
+    double spokesPerRadian = m_spokeCount / TWO_PI;
+
+    // Nearest spoke of every pixel inside the disc, counted per spoke
+    const quint16 outside = 0xFFFF;
+    QVector<quint16> spokeOf(width * height, outside);
+    for (int y = 0; y < height; ++y) {
+        double dy = y + 0.5 - cy;
+        for (int x = 0; x < width; ++x) {
+            double dx = x + 0.5 - cx;
+            if (dx * dx + dy * dy > radius * radius) {
+                continue;
+            }
+            // Clockwise from north, with screen y pointing south
+            double azimuth = std::atan2(dx, -dy);
+            if (azimuth < 0) {
+                azimuth += TWO_PI;
+            }
+            int spoke = int(azimuth * spokesPerRadian + 0.5) % m_spokeCount;
+            spokeOf[y * width + x] = quint16(spoke);
+            ++m_spokeStart[spoke + 1];
+        }
+    }
+    for (int spoke = 0; spoke < m_spokeCount; ++spoke) {
+        m_spokeStart[spoke + 1] += m_spokeStart[spoke];
+    }
+
+    // Counting sort: group the pixels by spoke, keeping raster order
+    int entries = m_spokeStart[m_spokeCount];
+    m_pixelIndex.resize(entries);
+    m_pixelRadius.resize(entries);
+    QVector<int> cursor = m_spokeStart;
+    for (int y = 0; y < height; ++y) {
+        double dy = y + 0.5 - cy;
+        for (int x = 0; x < width; ++x) {
+            quint16 spoke = spokeOf[y * width + x];
+            if (spoke == outside) {
+                continue;
+            }
+            double dx = x + 0.5 - cx;
+            int entry = cursor[spoke]++;
+            m_pixelIndex[entry] = quint32(y * width + x);
+            m_pixelRadius[entry] = float(std::sqrt(dx * dx + dy * dy) / radius);
+        }
+    }
+}
+
+void ScanConverter::rebuildBins()
+{
+    int entries = m_pixelRadius.size();
+    m_pixelBin.resize(entries);
+    if (m_spokeRangeNM <= 0.0) {
+        m_pixelBin.fill(NO_BIN);
+        return;
+    }
+
+    // Range changes only rescale the radius -> bin mapping, no trigonometry
+    double binsPerRadius = m_displayRangeNM / m_spokeRangeNM * m_binCount;
+    const float *radius = m_pixelRadius.constData();
+    quint16 *bin = m_pixelBin.data();
+    for (int i = 0; i < entries; ++i) {
+        // The far edge of the last bin still belongs to it
+        double position = radius[i] * binsPerRadius;
+        bin[i] = position <= m_binCount ? quint16(qMin(int(position), m_binCount - 1)) : NO_BIN;
+    }
+}
+
+void ScanConverter::convertSpoke(int spoke, QRgb *pixels) const
+{
+    const quint8 *row = m_history.constData() + spoke * m_binCount;
+    const quint32 *pixelIndex = m_pixelIndex.constData();
+    const quint16 *pixelBin = m_pixelBin.constData();
+    int end = m_spokeStart[spoke + 1];
+    for (int i = m_spokeStart[spoke]; i < end; ++i) {
+        quint16 bin = pixelBin[i];
+        pixels[pixelIndex[i]] = bin == NO_BIN ? 0 : m_palette[row[bin]];
+    }
+}
+
+QRect ScanConverter::spokeBounds(int spoke) const
+{
+    if (m_spokeCount < 8) {
+        return m_area;
+    }
+
+    // The wedge from the centre out to the last bin
+    double reach = m_radius * qMin(1.0, m_spokeRangeNM / m_displayRangeNM);
+    double step = TWO_PI / m_spokeCount;
+    double minX = m_center.x(), maxX = minX, minY = m_center.y(), maxY = minY;
+    for (double offset : {-0.5, 0.0, 0.5}) {
+        double azimuth = (spoke + offset) * step;
+        double x = m_center.x() + reach * std::sin(azimuth);
+        double y = m_center.y() - reach * std::cos(azimuth);
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    }
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY)).toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
+QRect ScanConverter::update()
+{
+    if (m_image.isNull() || m_spokeCount == 0 || m_displayRangeNM <= 0.0) {
+        // Nothing to draw into yet; the next setGeometry() redraws in full
+        for (int spoke : m_pending) {
+            m_isPending[spoke] = false;
+        }
+        m_pending.clear();
+        return QRect();
+    }
+    if (m_tableDirty) {
+        rebuildTable();
+        m_tableDirty = false;
+        m_binsDirty = true;
+    }
+    if (m_binsDirty) {
+        rebuildBins();
+        m_binsDirty = false;
+    }
+
+    QRect changed;
+    if (m_fullRedraw) {
+        m_image.fill(Qt::transparent);
+        QRgb *pixels = reinterpret_cast<QRgb *>(m_image.bits());
+        for (int spoke = 0; spoke < m_spokeCount; ++spoke) {
+            if (m_received[spoke]) {
+                convertSpoke(spoke, pixels);
+            }
+        }
+        changed = m_area;
+        m_fullRedraw = false;
+    } else if (!m_pending.isEmpty()) {
+        // The widget only updates while no scene shares the image, so bits()
+        // does not copy; one call covers every spoke since the last frame
+        QRgb *pixels = reinterpret_cast<QRgb *>(m_image.bits());
+        for (int spoke : m_pending) {
+            convertSpoke(spoke, pixels);
+            changed |= spokeBounds(spoke);
+        }
+    }
+
+    for (int spoke : m_pending) {
+        m_isPending[spoke] = false;
+    }
+    m_pending.clear();
+    return changed.intersected(m_area);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef SCANCONVERTER_H
+#define SCANCONVERTER_H
+
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QRect>
+#include <QVector>
+#include <array>
+#include "telemetrypacket.h"
+
+// Polar to Cartesian conversion of raw radar video. Spokes are averaged
+// into a spokes x bins history as they arrive, then written into a
+// premultiplied ARGB raster through a lookup table built once per
+// geometry. The table is pixel-major: every raster pixel belongs to
+// exactly one spoke, so the display has no holes near the rim however few
+// spokes there are, and updating a spoke touches only its own pixels.
+class ScanConverter
+{
+public:
+    ScanConverter();
+
+    // Disc to fill, in widget coordinates, and the range its edge stands for.
+    // Returns true when the raster needs a full redraw, done by update().
+    bool setGeometry(const QPointF &center, double radius, double displayRangeNM, qreal devicePixelRatio);
+    void setColor(const QColor &color);
+    void clear();
+
+    // Scan-to-scan averaging: each spoke is blended 50/50 with the one
+    // received at the same azimuth a revolution earlier, which steadies
+    // targets and thins out noise. Off, the newest spoke replaces it.
+    void setScanAveraging(bool enabled) { m_scanAveraging = enabled; }
+    bool scanAveraging() const { return m_scanAveraging; }
+
+    // Into the polar history only; pixels are written by update(). A spoke
+    // with a different spoke count, bin count or range starts a new history.
+    void addSpoke(const SpokeMessage &spoke);
+    bool hasPendingSpokes() const { return !m_pending.isEmpty() || (m_fullRedraw && m_hasVideo); }
+
+    // Write the spokes added since the last call into the raster, or all of
+    // them after a geometry or format change. Returns the widget-space
+    // bounds of what changed.
+    QRect update();
+
+    bool isActive() const { return m_hasVideo && !m_image.isNull(); }
+    QRect area() const { return m_area; }
+    const QImage &image() const { return m_image; }
+
+    int spokeCount() const { return m_spokeCount; }
+    int binCount() const { return m_binCount; }
+
+    // Kernel: history[i] = (history[i] + spoke[i] + 1) >> 1. Uses the widest
+    // instruction set available at run time; all paths are bit-identical.
+    static void blendBytes(quint8 *history, const quint8 *spoke, int count);
+    static void blendBytesScalar(quint8 *history, const quint8 *spoke, int count);
+    static const char *blendKernelName();
+
+private:
+    static constexpr quint16 NO_BIN = 0xFFFF;  // Pixel beyond the last range bin
+
+    void resetHistory(int spokeCount, int binCount, double rangeNM);
+    void rebuildTable();
+    void rebuildBins();
+    void convertSpoke(int spoke, QRgb *pixels) const;
+    QRect spokeBounds(int spoke) const;
+
+    // Raster
+    QImage m_image;
+    QRect m_area;                    // Widget rect covered by the image
+    QPointF m_center;
+    double m_radius;                 // Widget pixels
+    double m_displayRangeNM;
+    qreal m_devicePixelRatio;
+    std::array<QRgb, 256> m_palette; // Intensity -> premultiplied colour
+
+    // Polar history, m_spokeCount rows of m_binCount intensities
+    QVector<quint8> m_history;
+    QVector<bool> m_received;        // Spoke seen since the history was reset
+    int m_spokeCount;
+    int m_binCount;
+    double m_spokeRangeNM;           // Far edge of the last bin
+    bool m_scanAveraging;
+    bool m_hasVideo;
+
+    // Spokes waiting for update(), each listed once
+    QVector<int> m_pending;
+    QVector<bool> m_isPending;
+    bool m_fullRedraw;
+
+    // Lookup table: the pixels of spoke s are entries
+    // m_spokeStart[s] .. m_spokeStart[s + 1] - 1, in raster order
+    QVector<int> m_spokeStart;
+    QVector<quint32> m_pixelIndex;   // Offset into the raster
+    QVector<float> m_pixelRadius;    // Fraction of the disc radius
+    QVector<quint16> m_pixelBin;     // Range bin, or NO_BIN
+    bool m_tableDirty;               // Raster size or spoke count changed
+    bool m_binsDirty;                // Either range or the bin count changed
+};
+
+#endif // SCANCONVERTER_H
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "spatialgrid.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize)
+{
+    setCellSize(cellSize);
+}
+
+void SpatialGrid::setCellSize(float cellSize)
+{
+    m_cellSize = qMax(1.0f, cellSize);
+    m_inverseCellSize = 1.0f / m_cellSize;
+    clear();
+}
+
+quint64 SpatialGrid::cellKey(float x, float y) const
+{
+    return packKey(qint32(std::floor(x * m_inverseCellSize)),
+                   qint32(std::floor(y * m_inverseCellSize)));
+}
+
+void SpatialGrid::insert(int id, float x, float y)
+{
+    quint64 key = cellKey(x, y);
+    m_cells[key].append({id, x, y});
+    m_cellOf.insert(id, key);
+}
+
+void SpatialGrid::move(int id, float x, float y)
+{
+    auto it = m_cellOf.find(id);
+    if (it == m_cellOf.end()) {
+        insert(id, x, y);
+        return;
+    }
+
+    quint64 key = cellKey(x, y);
+    if (key == it.value()) {
+        // Same cell: just refresh the stored point
+        QVector<Entry> &cell = m_cells[key];
+        for (Entry &entry : cell) {
+            if (entry.id == id) {
+                entry.x = x;
+                entry.y = y;
+                break;
+            }
+        }
+        return;
+    }
+
+    eraseFromCell(it.value(), id);
+    m_cells[key].append({id, x, y});
+    it.value() = key;
+}
+
+void SpatialGrid::remove(int id)
+{
+    auto it = m_cellOf.find(id);
+    if (it == m_cellOf.end()) {
+        return;
+    }
+    eraseFromCell(it.value(), id);
+    m_cellOf.erase(it);
+}
+
+void SpatialGrid::renumber(int from, int to)
+{
+    auto it = m_cellOf.find(from);
+    if (it == m_cellOf.end() || from == to) {
+        return;
+    }
+
+    quint64 key = it.value();
+    m_cellOf.erase(it);
+    m_cellOf.insert(to, key);
+
+    for (Entry &entry : m_cells[key]) {
+        if (entry.id == from) {
+            entry.id = to;
+            break;
+        }
+    }
+}
+
+void SpatialGrid::clear()
+{
+    m_cells.clear();
+    m_cellOf.clear();
+}
+
+void SpatialGrid::eraseFromCell(quint64 key, int id)
+{
+    auto cellIt = m_cells.find(key);
+    if (cellIt == m_cells.end()) {
+        return;
+    }
+
+    QVector<Entry> &cell = cellIt.value();
+    for (int i = 0; i < cell.size(); ++i) {
+        if (cell[i].id == id) {
+            cell[i] = cell.last();
+            cell.removeLast();
+            break;
+        }
+    }
+    if (cell.isEmpty()) {
+        m_cells.erase(cellIt);
+    }
+}
+
+void SpatialGrid::query(const QRectF &rect, QVector<int> &out) const
+{
+    qint32 x0 = qint32(std::floor(rect.left() * m_inverseCellSize));
+    qint32 x1 = qint32(std::floor(rect.right() * m_inverseCellSize));
+    qint32 y0 = qint32(std::floor(rect.top() * m_inverseCellSize));
+    qint32 y1 = qint32(std::floor(rect.bottom() * m_inverseCellSize));
+
+    // Rect covers more cells than are occupied: scanning those is cheaper
+    if (qint64(x1 - x0 + 1) * qint64(y1 - y0 + 1) > qint64(m_cells.size())) {
+        for (auto it = m_cells.constBegin(); it != m_cells.constEnd(); ++it) {
+            for (const Entry &entry : it.value()) {
+                if (rect.contains(entry.x, entry.y)) {
+                    out.append(entry.id);
+                }
+            }
+        }
+        return;
+    }
+
+    for (qint32 cy = y0; cy <= y1; ++cy) {
+        for (qint32 cx = x0; cx <= x1; ++cx) {
+            auto it = m_cells.constFind(packKey(cx, cy));
+            if (it == m_cells.constEnd()) {
+                continue;
+            }
+            bool inner = cx > x0 && cx < x1 && cy > y0 && cy < y1;
+            for (const Entry &entry : it.value()) {
+                if (inner || rect.contains(entry.x, entry.y)) {
+                    out.append(entry.id);
+                }
+            }
+        }
+    }
+}
+
+QRectF SpatialGrid::cellRect(float x, float y) const
+{
+    float left = std::floor(x * m_inverseCellSize) * m_cellSize;
+    float top = std::floor(y * m_inverseCellSize) * m_cellSize;
+    return QRectF(left, top, m_cellSize, m_cellSize);
+}
+
+void SpatialGrid::cellIds(float x, float y, QVector<int> &out) const
+{
+    auto it = m_cells.constFind(cellKey(x, y));
+    if (it == m_cells.constEnd()) {
+        return;
+    }
+    for (const Entry &entry : it.value()) {
+        out.append(entry.id);
+    }
+}
\ No newline at end of file
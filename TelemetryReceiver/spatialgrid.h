@@ -0,0 +1,51 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+// Uniform hash grid over screen-space points. Each id lives in exactly one
+// cell; moving or removing it touches only that cell, so the index can be
+// kept up to date incrementally instead of being rebuilt every frame.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 32.0f);
+
+    void setCellSize(float cellSize);
+    float cellSize() const { return m_cellSize; }
+
+    void insert(int id, float x, float y);
+    void move(int id, float x, float y);
+    void remove(int id);
+    void renumber(int from, int to);        // Id `from` is now known as `to`
+    void clear();
+
+    // Appends the ids whose point lies in rect
+    void query(const QRectF &rect, QVector<int> &out) const;
+
+    // The cell containing a point: its key, its extent, and the ids it holds
+    quint64 cellKey(float x, float y) const;
+    QRectF cellRect(float x, float y) const;
+    void cellIds(float x, float y, QVector<int> &out) const;
+
+    int size() const { return m_cellOf.size(); }
+
+private:
+    struct Entry {
+        int id;
+        float x;
+        float y;
+    };
+
+    static quint64 packKey(qint32 cx, qint32 cy) { return (quint64(quint32(cx)) << 32) | quint32(cy); }
+    void eraseFromCell(quint64 key, int id);
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    QHash<quint64, QVector<Entry>> m_cells;
+    QHash<int, quint64> m_cellOf;              // Id -> cell key
+};
+
+#endif // SPATIALGRID_H
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "spokesynth.h"
+#include <cmath>
+#include "radarmath.h"
+
+namespace {
+constexpr double LN2 = 0.69314718055994531;
+}
+
+SpokeSynthesizer::SpokeSynthesizer()
+    : m_random(1)
+    , m_sequence(0)
+    , m_azimuth(0)
+    , m_startMs(-1)
+{
+    // Inverse CDF at the middle of each of 4096 equal-probability slices,
+    // over the distribution's mean of sqrt(pi) / 2. Enough slices that the
+    // tail reaches past the default CFAR threshold.
+    int slices = int(m_rayleigh.size());
+    for (int i = 0; i < slices; ++i) {
+        m_rayleigh[i] = float(std::sqrt(-std::log(1.0 - (i + 0.5) / slices)) / 0.88622692545275801);
+    }
+    setSettings(Settings());
+}
+
+void SpokeSynthesizer::setSettings(const Settings &settings)
+{
+    m_settings = settings;
+    m_settings.spokesPerRevolution = qBound(1, settings.spokesPerRevolution, int(SpokeMessage::MAX_SPOKES));
+    m_settings.binCount = qBound(1, settings.binCount, int(SpokeMessage::MAX_BINS));
+    m_settings.rangeNM = qMax(0.01, settings.rangeNM);
+    m_settings.clutterRangeNM = qMax(0.001, settings.clutterRangeNM);
+    m_settings.beamwidth = qMax(0.01, settings.beamwidth);
+
+    int count = m_settings.binCount;
+    double binNM = m_settings.rangeNM / count;
+    m_background.resize(count);
+    m_levels.resize(count);
+    for (int bin = 0; bin < count; ++bin) {
+        double range = (bin + 0.5) * binNM;
+        m_background[bin] = float(m_settings.noiseLevel
+                                  + m_settings.clutterLevel * std::exp(-range / m_settings.clutterRangeNM));
+    }
+    restart();
+}
+
+void SpokeSynthesizer::restart()
+{
+    m_random = m_settings.seed;
+    m_sequence = 0;
+    m_azimuth = 0;
+    m_startMs = -1;
+}
+
+void SpokeSynthesizer::targetPosition(const Target &target, double elapsedSeconds, double &bearing, double &range)
+{
+    RadarMath::UnitVector start = RadarMath::fastBearingVector(target.bearing);
+    RadarMath::UnitVector heading = RadarMath::fastBearingVector(target.course);
+    double travelled = target.speedKnots * elapsedSeconds / 3600.0;
+    double east = target.range * start.east + travelled * heading.east;
+    double north = target.range * start.north + travelled * heading.north;
+    range = std::sqrt(east * east + north * north);
+    bearing = std::atan2(east, north) / RadarMath::DEG_TO_RAD;
+    if (bearing < 0.0) bearing += 360.0;
+}
+
+void SpokeSynthesizer::synthesize(int azimuth, double elapsedSeconds, quint8 *bins)
+{
+    int count = m_settings.binCount;
+    double binNM = m_settings.rangeNM / count;
+    float *levels = m_levels.data();
+
+    // Speckle: each bin an independent draw around its mean
+    const float *background = m_background.constData();
+    for (int bin = 0; bin < count; ++bin) {
+        m_random = m_random * 1664525u + 1013904223u;
+        levels[bin] = background[bin] * m_rayleigh[m_random >> 20];
+    }
+
+    double spokeBearing = azimuth * 360.0 / m_settings.spokesPerRevolution;
+    for (const Target &target : m_targets) {
+        double bearing, range;
+        targetPosition(target, elapsedSeconds, bearing, range);
+
+        // The echo is the target's own extent smeared by the beam
+        double size = qMax(target.size, binNM);
+        double angularSize = std::atan2(size, qMax(range, size)) / RadarMath::DEG_TO_RAD;
+        double halfWidth = std::sqrt(0.25 * m_settings.beamwidth * m_settings.beamwidth + angularSize * angularSize);
+        double offset = std::remainder(spokeBearing - bearing, 360.0);
+        if (std::fabs(offset) > 3.0 * halfWidth) continue;
+        double peak = target.amplitude * std::exp(-LN2 * (offset / halfWidth) * (offset / halfWidth));
+
+        int first = qMax(0, int((range - 3.0 * size) / binNM));
+        int last = qMin(count - 1, int((range + 3.0 * size) / binNM));
+        for (int bin = first; bin <= last; ++bin) {
+            double distance = ((bin + 0.5) * binNM - range) / size;
+            levels[bin] += float(peak * std::exp(-LN2 * distance * distance));
+        }
+    }
+
+    for (int bin = 0; bin < count; ++bin) {
+        bins[bin] = quint8(qMin(255.0f, levels[bin]));
+    }
+}
+
+void SpokeSynthesizer::noiseDistribution(int bin, std::array<double, 256> &probability) const
+{
+    // Every slice is equally likely, and saturates and truncates as in synthesize()
+    probability.fill(0.0);
+    if (bin < 0 || bin >= m_background.size()) return;
+    double slice = 1.0 / m_rayleigh.size();
+    float background = m_background[bin];
+    for (float quantile : m_rayleigh) {
+        probability[quint8(qMin(255.0f, background * quantile))] += slice;
+    }
+}
+
+SpokeMessage SpokeSynthesizer::nextSpoke(qint64 timestampMs)
+{
+    if (m_startMs < 0) {
+        m_startMs = timestampMs;
+    }
+
+    SpokeMessage spoke;
+    spoke.sequenceNumber = m_sequence++;
+    spoke.timestampMs = timestampMs;
+    spoke.azimuth = quint16(m_azimuth);
+    spoke.spokesPerRevolution = quint16(m_settings.spokesPerRevolution);
+    spoke.rangeNM = m_settings.rangeNM;
+    spoke.bins = QByteArray(m_settings.binCount, '\0');
+    synthesize(m_azimuth, (timestampMs - m_startMs) / 1000.0, reinterpret_cast<quint8 *>(spoke.bins.data()));
+
+    m_azimuth = (m_azimuth + 1) % m_settings.spokesPerRevolution;
+    return spoke;
+}
+
+void SpokeSynthesizer::skip(quint64 count)
+{
+    int revolution = m_settings.spokesPerRevolution;
+    m_sequence += quint32(count);
+    m_azimuth = int((m_azimuth + count % quint64(revolution)) % quint64(revolution));
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef SPOKESYNTH_H
+#define SPOKESYNTH_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+#include "telemetrypacket.h"
+
+// Synthetic radar video for testing without a radar: receiver noise, sea
+// clutter falling off with range, and targets drawn as two-dimensional
+// Gaussian echoes that move along their course. Noise and clutter are
+// Rayleigh distributed, like the output of a radar's envelope detector,
+// so CFAR sees realistic speckle. Deterministic for a given seed.
+class SpokeSynthesizer
+{
+public:
+    struct Target {
+        double bearing = 0.0;            // Degrees from north, at time zero
+        double range = 1.0;              // Nautical miles, at time zero
+        double course = 0.0;             // Degrees
+        double speedKnots = 0.0;
+        double size = 0.03;              // Echo radius in range, nautical miles
+        int amplitude = 160;             // Peak level above the background
+    };
+
+    struct Settings {
+        int spokesPerRevolution = 4096;
+        int binCount = 1024;
+        double rangeNM = 24.0;
+        int noiseLevel = 10;             // Mean receiver noise
+        int clutterLevel = 60;           // Mean sea clutter at zero range
+        double clutterRangeNM = 2.0;     // Clutter falls by 1/e over this distance
+        double beamwidth = 1.2;          // Degrees, half power
+        quint32 seed = 1;
+    };
+
+    SpokeSynthesizer();
+
+    void setSettings(const Settings &settings);
+    const Settings &settings() const { return m_settings; }
+
+    void setTargets(const QVector<Target> &targets) { m_targets = targets; }
+    const QVector<Target> &targets() const { return m_targets; }
+
+    // The next spoke in rotation. Targets move with timestampMs, counted
+    // from the first spoke; sequence numbers count up from zero.
+    SpokeMessage nextSpoke(qint64 timestampMs);
+    // Move on by count spokes without generating them. The antenna stays on
+    // schedule and the sequence numbers show the gap.
+    void skip(quint64 count);
+    void restart();
+
+    // One spoke's intensities at the given azimuth and time since start
+    void synthesize(int azimuth, double elapsedSeconds, quint8 *bins);
+    // Probability of each level at a bin with no target on it
+    void noiseDistribution(int bin, std::array<double, 256> &probability) const;
+
+    // Where a target is after elapsedSeconds
+    static void targetPosition(const Target &target, double elapsedSeconds, double &bearing, double &range);
+
+private:
+    Settings m_settings;
+    QVector<Target> m_targets;
+    quint32 m_random;
+    quint32 m_sequence;
+    int m_azimuth;
+    qint64 m_startMs;                    // Timestamp of the first spoke, -1 before it
+    QVector<float> m_background;         // Mean noise plus clutter per bin
+    QVector<float> m_levels;             // Scratch, one spoke
+    std::array<float, 4096> m_rayleigh;  // Unit-mean Rayleigh quantiles
+};
+
+#endif // SPOKESYNTH_H
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef TELEMETRYDATA_H
+#define TELEMETRYDATA_H
+
+#include <QString>
+#include <QMetaType>
+
+// One decoded position report, as the display consumes it
+struct TelemetryData {
+    double latitude;
+    double longitude;
+    double speed;
+    QString status;
+    QString trackId;
+    
+    TelemetryData() : latitude(0.0), longitude(0.0), speed(0.0), status("OK"), trackId("SHIP") {}
+    TelemetryData(double lat, double lon, double spd, const QString &st, const QString &id = "SHIP") 
+        : latitude(lat), longitude(lon), speed(spd), status(st), trackId(id) {}
+};
+
+Q_DECLARE_METATYPE(TelemetryData)
+
+#endif // TELEMETRYDATA_H
@@ -0,0 +1,148 @@
+#ifndef TELEMETRYPACKET_H
+#define TELEMETRYPACKET_H
+
+#include <QString>
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QMetaType>
+#include <QVector>
+
+struct TelemetryPacket {
+    quint32 sequenceNumber;
+    QDateTime timestamp;
+    double latitude;
+    double longitude;
+    double speed;
+    QString status;
+    QString trackId;
+    bool needsAck;
+    
+    TelemetryPacket() : sequenceNumber(0), latitude(0), longitude(0), speed(0), trackId("SHIP"), needsAck(false) {}
+    
+    QJsonObject toJson() const {
+        QJsonObject obj;
+        obj["seq"] = static_cast<qint64>(sequenceNumber);
+        obj["timestamp"] = timestamp.toMSecsSinceEpoch();
+        obj["latitude"] = latitude;
+        obj["longitude"] = longitude;
+        obj["speed"] = speed;
+        obj["status"] = status;
+        obj["trackId"] = trackId;
+        obj["needsAck"] = needsAck;
+        return obj;
+    }
+    
+    static TelemetryPacket fromJson(const QJsonObject &obj) {
+        TelemetryPacket packet;
+        packet.sequenceNumber = static_cast<quint32>(obj["seq"].toInt());
+        packet.timestamp = QDateTime::fromMSecsSinceEpoch(obj["timestamp"].toVariant().toLongLong());
+        packet.latitude = obj["latitude"].toDouble();
+        packet.longitude = obj["longitude"].toDouble();
+        packet.speed = obj["speed"].toDouble();
+        packet.status = obj["status"].toString();
+        packet.trackId = obj["trackId"].toString("SHIP"); // Older senders have a single ship
+        packet.needsAck = obj["needsAck"].toBool();
+        return packet;
+    }
+};
+
+// Inclusive run of sequence numbers
+struct SequenceRange {
+    quint32 first;
+    quint32 last;
+    
+    SequenceRange() : first(0), last(0) {}
+    SequenceRange(quint32 firstSeq, quint32 lastSeq) : first(firstSeq), last(lastSeq) {}
+    
+    int count() const { return int(last - first) + 1; }
+};
+
+// Compact position sample used for synthesized (gap-fill) trajectories
+struct TrajectorySample {
+    quint32 sequenceNumber;
+    bool interpolated;           // false when the last known position was held
+    qint64 timestampMs;
+    double latitude;
+    double longitude;
+    double speed;
+};
+Q_DECLARE_TYPEINFO(TrajectorySample, Q_PRIMITIVE_TYPE);
+
+struct AckPacket {
+    quint32 sequenceNumber;
+    QDateTime timestamp;
+    
+    QJsonObject toJson() const {
+        QJsonObject obj;
+        obj["type"] = "ACK";
+        obj["seq"] = static_cast<qint64>(sequenceNumber);
+        obj["timestamp"] = timestamp.toMSecsSinceEpoch();
+        return obj;
+    }
+    
+    static AckPacket fromJson(const QJsonObject &obj) {
+        AckPacket ack;
+        ack.sequenceNumber = static_cast<quint32>(obj["seq"].toInt());
+        ack.timestamp = QDateTime::fromMSecsSinceEpoch(obj["timestamp"].toVariant().toLongLong());
+        return ack;
+    }
+};
+
+// One radar video spoke: intensities along a single azimuth, nearest range
+// bin first. Sent as binary, since a full-rate stream is thousands of
+// these a second; the magic number tells them apart from JSON datagrams.
+struct SpokeMessage {
+    static constexpr quint32 MAGIC = 0x53504B31;   // "SPK1"
+    static constexpr int MAX_SPOKES = 16384;
+    static constexpr int MAX_BINS = 4096;
+    
+    quint32 sequenceNumber;
+    qint64 timestampMs;
+    quint16 azimuth;                 // Spoke index, 0 = north, clockwise
+    quint16 spokesPerRevolution;
+    double rangeNM;                  // Far edge of the last bin
+    QByteArray bins;                 // One intensity byte per range bin
+    
+    SpokeMessage() : sequenceNumber(0), timestampMs(0), azimuth(0), spokesPerRevolution(0), rangeNM(0) {}
+    
+    QByteArray toDatagram() const {
+        QByteArray datagram;
+        datagram.reserve(bins.size() + 40);
+        QDataStream out(&datagram, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << MAGIC << sequenceNumber << timestampMs << azimuth << spokesPerRevolution << rangeNM << bins;
+        return datagram;
+    }
+    
+    static bool isSpokeDatagram(const QByteArray &datagram) {
+        return datagram.size() >= 4
+               && quint8(datagram[0]) == (MAGIC >> 24) && quint8(datagram[1]) == ((MAGIC >> 16) & 0xFF)
+               && quint8(datagram[2]) == ((MAGIC >> 8) & 0xFF) && quint8(datagram[3]) == (MAGIC & 0xFF);
+    }
+    
+    // False for anything truncated or out of range
+    static bool fromDatagram(const QByteArray &datagram, SpokeMessage &spoke) {
+        QDataStream in(datagram);
+        in.setVersion(QDataStream::Qt_5_12);
+        quint32 magic = 0;
+        in >> magic >> spoke.sequenceNumber >> spoke.timestampMs >> spoke.azimuth
+           >> spoke.spokesPerRevolution >> spoke.rangeNM >> spoke.bins;
+        return in.status() == QDataStream::Ok && magic == MAGIC
+               && spoke.spokesPerRevolution > 0 && spoke.spokesPerRevolution <= MAX_SPOKES
+               && spoke.azimuth < spoke.spokesPerRevolution
+               && spoke.rangeNM > 0 && spoke.rangeNM < 100000.0
+               && !spoke.bins.isEmpty() && spoke.bins.size() <= MAX_BINS;
+    }
+};
+
+Q_DECLARE_METATYPE(TelemetryPacket)
+Q_DECLARE_METATYPE(SequenceRange)
+Q_DECLARE_METATYPE(QVector<TrajectorySample>)
+Q_DECLARE_METATYPE(SpokeMessage)
+Q_DECLARE_METATYPE(QVector<SpokeMessage>)
+
+#endif // TELEMETRYPACKET_H
\ No newline at end of file
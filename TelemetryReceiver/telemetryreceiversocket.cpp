@@ -149,6 +149,7 @@ TelemetryData TelemetryReceiverSocket::parseTelemetryData(const QByteArray &data
     telemetryData.longitude = obj.value("longitude").toDouble();
     telemetryData.speed = obj.value("speed").toDouble();
     telemetryData.status = obj.value("status").toString();
+    telemetryData.trackId = obj.value("trackId").toString("SHIP");
     
     return telemetryData;
 }
@@ -6,19 +6,7 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QTimer>
-
-struct TelemetryData {
-    double latitude;
-    double longitude;
-    double speed;
-    QString status;
-    
-    TelemetryData() : latitude(0.0), longitude(0.0), speed(0.0), status("OK") {}
-    TelemetryData(double lat, double lon, double spd, const QString &st) 
-        : latitude(lat), longitude(lon), speed(spd), status(st) {}
-};
-
-Q_DECLARE_METATYPE(TelemetryData)
+#include "telemetrydata.h"
 
 class TelemetryReceiverSocket : public QObject
 {
@@ -0,0 +1,379 @@
+#include "trackstore.h"
+#include <algorithm>
+#include <cmath>
+
+TrackStore::TrackStore()
+    : m_center(0, 0)
+    , m_pixelsPerNM(1.0)
+{
+}
+
+int TrackStore::upsert(const QString &trackId, const Geodesy::Fix &fix,
+                       double latitude, double longitude, float strength, qint64 nowMs,
+                       bool coasting, Source source)
+{
+    int index = m_index.value(trackId, -1);
+    if (index < 0) {
+        index = m_trackIds.size();
+        m_index.insert(trackId, index);
+        m_trackIds.append(trackId);
+        m_bearing.append(0.0);
+        m_range.append(0.0);
+        m_east.append(0.0);
+        m_north.append(0.0);
+        m_latitude.append(0.0);
+        m_longitude.append(0.0);
+        m_strength.append(0.0f);
+        m_updatedMs.append(0);
+        m_coasting.append(false);
+        m_source.append(TelemetrySource);
+        m_labelAnchor.append(LabelNorthEast);
+        m_screenX.append(0.0f);
+        m_screenY.append(0.0f);
+        m_trailEast.resize(m_trackIds.size() * TRAIL_CAPACITY);
+        m_trailNorth.resize(m_trackIds.size() * TRAIL_CAPACITY);
+        m_trailStart.append(0);
+        m_trailCount.append(0);
+        m_trailBounds.append(QRectF());
+    }
+
+    m_bearing[index] = fix.bearing;
+    m_range[index] = fix.range;
+    m_east[index] = fix.east;
+    m_north[index] = fix.north;
+    m_latitude[index] = latitude;
+    m_longitude[index] = longitude;
+    m_strength[index] = strength;
+    m_updatedMs[index] = nowMs;
+    m_coasting[index] = coasting;
+    m_source[index] = source;
+    project(index);
+    m_grid.move(index, m_screenX[index], m_screenY[index]);
+    appendTrail(index);
+
+    return index;
+}
+
+bool TrackStore::remove(const QString &trackId)
+{
+    int index = m_index.value(trackId, -1);
+    if (index < 0) {
+        return false;
+    }
+    removeAt(index);
+    return true;
+}
+
+void TrackStore::removeAt(int index)
+{
+    // Swap the last track into the hole so the arrays stay dense
+    int last = m_trackIds.size() - 1;
+    m_index.remove(m_trackIds[index]);
+    m_grid.remove(index);
+    m_grid.renumber(last, index);
+
+    if (index != last) {
+        m_trackIds[index] = m_trackIds[last];
+        m_bearing[index] = m_bearing[last];
+        m_range[index] = m_range[last];
+        m_east[index] = m_east[last];
+        m_north[index] = m_north[last];
+        m_latitude[index] = m_latitude[last];
+        m_longitude[index] = m_longitude[last];
+        m_strength[index] = m_strength[last];
+        m_updatedMs[index] = m_updatedMs[last];
+        m_coasting[index] = m_coasting[last];
+        m_source[index] = m_source[last];
+        m_labelAnchor[index] = m_labelAnchor[last];
+        m_screenX[index] = m_screenX[last];
+        m_screenY[index] = m_screenY[last];
+        std::copy_n(m_trailEast.constData() + last * TRAIL_CAPACITY, TRAIL_CAPACITY,
+                    m_trailEast.data() + index * TRAIL_CAPACITY);
+        std::copy_n(m_trailNorth.constData() + last * TRAIL_CAPACITY, TRAIL_CAPACITY,
+                    m_trailNorth.data() + index * TRAIL_CAPACITY);
+        m_trailStart[index] = m_trailStart[last];
+        m_trailCount[index] = m_trailCount[last];
+        m_trailBounds[index] = m_trailBounds[last];
+        m_index[m_trackIds[index]] = index;
+    }
+
+    m_trackIds.removeLast();
+    m_bearing.removeLast();
+    m_range.removeLast();
+    m_east.removeLast();
+    m_north.removeLast();
+    m_latitude.removeLast();
+    m_longitude.removeLast();
+    m_strength.removeLast();
+    m_updatedMs.removeLast();
+    m_coasting.removeLast();
+    m_source.removeLast();
+    m_labelAnchor.removeLast();
+    m_screenX.removeLast();
+    m_screenY.removeLast();
+    m_trailEast.resize(last * TRAIL_CAPACITY);
+    m_trailNorth.resize(last * TRAIL_CAPACITY);
+    m_trailStart.removeLast();
+    m_trailCount.removeLast();
+    m_trailBounds.removeLast();
+}
+
+int TrackStore::expire(qint64 nowMs, qint64 maxAgeMs)
+{
+    qint64 cutoff = nowMs - maxAgeMs;
+    int removed = 0;
+
+    // Walk backwards so a swapped-in track is one we have already checked
+    for (int i = m_updatedMs.size() - 1; i >= 0; --i) {
+        if (m_updatedMs[i] < cutoff) {
+            removeAt(i);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+void TrackStore::clear()
+{
+    m_index.clear();
+    m_grid.clear();
+    m_trackIds.clear();
+    m_bearing.clear();
+    m_range.clear();
+    m_east.clear();
+    m_north.clear();
+    m_latitude.clear();
+    m_longitude.clear();
+    m_strength.clear();
+    m_updatedMs.clear();
+    m_coasting.clear();
+    m_source.clear();
+    m_labelAnchor.clear();
+    m_screenX.clear();
+    m_screenY.clear();
+    m_trailEast.clear();
+    m_trailNorth.clear();
+    m_trailStart.clear();
+    m_trailCount.clear();
+    m_trailBounds.clear();
+}
+
+void TrackStore::relocate(const Geodesy::Origin &origin)
+{
+    int count = m_trackIds.size();
+    QVector<double> oldEast = m_east;
+    QVector<double> oldNorth = m_north;
+
+    Geodesy::Projection out;
+    out.bearing = m_bearing.data();
+    out.range = m_range.data();
+    out.east = m_east.data();
+    out.north = m_north.data();
+    Geodesy::project(origin, m_latitude.constData(), m_longitude.constData(), count, out);
+
+    for (int i = 0; i < count; ++i) {
+        float shiftEast = float(m_east[i] - oldEast[i]);
+        float shiftNorth = float(m_north[i] - oldNorth[i]);
+        for (int fix = 0; fix < m_trailCount[i]; ++fix) {
+            int slot = trailSlot(i, fix);
+            m_trailEast[slot] += shiftEast;
+            m_trailNorth[slot] += shiftNorth;
+        }
+        m_trailBounds[i].translate(shiftEast, shiftNorth);
+    }
+
+    setProjection(m_center, m_pixelsPerNM);
+}
+
+void TrackStore::setProjection(const QPointF &center, double pixelsPerNM)
+{
+    m_center = center;
+    m_pixelsPerNM = pixelsPerNM;
+
+    int count = m_trackIds.size();
+    const double *east = m_east.constData();
+    const double *north = m_north.constData();
+    float *screenX = m_screenX.data();
+    float *screenY = m_screenY.data();
+    double cx = m_center.x();
+    double cy = m_center.y();
+
+    for (int i = 0; i < count; ++i) {
+        screenX[i] = float(cx + east[i] * pixelsPerNM);
+        screenY[i] = float(cy - north[i] * pixelsPerNM);
+    }
+
+    // Every point moved, so rebuilding beats moving them one by one
+    m_grid.clear();
+    for (int i = 0; i < count; ++i) {
+        m_grid.insert(i, screenX[i], screenY[i]);
+    }
+}
+
+int TrackStore::hitTest(const QPointF &pos, double radius, double maxRange) const
+{
+    QVector<int> candidates;
+    m_grid.query(QRectF(pos.x() - radius, pos.y() - radius, radius * 2, radius * 2), candidates);
+
+    int best = -1;
+    double bestDistance = radius * radius;
+    for (int index : candidates) {
+        if (m_range[index] > maxRange) {
+            continue;
+        }
+        double dx = m_screenX[index] - pos.x();
+        double dy = m_screenY[index] - pos.y();
+        double distance = dx * dx + dy * dy;
+        if (distance <= bestDistance) {
+            bestDistance = distance;
+            best = index;
+        }
+    }
+    return best;
+}
+
+int TrackStore::clusterMembers(const QPointF &pos, double maxRange, QVector<int> &members) const
+{
+    int start = members.size();
+    m_grid.cellIds(pos.x(), pos.y(), members);
+
+    // Tracks beyond the display range share cells near its edge; drop them
+    int kept = start;
+    for (int i = start; i < members.size(); ++i) {
+        if (m_range[members[i]] <= maxRange) {
+            members[kept++] = members[i];
+        }
+    }
+    members.resize(kept);
+    return kept - start;
+}
+
+void TrackStore::project(int index)
+{
+    m_screenX[index] = float(m_center.x() + m_east[index] * m_pixelsPerNM);
+    m_screenY[index] = float(m_center.y() - m_north[index] * m_pixelsPerNM);
+}
+
+void TrackStore::appendTrail(int index)
+{
+    float east = float(m_east[index]);
+    float north = float(m_north[index]);
+    int count = m_trailCount[index];
+
+    // Repeated reports of the same position add nothing to the trail
+    if (count > 0) {
+        int newest = trailSlot(index, count - 1);
+        if (m_trailEast[newest] == east && m_trailNorth[newest] == north) {
+            return;
+        }
+    }
+
+    if (count < TRAIL_CAPACITY) {
+        ++count;
+        m_trailCount[index] = quint8(count);
+    } else {
+        m_trailStart[index] = quint8((m_trailStart[index] + 1) % TRAIL_CAPACITY);
+    }
+    int slot = trailSlot(index, count - 1);
+    m_trailEast[slot] = east;
+    m_trailNorth[slot] = north;
+
+    // The dropped fix may have been on the edge of the extent
+    updateTrailBounds(index);
+}
+
+void TrackStore::insertTrail(int index, const QVector<QPointF> &fixes)
+{
+    int count = m_trailCount[index];
+    if (fixes.isEmpty() || count == 0) {
+        return;
+    }
+
+    // Unroll the ring, splice the fixes in before the newest one and keep
+    // the most recent TRAIL_CAPACITY
+    float east[TRAIL_CAPACITY * 2];
+    float north[TRAIL_CAPACITY * 2];
+    int total = 0;
+    for (int fix = 0; fix < count - 1; ++fix) {
+        int slot = trailSlot(index, fix);
+        east[total] = m_trailEast[slot];
+        north[total++] = m_trailNorth[slot];
+    }
+    for (int i = qMax(0, int(fixes.size()) - TRAIL_CAPACITY); i < fixes.size(); ++i) {
+        east[total] = float(fixes[i].x());
+        north[total++] = float(fixes[i].y());
+    }
+    int newest = trailSlot(index, count - 1);
+    east[total] = m_trailEast[newest];
+    north[total++] = m_trailNorth[newest];
+
+    int kept = qMin(total, TRAIL_CAPACITY);
+    float *trailEast = m_trailEast.data() + index * TRAIL_CAPACITY;
+    float *trailNorth = m_trailNorth.data() + index * TRAIL_CAPACITY;
+    std::copy_n(east + total - kept, kept, trailEast);
+    std::copy_n(north + total - kept, kept, trailNorth);
+    m_trailStart[index] = 0;
+    m_trailCount[index] = quint8(kept);
+    updateTrailBounds(index);
+}
+
+void TrackStore::updateTrailBounds(int index)
+{
+    int count = m_trailCount[index];
+    int first = trailSlot(index, 0);
+    float minEast = m_trailEast[first], maxEast = minEast;
+    float minNorth = m_trailNorth[first], maxNorth = minNorth;
+    for (int fix = 1; fix < count; ++fix) {
+        int s = trailSlot(index, fix);
+        minEast = qMin(minEast, m_trailEast[s]);
+        maxEast = qMax(maxEast, m_trailEast[s]);
+        minNorth = qMin(minNorth, m_trailNorth[s]);
+        maxNorth = qMax(maxNorth, m_trailNorth[s]);
+    }
+    m_trailBounds[index] = QRectF(QPointF(minEast, minNorth), QPointF(maxEast, maxNorth));
+}
+
+QPointF TrackStore::trailScreenPoint(int index, int fix) const
+{
+    int slot = trailSlot(index, fix);
+    return QPointF(m_center.x() + m_trailEast[slot] * m_pixelsPerNM,
+                   m_center.y() - m_trailNorth[slot] * m_pixelsPerNM);
+}
+
+QRectF TrackStore::trailScreenBounds(int index) const
+{
+    const QRectF &bounds = m_trailBounds[index];
+    return QRectF(QPointF(m_center.x() + bounds.left() * m_pixelsPerNM,
+                          m_center.y() - bounds.bottom() * m_pixelsPerNM),
+                  QPointF(m_center.x() + bounds.right() * m_pixelsPerNM,
+                          m_center.y() - bounds.top() * m_pixelsPerNM));
+}
+
+int TrackStore::trailPolyline(int index, QVector<QPointF> &out) const
+{
+    out.clear();
+    int count = m_trailCount[index];
+    if (count < 2) {
+        return 0;
+    }
+
+    double cx = m_center.x();
+    double cy = m_center.y();
+    double lastX = 0.0, lastY = 0.0;
+
+    for (int fix = 0; fix < count; ++fix) {
+        int slot = trailSlot(index, fix);
+        double x = cx + m_trailEast[slot] * m_pixelsPerNM;
+        double y = cy - m_trailNorth[slot] * m_pixelsPerNM;
+
+        // Keep the endpoints, and anything at least a pixel from the last kept point
+        bool keep = fix == 0 || fix == count - 1
+                    || std::abs(x - lastX) >= 1.0 || std::abs(y - lastY) >= 1.0;
+        if (keep) {
+            out.append(QPointF(x, y));
+            lastX = x;
+            lastY = y;
+        }
+    }
+    return out.size();
+}
\ No newline at end of file
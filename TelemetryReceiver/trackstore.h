@@ -0,0 +1,136 @@
+#ifndef TRACKSTORE_H
+#define TRACKSTORE_H
+
+#include <QHash>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include "geodesy.h"
+#include "spatialgrid.h"
+
+// Contact storage for the radar display, laid out as parallel arrays so the
+// per-frame passes (projection, culling, drawing) walk contiguous memory.
+// Slots are dense: removing a track moves the last one into its place, so
+// indices are only stable until the next remove() or expire().
+class TrackStore
+{
+public:
+    static constexpr int TRAIL_CAPACITY = 64; // Fixes kept per track
+
+    // Corner of the symbol a track's label is drawn at, chosen by the label
+    // placement pass. New tracks start at the north east.
+    enum LabelAnchor : qint8 {
+        LabelHidden = -1,                     // Would overlap, not drawn
+        LabelNorthEast,
+        LabelSouthEast,
+        LabelNorthWest,
+        LabelSouthWest,
+        LabelAnchorCount
+    };
+
+    // Where a track's positions come from
+    enum Source : quint8 {
+        TelemetrySource,                      // Reported by the ship itself
+        PlotSource                            // Started from radar video plots
+    };
+
+    TrackStore();
+
+    // Insert or update a track, returns its slot. O(1).
+    int upsert(const QString &trackId, const Geodesy::Fix &fix,
+               double latitude, double longitude, float strength, qint64 nowMs,
+               bool coasting = false, Source source = TelemetrySource);
+    bool remove(const QString &trackId);
+    int expire(qint64 nowMs, qint64 maxAgeMs);  // Returns the number removed
+    void clear();
+
+    int indexOf(const QString &trackId) const { return m_index.value(trackId, -1); }
+    int size() const { return m_trackIds.size(); }
+    bool isEmpty() const { return m_trackIds.isEmpty(); }
+
+    // Reproject every track for a new radar origin. Trails are shifted with
+    // their track, which keeps their shape but not their exact positions.
+    void relocate(const Geodesy::Origin &origin);
+
+    // Screen projection: x = cx + east * scale, y = cy - north * scale
+    void setProjection(const QPointF &center, double pixelsPerNM);
+    QPointF screenPosition(int index) const { return QPointF(m_screenX[index], m_screenY[index]); }
+    
+    // Trail history, oldest fix first. Fixed memory per track: a ring of
+    // TRAIL_CAPACITY positions that overwrites the oldest fix when full.
+    int trailLength(int index) const { return m_trailCount[index]; }
+    QPointF trailScreenPoint(int index, int fix) const;
+    QRectF trailScreenBounds(int index) const;
+    // Screen-space polyline, dropping points closer than a pixel to the last
+    // kept one. Returns the number of points written to out.
+    int trailPolyline(int index, QVector<QPointF> &out) const;
+    // Late fixes (east/north in nautical miles, oldest first) that belong
+    // before the newest one, such as a gap resolved after the packet that
+    // followed it. Does nothing for a track without a trail yet.
+    void insertTrail(int index, const QVector<QPointF> &fixes);
+
+    // Screen-space lookups through the spatial grid
+    int hitTest(const QPointF &pos, double radius, double maxRange) const; // Nearest slot or -1
+    void query(const QRectF &rect, QVector<int> &out) const { m_grid.query(rect, out); }
+
+    // Level of detail: tracks sharing a grid cell are clustered together.
+    // The grid follows every upsert, so clusters never need rebuilding.
+    float clusterCellSize() const { return m_grid.cellSize(); }
+    quint64 clusterKey(const QPointF &pos) const { return m_grid.cellKey(pos.x(), pos.y()); }
+    QRectF clusterCell(const QPointF &pos) const { return m_grid.cellRect(pos.x(), pos.y()); }
+    // Tracks within maxRange in the cell at pos, appended to members; returns how many
+    int clusterMembers(const QPointF &pos, double maxRange, QVector<int> &members) const;
+
+    // Column access
+    const QVector<QString> &trackIds() const { return m_trackIds; }
+    const QVector<double> &bearings() const { return m_bearing; }
+    const QVector<double> &ranges() const { return m_range; }
+    const QVector<double> &latitudes() const { return m_latitude; }
+    const QVector<double> &longitudes() const { return m_longitude; }
+    const QVector<float> &strengths() const { return m_strength; }
+    const QVector<qint64> &updatedMs() const { return m_updatedMs; }
+    const QVector<bool> &coasting() const { return m_coasting; }
+    const QVector<quint8> &sources() const { return m_source; }
+    const QVector<qint8> &labelAnchors() const { return m_labelAnchor; }
+    void setLabelAnchor(int index, qint8 anchor) { m_labelAnchor[index] = anchor; }
+    const QVector<float> &screenX() const { return m_screenX; }
+    const QVector<float> &screenY() const { return m_screenY; }
+
+private:
+    void project(int index);
+    void removeAt(int index);
+    void appendTrail(int index);
+    void updateTrailBounds(int index);
+    int trailSlot(int index, int fix) const { return index * TRAIL_CAPACITY + (m_trailStart[index] + fix) % TRAIL_CAPACITY; }
+
+    QHash<QString, int> m_index;              // Track ID -> slot
+
+    // One entry per track, all the same length
+    QVector<QString> m_trackIds;
+    QVector<double> m_bearing;                // Degrees, 0 = North
+    QVector<double> m_range;                  // Nautical miles
+    QVector<double> m_east;                   // Nautical miles from radar centre
+    QVector<double> m_north;
+    QVector<double> m_latitude;
+    QVector<double> m_longitude;
+    QVector<float> m_strength;                // 0.0-1.0
+    QVector<qint64> m_updatedMs;              // Last update, ms since epoch
+    QVector<bool> m_coasting;                 // Position is synthesized, not measured
+    QVector<quint8> m_source;                 // Source of the latest update
+    QVector<qint8> m_labelAnchor;             // LabelAnchor
+    QVector<float> m_screenX;                 // Widget coordinates
+    QVector<float> m_screenY;
+
+    // Trails: TRAIL_CAPACITY entries per track, each block a ring buffer
+    QVector<float> m_trailEast;               // Nautical miles
+    QVector<float> m_trailNorth;
+    QVector<quint8> m_trailStart;             // Ring position of the oldest fix
+    QVector<quint8> m_trailCount;
+    QVector<QRectF> m_trailBounds;            // East/north extent of each trail
+
+    SpatialGrid m_grid;                       // Slot -> screen position index
+    QPointF m_center;
+    double m_pixelsPerNM;
+};
+
+#endif // TRACKSTORE_H
\ No newline at end of file
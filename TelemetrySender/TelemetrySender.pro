@@ -1,6 +1,6 @@
 QT += core widgets network
 
-CONFIG += c++11
+CONFIG += c++17
 win32:CONFIG += console
 
 TARGET = TelemetrySender
@@ -11,11 +11,24 @@ DEFINES += QT_DEPRECATED_WARNINGS
 SOURCES += \
     main.cpp \
     mainwindow.cpp \
-    ../TelemetryReceiver/reliableudp.cpp
+    spokestreamer.cpp \
+    ../TelemetryReceiver/reliableudp.cpp \
+    ../TelemetryReceiver/networkstatistics.cpp \
+    ../TelemetryReceiver/asynclogger.cpp \
+    ../TelemetryReceiver/jitterbuffer.cpp \
+    ../TelemetryReceiver/spokesynth.cpp
 
 HEADERS += \
     mainwindow.h \
-    ../TelemetryReceiver/reliableudp.h
+    spokestreamer.h \
+    ../TelemetryReceiver/reliableudp.h \
+    ../TelemetryReceiver/networkstatistics.h \
+    ../TelemetryReceiver/asynclogger.h \
+    ../TelemetryReceiver/mpscqueue.h \
+    ../TelemetryReceiver/telemetrypacket.h \
+    ../TelemetryReceiver/jitterbuffer.h \
+    ../TelemetryReceiver/spokesynth.h \
+    ../TelemetryReceiver/radarmath.h
 
 FORMS += \
     mainwindow.ui
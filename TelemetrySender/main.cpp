@@ -1,12 +1,96 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QScopedPointer>
+#include <cstring>
+#include <iostream>
 #include "mainwindow.h"
+#include "spokestreamer.h"
+#include "../TelemetryReceiver/asynclogger.h"
+
+namespace {
+
+// Synthetic radar video without a window, for load tests. Prints progress
+// once a second; exits with 2 if generation ever fell a revolution behind.
+int runHeadless(QCoreApplication &app, const QCommandLineParser &parser)
+{
+    ReliableUdpSender sender;
+    sender.setTarget(QHostAddress(parser.value("host")), quint16(parser.value("port").toUInt()));
+
+    SpokeStreamer streamer(&sender);
+    SpokeSynthesizer::Settings settings;
+    settings.spokesPerRevolution = parser.value("spokes").toInt();
+    settings.binCount = parser.value("bins").toInt();
+    settings.rangeNM = parser.value("range").toDouble();
+    settings.clutterLevel = parser.value("clutter").toInt();
+    settings.noiseLevel = parser.value("noise").toInt();
+    settings.seed = parser.value("seed").toUInt();
+    streamer.synthesizer().setSettings(settings);
+    streamer.setRandomTargets(parser.value("targets").toInt(), settings.seed);
+    streamer.setRpm(parser.value("rpm").toDouble());
+
+    QObject::connect(&streamer, &SpokeStreamer::progress, [&sender](quint64 spokesSent, quint64 spokesSkipped) {
+        const NetworkStatistics *statistics = sender.statistics();
+        std::cout << spokesSent << " spokes generated, " << statistics->value(NetworkStatistics::SpokesSent)
+                  << " sent, " << spokesSkipped << " skipped, "
+                  << statistics->value(NetworkStatistics::BytesSent) / 1048576.0 << " MB" << std::endl;
+    });
+
+    int seconds = parser.value("duration").toInt();
+    if (seconds > 0) {
+        QTimer::singleShot(seconds * 1000, &app, [&streamer, &app]() {
+            streamer.stop();
+            app.quit();
+        });
+    }
+
+    std::cout << "Streaming " << streamer.spokesPerSecond() << " spokes/s of " << settings.binCount << " bins to "
+              << parser.value("host").toStdString() << ":" << parser.value("port").toStdString() << std::endl;
+    streamer.start();
+    int result = app.exec();
+    return streamer.spokesSkipped() > 0 ? 2 : result;
+}
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    // Headless runs must not need a display, so look before creating the application
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        headless = headless || std::strcmp(argv[i], "--headless") == 0;
+    }
+    QScopedPointer<QCoreApplication> app(headless ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ship telemetry and synthetic radar video sender");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"headless", "Stream synthetic radar video without a window, for load tests."},
+        {"host", "Receiver address.", "address", "127.0.0.1"},
+        {"port", "Receiver port.", "port", "12345"},
+        {"rpm", "Antenna rotation speed.", "rpm", "60"},
+        {"spokes", "Spokes per revolution.", "count", "4096"},
+        {"bins", "Range bins per spoke.", "count", "1024"},
+        {"range", "Range of the last bin, in nautical miles.", "nm", "24"},
+        {"targets", "Number of moving targets.", "count", "16"},
+        {"clutter", "Mean sea clutter at zero range, 0-255.", "level", "60"},
+        {"noise", "Mean receiver noise, 0-255.", "level", "10"},
+        {"seed", "Random seed for noise and targets.", "seed", "1"},
+        {"duration", "Seconds to stream, 0 until interrupted.", "seconds", "0"},
+    });
+    parser.process(*app);
 
-    MainWindow window;
-    window.show();
+    int result;
+    if (headless) {
+        result = runHeadless(*app, parser);
+    } else {
+        MainWindow window;
+        window.show();
+        result = app->exec();
+    }
 
-    return app.exec();
+    // Flush buffered log records before static teardown
+    AsyncLogger::instance().shutdown();
+    return result;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_movementTimer(new QTimer(this))
     , m_udpSocket(new QUdpSocket(this))
     , m_reliableSender(new ReliableUdpSender(this))
+    , m_spokeStreamer(new SpokeStreamer(m_reliableSender, this))
     , m_isSending(false)
     , m_packetCount(0)
     , m_port(12345)
@@ -24,6 +25,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_movementTimer, &QTimer::timeout, this, &MainWindow::updateMovementSettings);
     connect(m_startStopButton, &QPushButton::clicked, this, &MainWindow::toggleSending);
     connect(m_intervalSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::updateInterval);
+    connect(m_videoButton, &QPushButton::clicked, this, &MainWindow::toggleVideo);
+    connect(m_spokeStreamer, &SpokeStreamer::progress, this, &MainWindow::onVideoProgress);
     
     m_timer->setInterval(1000);        // Send data every 1 second
     m_movementTimer->setInterval(3000); // Move position every 3 seconds
@@ -120,6 +123,65 @@ void MainWindow::setupUI()
     
     mainLayout->addWidget(controlGroup);
     
+    // Synthetic radar video group
+    auto *videoGroup = new QGroupBox("Radar Video Simulation", this);
+    auto *videoLayout = new QGridLayout(videoGroup);
+    
+    videoLayout->addWidget(new QLabel("Antenna Speed:", this), 0, 0);
+    m_rpmSpinBox = new QSpinBox(this);
+    m_rpmSpinBox->setRange(6, 120);
+    m_rpmSpinBox->setValue(60);
+    m_rpmSpinBox->setSuffix(" RPM");
+    videoLayout->addWidget(m_rpmSpinBox, 0, 1);
+    
+    videoLayout->addWidget(new QLabel("Spokes per Revolution:", this), 1, 0);
+    m_spokesPerRevolutionSpinBox = new QSpinBox(this);
+    m_spokesPerRevolutionSpinBox->setRange(256, SpokeMessage::MAX_SPOKES);
+    m_spokesPerRevolutionSpinBox->setValue(4096);
+    m_spokesPerRevolutionSpinBox->setSingleStep(256);
+    videoLayout->addWidget(m_spokesPerRevolutionSpinBox, 1, 1);
+    
+    videoLayout->addWidget(new QLabel("Range Bins:", this), 2, 0);
+    m_binCountSpinBox = new QSpinBox(this);
+    m_binCountSpinBox->setRange(64, SpokeMessage::MAX_BINS);
+    m_binCountSpinBox->setValue(1024);
+    m_binCountSpinBox->setSingleStep(64);
+    videoLayout->addWidget(m_binCountSpinBox, 2, 1);
+    
+    videoLayout->addWidget(new QLabel("Range:", this), 3, 0);
+    m_videoRangeSpinBox = new QDoubleSpinBox(this);
+    m_videoRangeSpinBox->setRange(0.5, 96.0);
+    m_videoRangeSpinBox->setValue(24.0);
+    m_videoRangeSpinBox->setDecimals(1);
+    m_videoRangeSpinBox->setSuffix(" NM");
+    videoLayout->addWidget(m_videoRangeSpinBox, 3, 1);
+    
+    videoLayout->addWidget(new QLabel("Targets:", this), 4, 0);
+    m_targetCountSpinBox = new QSpinBox(this);
+    m_targetCountSpinBox->setRange(0, 64);
+    m_targetCountSpinBox->setValue(8);
+    videoLayout->addWidget(m_targetCountSpinBox, 4, 1);
+    
+    videoLayout->addWidget(new QLabel("Sea Clutter:", this), 5, 0);
+    m_clutterSpinBox = new QSpinBox(this);
+    m_clutterSpinBox->setRange(0, 255);
+    m_clutterSpinBox->setValue(60);
+    videoLayout->addWidget(m_clutterSpinBox, 5, 1);
+    
+    videoLayout->addWidget(new QLabel("Noise:", this), 6, 0);
+    m_noiseSpinBox = new QSpinBox(this);
+    m_noiseSpinBox->setRange(0, 255);
+    m_noiseSpinBox->setValue(10);
+    videoLayout->addWidget(m_noiseSpinBox, 6, 1);
+    
+    m_videoButton = new QPushButton("Start Video", this);
+    videoLayout->addWidget(m_videoButton, 7, 0, 1, 2);
+    
+    m_videoStatusLabel = new QLabel("Video: Stopped", this);
+    videoLayout->addWidget(m_videoStatusLabel, 8, 0, 1, 2);
+    
+    mainLayout->addWidget(videoGroup);
+    
     // Status group
     auto *statusGroup = new QGroupBox("Status", this);
     auto *statusLayout = new QVBoxLayout(statusGroup);
@@ -206,6 +268,38 @@ void MainWindow::toggleSending()
     }
 }
 
+void MainWindow::toggleVideo()
+{
+    if (m_spokeStreamer->isRunning()) {
+        m_spokeStreamer->stop();
+        m_videoButton->setText("Start Video");
+        return;
+    }
+    
+    SpokeSynthesizer::Settings settings;
+    settings.spokesPerRevolution = m_spokesPerRevolutionSpinBox->value();
+    settings.binCount = m_binCountSpinBox->value();
+    settings.rangeNM = m_videoRangeSpinBox->value();
+    settings.clutterLevel = m_clutterSpinBox->value();
+    settings.noiseLevel = m_noiseSpinBox->value();
+    m_spokeStreamer->synthesizer().setSettings(settings);
+    m_spokeStreamer->setRandomTargets(m_targetCountSpinBox->value(), settings.seed);
+    m_spokeStreamer->setRpm(m_rpmSpinBox->value());
+    m_spokeStreamer->start();
+    m_videoButton->setText("Stop Video");
+    m_videoStatusLabel->setText(QString("Video: %1 spokes/s").arg(m_spokeStreamer->spokesPerSecond(), 0, 'f', 0));
+}
+
+void MainWindow::onVideoProgress(quint64 spokesSent, quint64 spokesSkipped)
+{
+    QString text = QString("Video: %1 spokes sent at %2/s")
+                       .arg(spokesSent).arg(m_spokeStreamer->spokesPerSecond(), 0, 'f', 0);
+    if (spokesSkipped > 0) {
+        text += QString(", %1 skipped").arg(spokesSkipped);
+    }
+    m_videoStatusLabel->setText(text);
+}
+
 void MainWindow::updateInterval()
 {
     m_timer->setInterval(m_intervalSpinBox->value());
@@ -242,8 +336,8 @@ void MainWindow::sendTelemetryData()
     packet.timestamp = QDateTime::currentDateTime();
     packet.needsAck = true;  // Request acknowledgment
     
-    // Send via reliable UDP
-    m_reliableSender->sendTelemetryData(packet);
+    // Send via reliable UDP; the sender assigns the sequence number
+    packet.sequenceNumber = m_reliableSender->sendTelemetryData(packet);
     
     m_packetCount++;
     m_packetCountLabel->setText(QString("Packets sent: %1").arg(m_packetCount));
@@ -15,6 +15,7 @@
 #include <QGroupBox>
 #include <random>
 #include "../TelemetryReceiver/reliableudp.h"
+#include "spokestreamer.h"
 
 QT_BEGIN_NAMESPACE
 class QLabel;
@@ -35,6 +36,8 @@ private slots:
     void sendTelemetryData();
     void updateInterval();
     void updateMovementSettings();
+    void toggleVideo();
+    void onVideoProgress(quint64 spokesSent, quint64 spokesSkipped);
 
 private:
     void setupUI();
@@ -58,6 +61,18 @@ private:
     QLabel *m_lastDataLabel;
     QLabel *m_positionLabel;
     
+    // Synthetic radar video
+    SpokeStreamer *m_spokeStreamer;
+    QSpinBox *m_rpmSpinBox;
+    QSpinBox *m_spokesPerRevolutionSpinBox;
+    QSpinBox *m_binCountSpinBox;
+    QDoubleSpinBox *m_videoRangeSpinBox;
+    QSpinBox *m_targetCountSpinBox;
+    QSpinBox *m_clutterSpinBox;
+    QSpinBox *m_noiseSpinBox;
+    QPushButton *m_videoButton;
+    QLabel *m_videoStatusLabel;
+    
     bool m_isSending;
     int m_packetCount;
     quint16 m_port;
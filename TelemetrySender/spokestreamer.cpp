@@ -0,0 +1,100 @@
+#include "spokestreamer.h"
+#include <QDateTime>
+#include <random>
+#include "../TelemetryReceiver/asynclogger.h"
+
+SpokeStreamer::SpokeStreamer(ReliableUdpSender *sender, QObject *parent)
+    : QObject(parent)
+    , m_sender(sender)
+    , m_timer(new QTimer(this))
+    , m_rpm(60.0)
+    , m_spokesSent(0)
+    , m_spokesSkipped(0)
+    , m_lastProgressMs(0)
+    , m_startEpochMs(0)
+{
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(10);
+    connect(m_timer, &QTimer::timeout, this, &SpokeStreamer::sendDueSpokes);
+}
+
+void SpokeStreamer::setRandomTargets(int count, quint32 seed)
+{
+    double rangeNM = m_synthesizer.settings().rangeNM;
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> bearing(0.0, 360.0);
+    std::uniform_real_distribution<double> range(qMin(1.0, 0.1 * rangeNM), 0.9 * rangeNM);
+    std::uniform_real_distribution<double> speed(0.0, 30.0);
+    std::uniform_int_distribution<int> amplitude(100, 220);
+
+    QVector<SpokeSynthesizer::Target> targets;
+    for (int i = 0; i < count; ++i) {
+        SpokeSynthesizer::Target target;
+        target.bearing = bearing(generator);
+        target.range = range(generator);
+        target.course = bearing(generator);
+        target.speedKnots = speed(generator);
+        target.amplitude = amplitude(generator);
+        targets.append(target);
+    }
+    m_synthesizer.setTargets(targets);
+}
+
+void SpokeStreamer::start()
+{
+    if (isRunning()) return;
+
+    m_synthesizer.restart();
+    m_spokesSent = 0;
+    m_spokesSkipped = 0;
+    m_lastProgressMs = 0;
+    m_startEpochMs = QDateTime::currentMSecsSinceEpoch();
+    m_clock.start();
+    m_timer->start();
+    TLOG_INFO("SpokeStreamer", "Streaming {} spokes/s ({} x {} bins at {} RPM)", spokesPerSecond(),
+              m_synthesizer.settings().spokesPerRevolution, m_synthesizer.settings().binCount, m_rpm);
+}
+
+void SpokeStreamer::stop()
+{
+    if (!isRunning()) return;
+
+    m_timer->stop();
+    emit progress(m_spokesSent, m_spokesSkipped);
+    TLOG_INFO("SpokeStreamer", "Stopped after {} spokes, {} skipped", m_spokesSent, m_spokesSkipped);
+}
+
+void SpokeStreamer::sendDueSpokes()
+{
+    double rate = spokesPerSecond();
+    qint64 elapsedMs = m_clock.elapsed();
+    quint64 due = quint64(m_clock.nsecsElapsed() * 1e-9 * rate);
+    quint64 done = m_spokesSent + m_spokesSkipped;
+    if (due > done) {
+        quint64 backlog = due - done;
+        quint64 revolution = quint64(m_synthesizer.settings().spokesPerRevolution);
+        if (backlog > revolution) {
+            TLOG_WARN_EVERY("SpokeStreamer", 1000, "Fell behind by {} spokes, skipping", backlog - revolution);
+            m_synthesizer.skip(backlog - revolution);
+            m_spokesSkipped += backlog - revolution;
+            done += backlog - revolution;
+            backlog = revolution;
+        }
+
+        // Timestamps follow the schedule, not the tick, so targets move
+        // smoothly from spoke to spoke
+        m_batch.clear();
+        m_batch.reserve(int(backlog));
+        for (quint64 i = 0; i < backlog; ++i) {
+            qint64 timestampMs = m_startEpochMs + qint64((done + i) * 1000.0 / rate);
+            m_batch.append(m_synthesizer.nextSpoke(timestampMs));
+        }
+        m_sender->sendSpokes(m_batch);
+        m_spokesSent += backlog;
+    }
+
+    if (elapsedMs - m_lastProgressMs >= 1000) {
+        m_lastProgressMs = elapsedMs;
+        emit progress(m_spokesSent, m_spokesSkipped);
+    }
+}
\ No newline at end of file
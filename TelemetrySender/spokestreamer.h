@@ -0,0 +1,60 @@
+#ifndef SPOKESTREAMER_H
+#define SPOKESTREAMER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include "../TelemetryReceiver/reliableudp.h"
+#include "../TelemetryReceiver/spokesynth.h"
+
+// Streams synthetic radar video at a real antenna rate. Each timer tick
+// synthesizes the spokes that have fallen due since the last one and hands
+// them to the sender as one batch, so the average rate follows the clock
+// however the ticks land. After a stall of more than a revolution the
+// backlog is skipped, not sent as a burst; the receiver counts the skipped
+// spokes as lost from the gap in sequence numbers.
+class SpokeStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SpokeStreamer(ReliableUdpSender *sender, QObject *parent = nullptr);
+
+    // Settings take effect from the next start()
+    SpokeSynthesizer &synthesizer() { return m_synthesizer; }
+    void setRpm(double rpm) { m_rpm = qBound(1.0, rpm, 600.0); }
+    double rpm() const { return m_rpm; }
+    double spokesPerSecond() const { return m_synthesizer.settings().spokesPerRevolution * m_rpm / 60.0; }
+
+    // Replace the targets with count random ones inside the range, from
+    // stationary to 30 knots
+    void setRandomTargets(int count, quint32 seed);
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_timer->isActive(); }
+
+    quint64 spokesSent() const { return m_spokesSent; }
+    quint64 spokesSkipped() const { return m_spokesSkipped; }
+
+signals:
+    void progress(quint64 spokesSent, quint64 spokesSkipped);  // Once a second while running
+
+private slots:
+    void sendDueSpokes();
+
+private:
+    ReliableUdpSender *m_sender;
+    SpokeSynthesizer m_synthesizer;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;               // Since start()
+    double m_rpm;
+    quint64 m_spokesSent;
+    quint64 m_spokesSkipped;
+    qint64 m_lastProgressMs;
+    qint64 m_startEpochMs;               // Timestamp of the first spoke
+    QVector<SpokeMessage> m_batch;
+};
+
+#endif // SPOKESTREAMER_H
\ No newline at end of file
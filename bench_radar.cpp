@@ -0,0 +1,548 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QVector>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "geodesy.h"
+#include "plotextractor.h"
+#include "radarmath.h"
+#include "scanconverter.h"
+#include "spokesynth.h"
+
+namespace {
+
+// Results are folded into this so the optimiser cannot drop the loops
+volatile double g_sink = 0.0;
+
+double nanosecondsPer(const QElapsedTimer &timer, qint64 operations)
+{
+    return double(timer.nsecsElapsed()) / double(operations);
+}
+
+void printResult(const char *name, const char *method, double baselineNs, double optimisedNs)
+{
+    std::cout << "  " << name << ": libm " << baselineNs << " ns, " << method << " "
+              << optimisedNs << " ns, speedup " << baselineNs / optimisedNs << "x" << std::endl;
+}
+
+// Display trigonometry: the fixed angles one frame draws (bearing lines,
+// compass points and sweep beams) and arbitrary contact bearings
+int benchTrig(int iterations)
+{
+    std::cout << "trig: " << iterations << " iterations" << std::endl;
+
+    // Fixed angles, built at run time so the compiler cannot fold them
+    QVector<int> frameAngles;
+    for (int bearing = 0; bearing < 360; bearing += 10) frameAngles.append(bearing);
+    for (int i = 0; i < 8; ++i) frameAngles.append(i * 45);
+    for (int angle = 0; angle < 360; angle += 15) frameAngles.append(angle);
+
+    QVector<double> bearings(4096);
+    quint32 seed = 12345;
+    for (double &bearing : bearings) {
+        seed = seed * 1664525u + 1013904223u;
+        bearing = (seed >> 8) * (360.0 / 16777216.0);
+    }
+
+    QElapsedTimer timer;
+    double sum = 0.0;
+
+    timer.start();
+    for (int it = 0; it < iterations; ++it) {
+        for (int angle : frameAngles) {
+            double radians = angle * RadarMath::DEG_TO_RAD;
+            sum += std::sin(radians) + std::cos(radians);
+        }
+    }
+    double libmFrame = nanosecondsPer(timer, qint64(iterations) * frameAngles.size());
+
+    timer.start();
+    for (int it = 0; it < iterations; ++it) {
+        for (int angle : frameAngles) {
+            RadarMath::UnitVector u = RadarMath::bearingVector(angle);
+            sum += u.east + u.north;
+        }
+    }
+    double tableFrame = nanosecondsPer(timer, qint64(iterations) * frameAngles.size());
+
+    int passes = qMax(1, iterations / 64);
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        for (double bearing : bearings) {
+            double radians = bearing * RadarMath::DEG_TO_RAD;
+            sum += std::sin(radians) + std::cos(radians);
+        }
+    }
+    double libmArbitrary = nanosecondsPer(timer, qint64(passes) * bearings.size());
+
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        for (double bearing : bearings) {
+            RadarMath::UnitVector u = RadarMath::fastBearingVector(bearing);
+            sum += u.east + u.north;
+        }
+    }
+    double fastArbitrary = nanosecondsPer(timer, qint64(passes) * bearings.size());
+    g_sink = sum;
+
+    // Worst case against libm over a fine sweep, negative bearings included
+    double maxError = 0.0;
+    for (int i = -360000; i <= 720000; ++i) {
+        double bearing = i * 0.001 + 0.0003;
+        RadarMath::UnitVector u = RadarMath::fastBearingVector(bearing);
+        double radians = bearing * RadarMath::DEG_TO_RAD;
+        maxError = qMax(maxError, qMax(std::abs(u.east - std::sin(radians)),
+                                       std::abs(u.north - std::cos(radians))));
+    }
+
+    std::cout << "per sin+cos pair:" << std::endl;
+    printResult("fixed display angles", "table", libmFrame, tableFrame);
+    printResult("arbitrary bearings  ", "fast", libmArbitrary, fastArbitrary);
+    std::cout << "fast sincos max error: " << maxError << std::endl;
+    return maxError < 1e-11 ? 0 : 1;
+}
+
+// Bearing and range as RadarWidget computed them before the geodesy module
+void libmBearingRange(double lat0, double lon0, double lat, double lon, double &bearing, double &range)
+{
+    double dLon = (lon - lon0) * RadarMath::DEG_TO_RAD;
+    double lat1Rad = lat0 * RadarMath::DEG_TO_RAD;
+    double lat2Rad = lat * RadarMath::DEG_TO_RAD;
+    double y = std::sin(dLon) * std::cos(lat2Rad);
+    double x = std::cos(lat1Rad) * std::sin(lat2Rad) - std::sin(lat1Rad) * std::cos(lat2Rad) * std::cos(dLon);
+    bearing = std::fmod(std::atan2(y, x) / RadarMath::DEG_TO_RAD + 360.0, 360.0);
+
+    double dLat = (lat - lat0) * RadarMath::DEG_TO_RAD;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2)
+             + std::cos(lat1Rad) * std::cos(lat2Rad) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    range = Geodesy::EARTH_RADIUS_NM * 2 * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+}
+
+// Contact projection: libm per point, the scalar reference and the SIMD
+// batch, which must match the reference bit for bit
+int benchGeodesy(int points)
+{
+    const int passes = 20;
+    std::cout << "geodesy: " << points << " points, kernel " << Geodesy::kernelName() << std::endl;
+
+    // Mostly the telemetry area around the radar, some anywhere on Earth
+    QVector<double> latitudes(points);
+    QVector<double> longitudes(points);
+    quint32 seed = 12345;
+    auto uniform = [&seed](double low, double high) {
+        seed = seed * 1664525u + 1013904223u;
+        return low + (seed >> 8) * ((high - low) / 16777216.0);
+    };
+    for (int i = 0; i < points; ++i) {
+        bool local = i % 8 != 0;
+        latitudes[i] = local ? uniform(36.0, 42.0) : uniform(-89.0, 89.0);
+        longitudes[i] = local ? uniform(26.0, 45.0) : uniform(-180.0, 180.0);
+    }
+    Geodesy::Origin origin = Geodesy::makeOrigin(39.0, 35.5);
+
+    QVector<double> libmBearing(points), libmRange(points);
+    QVector<double> scalarColumns[4], batchColumns[4];
+    for (int c = 0; c < 4; ++c) {
+        scalarColumns[c] = QVector<double>(points);
+        batchColumns[c] = QVector<double>(points);
+    }
+    auto columns = [](QVector<double> *data) {
+        Geodesy::Projection out;
+        out.bearing = data[0].data();
+        out.range = data[1].data();
+        out.east = data[2].data();
+        out.north = data[3].data();
+        return out;
+    };
+    Geodesy::Projection scalarOut = columns(scalarColumns);
+    Geodesy::Projection batchOut = columns(batchColumns);
+    Geodesy::Projection batchPolar;
+    batchPolar.bearing = batchColumns[0].data();
+    batchPolar.range = batchColumns[1].data();
+
+    QElapsedTimer timer;
+    double sum = 0.0;
+
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        for (int i = 0; i < points; ++i) {
+            libmBearingRange(39.0, 35.5, latitudes[i], longitudes[i], libmBearing[i], libmRange[i]);
+        }
+        sum += libmRange[it];
+    }
+    double libmNs = nanosecondsPer(timer, qint64(passes) * points);
+
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        Geodesy::projectScalar(origin, latitudes.constData(), longitudes.constData(), points, scalarOut);
+        sum += scalarColumns[1][it];
+    }
+    double scalarNs = nanosecondsPer(timer, qint64(passes) * points);
+
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        Geodesy::project(origin, latitudes.constData(), longitudes.constData(), points, batchPolar);
+        sum += batchColumns[1][it];
+    }
+    double batchPolarNs = nanosecondsPer(timer, qint64(passes) * points);
+
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        Geodesy::project(origin, latitudes.constData(), longitudes.constData(), points, batchOut);
+        sum += batchColumns[2][it];
+    }
+    double batchNs = nanosecondsPer(timer, qint64(passes) * points);
+
+    // Per-contact path for a harbour near the radar: tangent plane against
+    // the scalar great-circle reference on the same points
+    Geodesy::TangentPlane plane(origin);
+    QVector<double> nearLatitudes(points);
+    QVector<double> nearLongitudes(points);
+    for (int i = 0; i < points; ++i) {
+        nearLatitudes[i] = uniform(38.2, 39.8);
+        nearLongitudes[i] = uniform(34.5, 36.5);
+    }
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        for (int i = 0; i < points; ++i) {
+            Geodesy::Fix fix;
+            Geodesy::bearingRange(origin, nearLatitudes[i], nearLongitudes[i], fix.bearing, fix.range);
+            sum += fix.range;
+        }
+    }
+    double nearScalarNs = nanosecondsPer(timer, qint64(passes) * points);
+
+    int planarCount = 0;
+    timer.start();
+    for (int it = 0; it < passes; ++it) {
+        for (int i = 0; i < points; ++i) {
+            Geodesy::Fix fix;
+            planarCount += plane.project(nearLatitudes[i], nearLongitudes[i], fix);
+            sum += fix.range;
+        }
+    }
+    double planeNs = nanosecondsPer(timer, qint64(passes) * points);
+    g_sink = sum;
+
+    bool identical = true;
+    for (int c = 0; c < 4; ++c) {
+        identical = identical && std::memcmp(scalarColumns[c].constData(), batchColumns[c].constData(),
+                                             sizeof(double) * points) == 0;
+    }
+
+    double maxBearingError = 0.0;
+    double maxRangeError = 0.0;
+    for (int i = 0; i < points; ++i) {
+        double bearingError = std::abs(libmBearing[i] - batchColumns[0][i]);
+        maxBearingError = qMax(maxBearingError, qMin(bearingError, 360.0 - bearingError));
+        maxRangeError = qMax(maxRangeError, std::abs(libmRange[i] - batchColumns[1][i]));
+    }
+
+    // The planar guarantee where it is tightest: every tenth of a degree
+    // just inside the edge of the planar disc, and a budget's width past it
+    // where a point's planar range can still fall inside
+    double worstPlanarRatio = 0.0;
+    for (double budget : {Geodesy::TangentPlane::DEFAULT_ERROR_BUDGET_NM, 0.001}) {
+        for (double latitude : {origin.latitude, 20.0}) {
+            Geodesy::TangentPlane edge(Geodesy::makeOrigin(latitude, origin.longitude), budget);
+            for (int i = 0; i < 3600; ++i) {
+                double bearing = i * 0.1;
+                for (double offset : {-2.0, -1.0, -0.5, 0.0, 1.0}) {
+                    double range = edge.planarLimitNM() + offset * budget;
+                    double latitudeAt, longitudeAt;
+                    Geodesy::destination(edge.origin(), bearing, range, latitudeAt, longitudeAt);
+                    Geodesy::Fix fix;
+                    if (!edge.project(latitudeAt, longitudeAt, fix)) {
+                        continue;
+                    }
+                    double theta = bearing * RadarMath::DEG_TO_RAD;
+                    double error = std::hypot(fix.east - range * std::sin(theta), fix.north - range * std::cos(theta));
+                    worstPlanarRatio = qMax(worstPlanarRatio, error / budget);
+                }
+            }
+        }
+    }
+
+    std::cout << "per point:" << std::endl;
+    printResult("bearing+range, scalar   ", "scalar", libmNs, scalarNs);
+    printResult("bearing+range, batch    ", Geodesy::kernelName(), libmNs, batchPolarNs);
+    printResult("+east/north, batch      ", Geodesy::kernelName(), libmNs, batchNs);
+    std::cout << "  near radar: scalar " << nearScalarNs << " ns, tangent plane " << planeNs
+              << " ns, speedup " << nearScalarNs / planeNs << "x ("
+              << 100.0 * planarCount / (qint64(passes) * points) << "% planar within "
+              << plane.planarLimitNM() << " NM, max error " << plane.maxPlanarErrorNM() << " NM)" << std::endl;
+    std::cout << "batch vs scalar: " << (identical ? "bit-identical" : "MISMATCH") << std::endl;
+    std::cout << "max error vs libm: bearing " << maxBearingError << " deg, range "
+              << maxRangeError << " NM" << std::endl;
+    std::cout << "tangent plane edge: worst error " << worstPlanarRatio << " of budget" << std::endl;
+    bool withinBudget = worstPlanarRatio <= 1.0 + 1e-9;
+    return identical && maxBearingError < 1e-9 && maxRangeError < 1e-9 && withinBudget ? 0 : 1;
+}
+
+// Radar video at 4096 spokes x 1024 bins and 60 RPM, converted into a
+// 1000 px disc at 30 frames per second
+int benchScan(int revolutions)
+{
+    const int spokesPerRevolution = 4096;
+    const int binCount = 1024;
+    const int requiredSpokesPerSecond = spokesPerRevolution;    // 60 RPM
+    const int spokesPerFrame = requiredSpokesPerSecond / 30 + 1;
+    std::cout << "scan: " << revolutions << " revolutions of " << spokesPerRevolution << " x " << binCount
+              << " bins, kernel " << ScanConverter::blendKernelName() << std::endl;
+
+    // Noise everywhere, and a few bright patches
+    QVector<SpokeMessage> spokes(spokesPerRevolution);
+    quint32 seed = 12345;
+    for (int azimuth = 0; azimuth < spokesPerRevolution; ++azimuth) {
+        SpokeMessage &spoke = spokes[azimuth];
+        spoke.azimuth = quint16(azimuth);
+        spoke.spokesPerRevolution = quint16(spokesPerRevolution);
+        spoke.rangeNM = 24.0;
+        spoke.bins = QByteArray(binCount, '\0');
+        for (int bin = 0; bin < binCount; ++bin) {
+            seed = seed * 1664525u + 1013904223u;
+            int level = (seed >> 24) & 0x3F;
+            if ((azimuth / 64) % 7 == 3 && (bin / 40) % 9 == 4) {
+                level += 180;
+            }
+            spoke.bins[bin] = char(level);
+        }
+    }
+
+    // Kernel check on the first two spokes
+    QVector<quint8> dispatched(binCount), scalar(binCount);
+    std::memcpy(dispatched.data(), spokes[0].bins.constData(), binCount);
+    std::memcpy(scalar.data(), spokes[0].bins.constData(), binCount);
+    const quint8 *other = reinterpret_cast<const quint8 *>(spokes[1].bins.constData());
+    ScanConverter::blendBytes(dispatched.data(), other, binCount);
+    ScanConverter::blendBytesScalar(scalar.data(), other, binCount);
+    bool identical = std::memcmp(dispatched.constData(), scalar.constData(), binCount) == 0;
+
+    ScanConverter converter;
+    QElapsedTimer timer;
+    timer.start();
+    converter.setGeometry(QPointF(500.0, 500.0), 500.0, 24.0, 1.0);
+    converter.addSpoke(spokes[0]);
+    converter.update();
+    double tableMs = timer.nsecsElapsed() / 1e6;
+
+    timer.start();
+    int pending = 0;
+    for (int revolution = 0; revolution < revolutions; ++revolution) {
+        for (const SpokeMessage &spoke : spokes) {
+            converter.addSpoke(spoke);
+            if (++pending == spokesPerFrame) {
+                converter.update();
+                pending = 0;
+            }
+        }
+    }
+    converter.update();
+    qint64 total = qint64(revolutions) * spokesPerRevolution;
+    double spokeNs = nanosecondsPer(timer, total);
+    double spokesPerSecond = 1e9 / spokeNs;
+    g_sink = converter.image().pixel(500, 300);
+
+    std::cout << "  lookup table: " << tableMs << " ms" << std::endl;
+    std::cout << "  per spoke (average + raster): " << spokeNs << " ns, " << spokesPerSecond
+              << " spokes/s, " << 100.0 * requiredSpokesPerSecond / spokesPerSecond
+              << "% of one core at 60 RPM" << std::endl;
+    std::cout << "kernel vs scalar: " << (identical ? "bit-identical" : "MISMATCH") << std::endl;
+    return identical && spokesPerSecond >= requiredSpokesPerSecond ? 0 : 1;
+}
+
+// Plot extraction over a revolution of synthetic video with known targets:
+// CFAR alone, then CFAR plus clustering, for both detector modes
+// Noise plots the detector's false alarm probability predicts for one
+// revolution of the synthesizer. Noise is independent from spoke to spoke,
+// so a noise plot is a hit followed by an overlapping hit, generously any
+// of the three nearest bins, on each spoke up to minimumSpokes.
+double expectedFalsePlots(const SpokeSynthesizer &synthesizer, const CfarDetector &detector, int minimumSpokes)
+{
+    int count = synthesizer.settings().binCount;
+    QVector<CfarDetector::LevelDistribution> levels(count);
+    for (int bin = 0; bin < count; ++bin) {
+        synthesizer.noiseDistribution(bin, levels[bin]);
+    }
+
+    // Training cells past either end are mirrored, as the detector pads them
+    const CfarDetector::Settings &settings = detector.settings();
+    auto mirrored = [count](int bin) {
+        if (bin < 0) bin = -bin;
+        if (bin >= count) bin = 2 * (count - 1) - bin;
+        return qBound(0, bin, count - 1);
+    };
+    QVector<double> hit(count);
+    QVector<CfarDetector::LevelDistribution> training;
+    for (int bin = 0; bin < count; ++bin) {
+        training.clear();
+        for (int offset = settings.guardCells + 1; offset <= settings.guardCells + settings.trainingCells; ++offset) {
+            training.append(levels[mirrored(bin - offset)]);
+            training.append(levels[mirrored(bin + offset)]);
+        }
+        hit[bin] = detector.falseAlarmProbability(levels[bin], training);
+    }
+
+    double perSpoke = 0.0;
+    for (int bin = 0; bin < count; ++bin) {
+        double overlap = hit[bin] + (bin > 0 ? hit[bin - 1] : 0.0) + (bin + 1 < count ? hit[bin + 1] : 0.0);
+        perSpoke += hit[bin] * std::pow(overlap, minimumSpokes - 1);
+    }
+    return perSpoke * synthesizer.settings().spokesPerRevolution;
+}
+
+int benchCfar(int revolutions)
+{
+    const int spokesPerRevolution = 4096;
+    const int binCount = 1024;
+    const int requiredSpokesPerSecond = spokesPerRevolution;    // 60 RPM
+    std::cout << "cfar: " << revolutions << " revolutions of " << spokesPerRevolution << " x " << binCount
+              << " bins, kernel " << CfarDetector::kernelName() << std::endl;
+
+    // Stationary targets on a spiral, the nearest inside the sea clutter
+    SpokeSynthesizer synthesizer;
+    SpokeSynthesizer::Settings synthesis;
+    synthesis.spokesPerRevolution = spokesPerRevolution;
+    synthesis.binCount = binCount;
+    synthesizer.setSettings(synthesis);
+    QVector<SpokeSynthesizer::Target> targets;
+    for (int i = 0; i < 16; ++i) {
+        SpokeSynthesizer::Target target;
+        target.bearing = 10.0 + i * 22.5;
+        target.range = 2.0 + i * 1.3;
+        target.amplitude = 120 + (i % 4) * 40;
+        targets.append(target);
+    }
+    synthesizer.setTargets(targets);
+
+    QVector<SpokeMessage> spokes(spokesPerRevolution);
+    for (SpokeMessage &spoke : spokes) {
+        spoke = synthesizer.nextSpoke(0);
+    }
+
+    bool identical = true;
+    bool allFound = true;
+    bool fewFalse = true;
+    bool fastEnough = true;
+    QVector<quint8> dispatched(binCount), scalar(binCount);
+    const CfarDetector::Mode modes[] = {CfarDetector::CellAveraging, CfarDetector::OrderedStatistic};
+    for (CfarDetector::Mode mode : modes) {
+        CfarDetector::Settings settings;
+        settings.mode = mode;
+
+        // Kernel check on every spoke
+        CfarDetector detector;
+        detector.setSettings(settings);
+        for (const SpokeMessage &spoke : spokes) {
+            const quint8 *bins = reinterpret_cast<const quint8 *>(spoke.bins.constData());
+            detector.detect(bins, binCount, dispatched.data());
+            detector.detectScalar(bins, binCount, scalar.data());
+            identical = identical && std::memcmp(dispatched.constData(), scalar.constData(), binCount) == 0;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int revolution = 0; revolution < revolutions; ++revolution) {
+            for (const SpokeMessage &spoke : spokes) {
+                detector.detect(reinterpret_cast<const quint8 *>(spoke.bins.constData()), binCount, dispatched.data());
+            }
+        }
+        qint64 total = qint64(revolutions) * spokesPerRevolution;
+        double detectNs = nanosecondsPer(timer, total);
+        g_sink = dispatched[binCount / 2];
+
+        PlotExtractor extractor;
+        extractor.setDetectorSettings(settings);
+        QVector<RadarPlot> plots;
+        timer.start();
+        for (int revolution = 0; revolution < revolutions; ++revolution) {
+            plots.clear();
+            for (const SpokeMessage &spoke : spokes) {
+                extractor.addSpoke(spoke, plots);
+            }
+        }
+        double extractNs = nanosecondsPer(timer, total);
+        double spokesPerSecond = 1e9 / extractNs;
+        extractor.flush(plots);
+
+        // Each target against the nearest plot
+        int found = 0;
+        double errorSum = 0.0;
+        for (const SpokeSynthesizer::Target &target : targets) {
+            RadarMath::UnitVector truth = RadarMath::fastBearingVector(target.bearing);
+            double nearest = 1e9;
+            for (const RadarPlot &plot : plots) {
+                RadarMath::UnitVector u = RadarMath::fastBearingVector(plot.bearing);
+                double east = plot.range * u.east - target.range * truth.east;
+                double north = plot.range * u.north - target.range * truth.north;
+                nearest = qMin(nearest, std::sqrt(east * east + north * north));
+            }
+            if (nearest < 0.1) {
+                ++found;
+                errorSum += nearest;
+            }
+        }
+
+        // Plots clear of every target's echo are noise. A plot on an echo
+        // but off its peak is a split target, not a false alarm.
+        double binNM = synthesis.rangeNM / binCount;
+        int falsePlots = 0;
+        for (const RadarPlot &plot : plots) {
+            bool onEcho = false;
+            for (const SpokeSynthesizer::Target &target : targets) {
+                double offBearing = std::fabs(std::remainder(plot.bearing - target.bearing, 360.0));
+                double offRange = std::fabs(plot.range - target.range);
+                onEcho = onEcho || (offBearing <= 3.0 * synthesis.beamwidth && offRange <= 3.0 * target.size + binNM);
+            }
+            falsePlots += onEcho ? 0 : 1;
+        }
+        // Poisson, so three deviations, and one more for a count this small
+        double expected = expectedFalsePlots(synthesizer, detector, extractor.minimumSpokes());
+        double allowed = expected + 3.0 * std::sqrt(expected) + 1.0;
+
+        std::cout << "  " << (mode == CfarDetector::CellAveraging ? "CA" : "OS") << "-CFAR: detect " << detectNs
+                  << " ns, detect + cluster " << extractNs << " ns per spoke, " << spokesPerSecond << " spokes/s, "
+                  << 100.0 * requiredSpokesPerSecond / spokesPerSecond << "% of one core at 60 RPM" << std::endl;
+        std::cout << "    targets found " << found << "/" << targets.size() << ", false plots " << falsePlots
+                  << " (Pfa predicts " << expected << ", limit " << allowed << "), mean position error "
+                  << (found > 0 ? errorSum / found : 0.0) << " NM" << std::endl;
+        allFound = allFound && found == targets.size();
+        fewFalse = fewFalse && falsePlots <= allowed;
+        fastEnough = fastEnough && spokesPerSecond >= requiredSpokesPerSecond;
+    }
+
+    std::cout << "kernel vs scalar: " << (identical ? "bit-identical" : "MISMATCH") << std::endl;
+    return identical && allFound && fewFalse && fastEnough ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc < 2) {
+        std::cout << "Usage: bench_radar trig|geodesy|scan|cfar [iterations|points|revolutions]" << std::endl;
+        return 1;
+    }
+
+    QString mode = argv[1];
+    int iterations = argc > 2 ? QString(argv[2]).toInt() : 0;
+
+    if (mode == "trig") {
+        return benchTrig(iterations > 0 ? iterations : 200000);
+    }
+    if (mode == "geodesy") {
+        return benchGeodesy(iterations > 0 ? iterations : 100000);
+    }
+    if (mode == "scan") {
+        return benchScan(iterations > 0 ? iterations : 10);
+    }
+    if (mode == "cfar") {
+        return benchCfar(iterations > 0 ? iterations : 10);
+    }
+
+    std::cout << "Unknown mode: " << mode.toStdString() << std::endl;
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+QT += core gui
+
+CONFIG += c++17 console release
+CONFIG -= app_bundle
+
+TARGET = bench_radar
+TEMPLATE = app
+
+INCLUDEPATH += TelemetryReceiver
+
+SOURCES += \
+    bench_radar.cpp \
+    TelemetryReceiver/geodesy.cpp \
+    TelemetryReceiver/scanconverter.cpp \
+    TelemetryReceiver/cfardetector.cpp \
+    TelemetryReceiver/plotextractor.cpp \
+    TelemetryReceiver/spokesynth.cpp
+
+HEADERS += \
+    TelemetryReceiver/radarmath.h \
+    TelemetryReceiver/geodesy.h \
+    TelemetryReceiver/cpufeatures.h \
+    TelemetryReceiver/scanconverter.h \
+    TelemetryReceiver/cfardetector.h \
+    TelemetryReceiver/plotextractor.h \
+    TelemetryReceiver/radarplot.h \
+    TelemetryReceiver/spokesynth.h \
+    TelemetryReceiver/telemetrypacket.h
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include <QApplication>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "radarwidget.h"
+
+// Renders RadarWidget into offscreen images for a sweep of contact counts,
+// widget sizes and device pixel ratios, and prints one JSON object per
+// configuration. Runs on the offscreen platform, so no display is needed.
+// Each ratio runs in its own process, since Qt fixes the scale factor
+// when the application starts.
+
+namespace {
+
+// Every malloc, calloc and realloc in the process, Qt's included
+std::atomic<quint64> g_allocations{0};
+
+} // namespace
+
+#if defined(__GLIBC__)
+#define BENCH_COUNTS_ALLOCATIONS 1
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+}
+#endif
+
+namespace {
+
+const int CONTACT_COUNTS[] = {1, 100, 1000, 10000, 100000};
+const QSize WIDGET_SIZES[] = {QSize(600, 600), QSize(1024, 768), QSize(1920, 1080)};
+const double PIXEL_RATIOS[] = {1.0, 2.0};
+
+// Spread over the telemetry area around the default radar origin, most
+// inside the default 500 NM range
+void addContacts(RadarWidget &widget, int count)
+{
+    quint32 seed = 12345;
+    auto uniform = [&seed](double low, double high) {
+        seed = seed * 1664525u + 1013904223u;
+        return low + (seed >> 8) * ((high - low) / 16777216.0);
+    };
+    for (int i = 0; i < count; ++i) {
+        TelemetryData data(uniform(36.0, 42.0), uniform(26.0, 45.0), 12.0,
+                           i % 16 == 0 ? "INTERPOLATED" : "OK", QString("T%1").arg(i));
+        widget.addTelemetryContact(data);
+    }
+}
+
+QJsonObject benchConfiguration(int contacts, const QSize &size, int maxFrames)
+{
+    RadarWidget widget;
+    widget.setAttribute(Qt::WA_DontShowOnScreen);
+    widget.resize(size);
+    widget.show(); // Delivers the resize that lays out the radar
+    QCoreApplication::processEvents();
+    addContacts(widget, contacts);
+    QCoreApplication::processEvents(); // Flush the updates the contacts queued
+
+    qreal dpr = widget.devicePixelRatioF();
+    QImage image(size * dpr, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+
+    // Warm up the caches, then measure steady-state full frames at full quality
+    widget.setAdaptiveQuality(false);
+    widget.setFrameMetricsEnabled(true);
+    for (int i = 0; i < 3; ++i) {
+        widget.render(&image);
+    }
+    widget.resetFrameMetrics();
+
+    QVector<double> frameMs;
+    QElapsedTimer total;
+    QElapsedTimer timer;
+    quint64 allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+    total.start();
+    while (frameMs.size() < maxFrames && (frameMs.size() < 5 || total.elapsed() < 1000)) {
+        timer.start();
+        widget.render(&image);
+        frameMs.append(timer.nsecsElapsed() / 1e6);
+    }
+    quint64 allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+    QVector<double> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double ms : frameMs) {
+        sum += ms;
+    }
+    auto percentile = [&sorted](double fraction) {
+        int rank = qBound(0, int(std::ceil(fraction * sorted.size())) - 1, int(sorted.size()) - 1);
+        return sorted[rank];
+    };
+
+    FrameStats stats = widget.frameStats();
+    QJsonObject stages;
+    for (int stage = 0; stage < FrameStats::StageCount; ++stage) {
+        stages.insert(FrameStats::stageName(stage), stats.stageMeanMs[stage]);
+    }
+
+    QJsonObject result;
+    result.insert("bench", "render");
+    result.insert("contacts", contacts);
+    result.insert("width", size.width());
+    result.insert("height", size.height());
+    result.insert("dpr", dpr);
+    result.insert("frames", frameMs.size());
+    result.insert("meanMs", sum / frameMs.size());
+    result.insert("p50Ms", percentile(0.5));
+    result.insert("p99Ms", percentile(0.99));
+    result.insert("maxMs", sorted.last());
+#if defined(BENCH_COUNTS_ALLOCATIONS)
+    result.insert("allocationsPerFrame", double(allocations) / frameMs.size());
+#else
+    Q_UNUSED(allocations);
+    result.insert("allocationsPerFrame", QJsonValue());
+#endif
+    result.insert("stagesMs", stages);
+    return result;
+}
+
+// One device pixel ratio, in this process
+int runAtRatio(int argc, char *argv[], double dpr, int maxFrames)
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    qputenv("QT_SCALE_FACTOR", QByteArray::number(dpr));
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
+#endif
+    QApplication app(argc, argv);
+
+    for (const QSize &size : WIDGET_SIZES) {
+        for (int contacts : CONTACT_COUNTS) {
+            QJsonObject result = benchConfiguration(contacts, size, maxFrames);
+            std::cout << QJsonDocument(result).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+            std::cerr << "  " << contacts << " contacts, " << size.width() << "x" << size.height()
+                      << " @" << dpr << ": p50 " << result.value("p50Ms").toDouble() << " ms" << std::endl;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    double dpr = 0.0;
+    int maxFrames = 200;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        QString option = argv[i];
+        if (option == "--dpr") {
+            dpr = QString(argv[i + 1]).toDouble();
+        } else if (option == "--frames") {
+            maxFrames = qMax(1, QString(argv[i + 1]).toInt());
+        } else {
+            std::cerr << "Usage: bench_render [--frames N] [--dpr RATIO]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (dpr > 0.0) {
+        return runAtRatio(argc, argv, dpr, maxFrames);
+    }
+
+    // Sweep the ratios, one child process each; results go straight to our stdout
+    QCoreApplication app(argc, argv);
+    int status = 0;
+    for (double ratio : PIXEL_RATIOS) {
+        QProcess child;
+        child.setProcessChannelMode(QProcess::ForwardedChannels);
+        child.start(QCoreApplication::applicationFilePath(),
+                    {"--frames", QString::number(maxFrames), "--dpr", QString::number(ratio)});
+        if (!child.waitForFinished(-1) || child.exitStatus() != QProcess::NormalExit || child.exitCode() != 0) {
+            std::cerr << "Run at ratio " << ratio << " failed" << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+QT += core gui widgets network
+
+CONFIG += c++17 console release
+CONFIG -= app_bundle
+
+TARGET = bench_render
+TEMPLATE = app
+
+INCLUDEPATH += TelemetryReceiver
+
+SOURCES += \
+    bench_render.cpp \
+    TelemetryReceiver/radarwidget.cpp \
+    TelemetryReceiver/trackstore.cpp \
+    TelemetryReceiver/spatialgrid.cpp \
+    TelemetryReceiver/phosphorlayer.cpp \
+    TelemetryReceiver/scanconverter.cpp \
+    TelemetryReceiver/geodesy.cpp \
+    TelemetryReceiver/radarrenderer.cpp \
+    TelemetryReceiver/framemetrics.cpp \
+    TelemetryReceiver/labelplacer.cpp \
+    TelemetryReceiver/qualitygovernor.cpp \
+    TelemetryReceiver/radarrenderworker.cpp \
+    TelemetryReceiver/asynclogger.cpp
+
+HEADERS += \
+    TelemetryReceiver/radarwidget.h \
+    TelemetryReceiver/trackstore.h \
+    TelemetryReceiver/spatialgrid.h \
+    TelemetryReceiver/phosphorlayer.h \
+    TelemetryReceiver/scanconverter.h \
+    TelemetryReceiver/radarplot.h \
+    TelemetryReceiver/cpufeatures.h \
+    TelemetryReceiver/radarmath.h \
+    TelemetryReceiver/geodesy.h \
+    TelemetryReceiver/radarscene.h \
+    TelemetryReceiver/framemetrics.h \
+    TelemetryReceiver/labelplacer.h \
+    TelemetryReceiver/qualitygovernor.h \
+    TelemetryReceiver/radarrenderer.h \
+    TelemetryReceiver/radarrenderworker.h \
+    TelemetryReceiver/asynclogger.h \
+    TelemetryReceiver/mpscqueue.h \
+    TelemetryReceiver/telemetrypacket.h \
+    TelemetryReceiver/telemetrydata.h
\ No newline at end of file
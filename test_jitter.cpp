@@ -0,0 +1,172 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QVector>
+#include <iostream>
+#include "jitterbuffer.h"
+
+// Checks for the per-track playout buffer: release order under reordering,
+// late and duplicate samples, fixed and adaptive playout delay, and the
+// depth limit. Time is simulated, so every expectation is exact.
+
+namespace {
+
+constexpr qint64 BASE_MS = 1700000000000;   // Sender clock at sequence 0
+
+bool check(bool condition, const char *what)
+{
+    std::cout << (condition ? "  ok: " : "  FAILED: ") << what << std::endl;
+    return condition;
+}
+
+// One sample per 100 ms of sender time
+TelemetryPacket sample(quint32 sequence)
+{
+    TelemetryPacket packet;
+    packet.sequenceNumber = sequence;
+    packet.timestamp = QDateTime::fromMSecsSinceEpoch(BASE_MS + qint64(sequence) * 100);
+    return packet;
+}
+
+qint64 sendMs(quint32 sequence)
+{
+    return BASE_MS + qint64(sequence) * 100;
+}
+
+QVector<quint32> sequencesOf(const QVector<TelemetryPacket> &packets)
+{
+    QVector<quint32> sequences;
+    for (const TelemetryPacket &packet : packets) {
+        sequences.append(packet.sequenceNumber);
+    }
+    return sequences;
+}
+
+// Samples arriving out of order come out in sequence order; one that shows
+// up after the playout point has passed it is counted late and dropped
+bool testReorder()
+{
+    std::cout << "reorder" << std::endl;
+
+    JitterBuffer buffer;
+    buffer.setAdaptive(false);
+    buffer.setPlayoutDelayMs(200);
+
+    buffer.push(sample(1), sendMs(1) + 10);
+    buffer.push(sample(3), sendMs(3) + 10);
+    buffer.push(sample(2), sendMs(2) + 10);
+    buffer.push(sample(3), sendMs(3) + 40);     // Retransmitted duplicate
+
+    QVector<TelemetryPacket> out;
+    buffer.popDue(sendMs(3) + 210, out);
+    bool ok = check(sequencesOf(out) == QVector<quint32>({1, 2, 3}), "released in sequence order");
+    ok = check(buffer.size() == 0, "duplicate held only once") && ok;
+
+    buffer.push(sample(2), sendMs(2) + 500);
+    buffer.push(sample(4), sendMs(4) + 10);
+    ok = check(buffer.latePackets() == 1, "sample behind the playout point counted late") && ok;
+    ok = check(buffer.size() == 1, "late sample not buffered") && ok;
+    return ok;
+}
+
+// Non-adaptive: a sample plays out the fixed delay after its send time,
+// shifted by the smallest transit time seen
+bool testFixedDelay()
+{
+    std::cout << "fixed delay" << std::endl;
+
+    JitterBuffer buffer;
+    buffer.setAdaptive(false);
+    buffer.setPlayoutDelayMs(200);
+
+    QVector<TelemetryPacket> out;
+    bool ok = check(buffer.nextDueMs() == -1, "nothing due while empty");
+
+    buffer.push(sample(1), sendMs(1) + 50);
+    ok = check(buffer.nextDueMs() == sendMs(1) + 250, "due at send time + transit + delay") && ok;
+    ok = check(buffer.popDue(sendMs(1) + 249, out) == 0, "held until due") && ok;
+    ok = check(buffer.popDue(sendMs(1) + 250, out) == 1, "released once due") && ok;
+
+    // A slower path does not move the baseline, a faster one does
+    buffer.push(sample(2), sendMs(2) + 120);
+    ok = check(buffer.nextDueMs() == sendMs(2) + 250, "queuing delay absorbed by the playout delay") && ok;
+    buffer.push(sample(3), sendMs(3) + 20);
+    ok = check(buffer.nextDueMs() == sendMs(2) + 250, "earlier sequence still due first") && ok;
+    buffer.flush(out);
+    ok = check(sequencesOf(out) == QVector<quint32>({1, 2, 3}), "flush releases the rest in order") && ok;
+    ok = check(buffer.targetDelayMs() == 200, "fixed delay ignores jitter") && ok;
+    return ok;
+}
+
+// Adaptive: transit alternating by 40 ms drives the RFC 3550 estimate
+// towards 40 ms and the target towards four deviations, within the bounds
+bool testAdaptiveDelay()
+{
+    std::cout << "adaptive delay" << std::endl;
+
+    JitterBuffer buffer;
+    buffer.setAdaptive(true);
+    buffer.setPlayoutDelayMs(50);
+    buffer.setMaxPlayoutDelayMs(2000);
+
+    QVector<TelemetryPacket> out;
+    bool ok = check(buffer.targetDelayMs() == 50, "floor before any jitter is seen");
+    for (quint32 sequence = 1; sequence <= 200; ++sequence) {
+        qint64 transitMs = sequence % 2 == 0 ? 10 : 50;
+        buffer.push(sample(sequence), sendMs(sequence) + transitMs);
+        buffer.popDue(sendMs(sequence) + transitMs, out);
+    }
+
+    std::cout << "  jitter " << buffer.jitterMs() << " ms, target " << buffer.targetDelayMs() << " ms" << std::endl;
+    ok = check(buffer.jitterMs() > 39.0 && buffer.jitterMs() <= 40.0, "jitter converges on the transit deviation") && ok;
+    ok = check(buffer.targetDelayMs() == 160, "target is four deviations") && ok;
+
+    buffer.setMaxPlayoutDelayMs(100);
+    ok = check(buffer.targetDelayMs() == 100, "target capped at the maximum") && ok;
+    buffer.setPlayoutDelayMs(300);
+    ok = check(buffer.targetDelayMs() == 300, "floor raises the target and the cap") && ok;
+    buffer.setAdaptive(false);
+    ok = check(buffer.targetDelayMs() == 300, "fixed mode uses the floor") && ok;
+
+    buffer.clear();
+    buffer.setAdaptive(true);
+    ok = check(buffer.jitterMs() == 0.0 && buffer.size() == 0, "clear resets the estimate") && ok;
+    return ok;
+}
+
+// Past the depth limit the oldest samples are released early, in order,
+// so a stalled clock cannot hold a track back indefinitely
+bool testMaxDepth()
+{
+    std::cout << "max depth" << std::endl;
+
+    JitterBuffer buffer;
+    buffer.setAdaptive(false);
+    buffer.setPlayoutDelayMs(10000);
+    buffer.setMaxDepth(4);
+
+    for (quint32 sequence = 1; sequence <= 6; ++sequence) {
+        buffer.push(sample(sequence), sendMs(sequence));
+    }
+
+    QVector<TelemetryPacket> out;
+    bool ok = check(buffer.popDue(sendMs(6), out) == 2, "overflow released before it is due");
+    ok = check(sequencesOf(out) == QVector<quint32>({1, 2}), "oldest released first") && ok;
+    ok = check(buffer.size() == 4, "depth back at the limit") && ok;
+    ok = check(buffer.lastArrivalMs() == sendMs(6), "last arrival tracked") && ok;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    bool ok = testReorder();
+    ok = testFixedDelay() && ok;
+    ok = testAdaptiveDelay() && ok;
+    ok = testMaxDepth() && ok;
+
+    std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = test_jitter
+TEMPLATE = app
+
+INCLUDEPATH += TelemetryReceiver
+
+SOURCES += \
+    test_jitter.cpp \
+    TelemetryReceiver/jitterbuffer.cpp
+
+HEADERS += \
+    TelemetryReceiver/jitterbuffer.h \
+    TelemetryReceiver/telemetrypacket.h
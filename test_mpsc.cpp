@@ -0,0 +1,354 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QThread>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "asynclogger.h"
+#include "mpscqueue.h"
+#include "reliableudp.h"
+
+// Stress tests for the lock-free command mailbox, meant to run under
+// ThreadSanitizer (see test_mpsc.pro). Every item pushed must come out
+// exactly once; a lost wake-up shows up as a drain that stalls short.
+// A deadlock on the receiver's command path shows up as a cycle that
+// never completes.
+
+namespace {
+
+constexpr int PRODUCERS = 4;
+
+bool check(bool condition, const char *what)
+{
+    std::cout << (condition ? "  ok: " : "  FAILED: ") << what << std::endl;
+    return condition;
+}
+
+// Raw queue: producers retry while it is full, the consumer checks that
+// each producer's items arrive once and in order
+bool testQueue(int itemsPerProducer)
+{
+    std::cout << "queue: " << PRODUCERS << " producers x " << itemsPerProducer << " items" << std::endl;
+
+    MpscQueue<quint64> queue(1024);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p, itemsPerProducer]() {
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                quint64 item = (quint64(p) << 32) | quint64(i);
+                while (!queue.push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    QVector<int> next(PRODUCERS, 0);
+    qint64 received = 0;
+    qint64 expected = qint64(PRODUCERS) * itemsPerProducer;
+    bool ordered = true;
+    QElapsedTimer clock;
+    clock.start();
+    while (received < expected && clock.elapsed() < 30000) {
+        quint64 item;
+        if (!queue.pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = int(item >> 32);
+        int index = int(item & 0xffffffffu);
+        if (producer >= PRODUCERS || index != next[producer]) {
+            ordered = false;
+        } else {
+            ++next[producer];
+        }
+        ++received;
+    }
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    quint64 extra;
+    bool ok = check(received == expected, "every item received");
+    ok = check(ordered, "each producer's items once and in order") && ok;
+    ok = check(queue.isEmpty() && !queue.pop(extra), "nothing left over") && ok;
+    return ok;
+}
+
+// The sender's mailbox through its public API: producer threads queue
+// telemetry in short bursts while the owning thread drains. Once they stop
+// nothing posts again, so every command must be drained by the wake-ups
+// already scheduled.
+bool testSender(int packetsPerProducer)
+{
+    std::cout << "sender: " << PRODUCERS << " producers x " << packetsPerProducer << " packets" << std::endl;
+
+    QUdpSocket sink;
+    if (!sink.bind(QHostAddress::LocalHost, 0)) {
+        std::cout << "  FAILED: bind: " << sink.errorString().toStdString() << std::endl;
+        return false;
+    }
+    QObject::connect(&sink, &QUdpSocket::readyRead, [&sink]() {
+        while (sink.hasPendingDatagrams()) {
+            sink.receiveDatagram();
+        }
+    });
+
+    ReliableUdpSender sender;
+    sender.setReliabilityEnabled(false);    // No retransmissions to double count
+    sender.setTarget(QHostAddress::LocalHost, sink.localPort());
+
+    std::vector<std::vector<quint32>> sequences(PRODUCERS);
+    std::atomic<int> finished(0);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&sender, &sequences, &finished, p, packetsPerProducer]() {
+            TelemetryPacket packet;
+            packet.trackId = QString("STRESS%1").arg(p);
+            for (int i = 0; i < packetsPerProducer; ++i) {
+                sequences[p].push_back(sender.sendTelemetryData(packet));
+                if (i % 16 == 15) {
+                    std::this_thread::yield();
+                }
+            }
+            finished.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    quint64 expected = quint64(PRODUCERS) * packetsPerProducer;
+    const NetworkStatistics *statistics = sender.statistics();
+    auto accounted = [&]() {
+        return statistics->value(NetworkStatistics::PacketsSent) + sender.droppedCommands();
+    };
+
+    // Polling posts nothing to the sender, so it cannot mask a lost wake-up
+    QEventLoop loop;
+    QTimer poll;
+    QElapsedTimer clock;
+    clock.start();
+    QObject::connect(&poll, &QTimer::timeout, [&]() {
+        bool drained = finished.load(std::memory_order_acquire) == PRODUCERS && accounted() >= expected;
+        if (drained || clock.elapsed() > 30000) {
+            loop.quit();
+        }
+    });
+    poll.start(10);
+    loop.exec();
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+
+    // Give a duplicate transmission time to show up
+    QElapsedTimer settle;
+    settle.start();
+    while (settle.elapsed() < 200) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+
+    std::vector<quint32> all;
+    for (const std::vector<quint32> &producer : sequences) {
+        all.insert(all.end(), producer.begin(), producer.end());
+    }
+    std::sort(all.begin(), all.end());
+    bool unique = true;
+    for (size_t i = 0; i < all.size(); ++i) {
+        unique = unique && all[i] == quint32(i + 1);
+    }
+
+    quint64 sent = statistics->value(NetworkStatistics::PacketsSent);
+    std::cout << "  " << sent << " sent, " << sender.droppedCommands() << " dropped as queue full" << std::endl;
+    bool ok = check(unique, "sequence numbers assigned once each");
+    ok = check(sent + sender.droppedCommands() == expected, "every queued packet transmitted exactly once") && ok;
+    return ok;
+}
+
+// The receiver's command path the way the receiver window drives it:
+// another thread starts and stops listening through blocking invokes
+// while packets that ask for an acknowledgement keep arriving and
+// settings are posted to the mailbox. Acknowledging used to take the
+// socket lock the datagram loop already held.
+bool testReceiver(int cycles)
+{
+    std::cout << "receiver: " << cycles << " start/stop cycles under traffic" << std::endl;
+
+    // Reserve a port up front so the traffic thread knows where to send
+    quint16 port = 0;
+    {
+        QUdpSocket probe;
+        if (!probe.bind(QHostAddress::LocalHost, 0)) {
+            std::cout << "  FAILED: bind: " << probe.errorString().toStdString() << std::endl;
+            return false;
+        }
+        port = probe.localPort();
+    }
+
+    QThread networkThread;
+    networkThread.setObjectName("ReliableUdpReceiver");
+    ReliableUdpReceiver *receiver = new ReliableUdpReceiver;
+    receiver->moveToThread(&networkThread);
+    QObject::connect(&networkThread, &QThread::finished, receiver, &QObject::deleteLater);
+    std::atomic<int> statusChanges(0);
+    QObject::connect(receiver, &ReliableUdpReceiver::connectionStatusChanged, receiver,
+                     [&statusChanges](bool) { statusChanges.fetch_add(1, std::memory_order_relaxed); },
+                     Qt::DirectConnection);
+    networkThread.start();
+
+    std::atomic<bool> stop(false);
+    std::thread traffic([&stop, port]() {
+        QUdpSocket socket;
+        TelemetryPacket packet;
+        packet.trackId = "STRESS";
+        packet.needsAck = true;
+        while (!stop.load(std::memory_order_acquire)) {
+            ++packet.sequenceNumber;
+            packet.timestamp = QDateTime::currentDateTimeUtc();
+            QByteArray data = QJsonDocument(packet.toJson()).toJson(QJsonDocument::Compact);
+            socket.writeDatagram(data, QHostAddress::LocalHost, port);
+            if (packet.sequenceNumber % 16 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread settings([&stop, receiver]() {
+        for (int i = 0; !stop.load(std::memory_order_acquire); ++i) {
+            receiver->setJitterBufferEnabled(i % 2 == 0);
+            receiver->setPlayoutDelayMs(50 + i % 100);
+            receiver->setPacketTimeoutMs(1000 + i % 1000);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    std::atomic<int> completed(0);
+    std::atomic<int> started(0);
+    std::thread controller([&completed, &started, receiver, port, cycles]() {
+        for (int i = 0; i < cycles; ++i) {
+            bool listening = false;
+            QMetaObject::invokeMethod(receiver, [receiver, port]() { return receiver->startListening(port); },
+                                      Qt::BlockingQueuedConnection, &listening);
+            if (listening) {
+                started.fetch_add(1, std::memory_order_relaxed);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            QMetaObject::invokeMethod(receiver, [receiver]() { receiver->stopListening(); },
+                                      Qt::BlockingQueuedConnection);
+            completed.fetch_add(1, std::memory_order_release);
+        }
+    });
+
+    QElapsedTimer clock;
+    clock.start();
+    while (completed.load(std::memory_order_acquire) < cycles && clock.elapsed() < 30000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (completed.load(std::memory_order_acquire) < cycles) {
+        // The controller is stuck in a blocking invoke; nothing can be joined
+        check(false, "every start/stop cycle completes");
+        std::cout << "FAIL" << std::endl;
+        std::_Exit(1);
+    }
+    controller.join();
+    stop.store(true, std::memory_order_release);
+    traffic.join();
+    settings.join();
+
+    quint64 received = receiver->statistics()->value(NetworkStatistics::PacketsReceived);
+    networkThread.quit();
+    networkThread.wait();
+
+    std::cout << "  " << received << " packets received across " << cycles << " cycles" << std::endl;
+    bool ok = check(true, "every start/stop cycle completes");
+    ok = check(started.load() == cycles, "every start binds the port") && ok;
+    ok = check(statusChanges.load() == 2 * cycles, "one status change per start and per stop") && ok;
+    ok = check(received > 0, "packets received while listening") && ok;
+    return ok;
+}
+
+// Short-lived logging threads: each one's ring must be freed once its
+// records are out, and none of those records may be lost on the way
+bool testLoggerRings(int threads)
+{
+    std::cout << "logger: " << threads << " short-lived threads" << std::endl;
+
+    AsyncLogger &logger = AsyncLogger::instance();
+    FILE *sink = std::tmpfile();
+    if (!sink) {
+        std::cout << "  FAILED: tmpfile" << std::endl;
+        return false;
+    }
+    logger.setOutput(sink);
+    LogLevel level = AsyncLogger::level();
+    AsyncLogger::setLevel(LogLevel::Info);
+    int before = logger.ringCount();
+    quint64 droppedBefore = logger.droppedRecords();
+
+    const int recordsPerThread = 50;
+    for (int batch = 0; batch < threads; batch += PRODUCERS) {
+        std::vector<std::thread> loggers;
+        for (int t = batch; t < qMin(threads, batch + PRODUCERS); ++t) {
+            loggers.emplace_back([t]() {
+                for (int i = 0; i < recordsPerThread; ++i) {
+                    TLOG_INFO("Stress", "thread {} record {}", t, i);
+                }
+            });
+        }
+        for (std::thread &thread : loggers) {
+            thread.join();
+        }
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    while (logger.ringCount() > before && clock.elapsed() < 5000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    int after = logger.ringCount();
+    AsyncLogger::setLevel(level);
+    logger.setOutput(stdout);
+
+    // Let the pass that may still hold the old output finish with it
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::rewind(sink);
+    qint64 lines = 0;
+    for (int c = std::fgetc(sink); c != EOF; c = std::fgetc(sink)) {
+        lines += c == '\n';
+    }
+    std::fclose(sink);
+
+    quint64 dropped = logger.droppedRecords() - droppedBefore;
+    std::cout << "  " << lines << " records written, " << dropped << " dropped, "
+              << after - before << " rings left" << std::endl;
+    bool ok = check(after <= before, "every exited thread's ring reclaimed");
+    ok = check(lines + qint64(dropped) >= qint64(threads) * recordsPerThread, "every record written or counted dropped") && ok;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int rounds = argc > 1 ? qMax(1, std::atoi(argv[1])) : 10;
+    bool ok = true;
+    for (int round = 0; round < rounds && ok; ++round) {
+        std::cout << "round " << round + 1 << " of " << rounds << std::endl;
+        ok = testQueue(100000) && ok;
+        ok = testSender(2000) && ok;
+        ok = testReceiver(50) && ok;
+        ok = testLoggerRings(64) && ok;
+    }
+
+    AsyncLogger::instance().shutdown();
+    std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+QT += core network
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = test_mpsc
+TEMPLATE = app
+
+INCLUDEPATH += TelemetryReceiver
+
+SOURCES += \
+    test_mpsc.cpp \
+    TelemetryReceiver/reliableudp.cpp \
+    TelemetryReceiver/networkstatistics.cpp \
+    TelemetryReceiver/asynclogger.cpp \
+    TelemetryReceiver/jitterbuffer.cpp
+
+HEADERS += \
+    TelemetryReceiver/reliableudp.h \
+    TelemetryReceiver/networkstatistics.h \
+    TelemetryReceiver/asynclogger.h \
+    TelemetryReceiver/mpscqueue.h \
+    TelemetryReceiver/telemetrypacket.h \
+    TelemetryReceiver/jitterbuffer.h
+
+# Races in the mailbox only show reliably under ThreadSanitizer
+!msvc {
+    QMAKE_CXXFLAGS += -fsanitize=thread -g
+    QMAKE_LFLAGS += -fsanitize=thread
+}